@@ -0,0 +1,147 @@
+/*
+ * File: BenchmarkBoggle.cpp
+ * -------------------------
+ * This file implements the Boggle solver benchmark program: it loads a dictionary once (a word
+ * list, or a compact dictionary file written by MakeDawg, from which the Lexicon of the baseline
+ * variant is rebuilt) and runs benchmarkSolvers on seeded corpora of 4x4 and 5x5 boards, without
+ * the console game or the GUI. A mode given after the dictionary runs another benchmark instead:
+ * "sizes" runs batch solving on boards of increasing sizes (benchmarkBoardSizes), "server" the load
+ * generator of BoggleSessionServer (benchmarkSessionServer), "optimize" the board optimizer
+ * (benchmarkOptimizer), with the cubes of the game for the sizes that have them.
+ * Usage: BenchmarkBoggle dictionary [boards per size] [seed] [threads]
+ *        BenchmarkBoggle dictionary sizes [boards per size] [seed] [threads]
+ *        BenchmarkBoggle dictionary server [submissions per second] [games] [clients] [workers]
+ *        BenchmarkBoggle dictionary optimize [board size] [chains] [iterations] [seed] [threads]
+ */
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "Boggle.h"
+#include "BoggleBenchmark.h"
+#include "CompactLexicon.h"
+#include "lexicon.h"
+#include "random.h"
+#include "strlib.h"
+using namespace std;
+
+/* Default values of the optional arguments */
+const int DEFAULT_BOARDS_PER_SIZE = 1000;
+const int DEFAULT_SEED = 106;
+const int DEFAULT_THREADS = 0;
+const double DEFAULT_SUBMISSION_RATE = 0;
+const int DEFAULT_GAMES = 1000;
+const int DEFAULT_CLIENTS = 4;
+const int DEFAULT_OPTIMIZER_SIZE = 4;
+const string COMPACT_DICT_EXTENSION = ".dawg";
+
+/* Players of every game of the server benchmark, and words every player submits */
+const int SERVER_PLAYERS_PER_GAME = 4;
+const int SERVER_SUBMISSIONS_PER_PLAYER = 50;
+
+/* Modes selected by the argument following the dictionary */
+const string SIZES_MODE = "sizes";
+const string SERVER_MODE = "server";
+const string OPTIMIZE_MODE = "optimize";
+
+/* Function prototypes */
+static void printUsage(const string& program);
+static void addWords(const CompactLexicon& trie, int node, string& word, Lexicon& dictionary);
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    string dictionaryFile = argv[1];
+    string mode = argc > 2 && !isdigit((unsigned char) argv[2][0]) ? argv[2] : "";
+    if (mode != "" && mode != SIZES_MODE && mode != SERVER_MODE && mode != OPTIMIZE_MODE) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    try {
+        // the Lexicon is only used by the baseline variant of benchmarkSolvers
+        Lexicon dictionary;
+        shared_ptr<const CompactLexicon> trie;
+        if (endsWith(dictionaryFile, COMPACT_DICT_EXTENSION)) {
+            trie = make_shared<CompactLexicon>(dictionaryFile);
+            if (mode == "") {
+                string word;
+                addWords(*trie, trie->root(), word, dictionary);
+            }
+        } else {
+            dictionary.addWordsFromFile(dictionaryFile);
+            trie = make_shared<CompactLexicon>(dictionary);
+        }
+        if (mode == SIZES_MODE) {
+            int boardsPerSize = argc > 3 ? atoi(argv[3]) : DEFAULT_BOARDS_PER_SIZE;
+            setRandomSeed(argc > 4 ? atoi(argv[4]) : DEFAULT_SEED);
+            int numThreads = argc > 5 ? atoi(argv[5]) : DEFAULT_THREADS;
+            benchmarkBoardSizes(*trie, boardsPerSize, numThreads);
+        } else if (mode == SERVER_MODE) {
+            double submissionsPerSecond = argc > 3 ? atof(argv[3]) : DEFAULT_SUBMISSION_RATE;
+            int numGames = argc > 4 ? atoi(argv[4]) : DEFAULT_GAMES;
+            int numClients = argc > 5 ? atoi(argv[5]) : DEFAULT_CLIENTS;
+            int numWorkers = argc > 6 ? atoi(argv[6]) : DEFAULT_THREADS;
+            benchmarkSessionServer(trie, numGames, SERVER_PLAYERS_PER_GAME, SERVER_SUBMISSIONS_PER_PLAYER, numClients,
+                                   numWorkers, submissionsPerSecond);
+        } else if (mode == OPTIMIZE_MODE) {
+            OptimizerSettings settings;
+            settings.rows = settings.cols = argc > 3 ? atoi(argv[3]) : DEFAULT_OPTIMIZER_SIZE;
+            settings.useCubes = !boggleCubes(settings.rows, settings.cols).empty();
+            if (argc > 4) {
+                settings.numChains = atoi(argv[4]);
+            }
+            if (argc > 5) {
+                settings.iterations = atoi(argv[5]);
+            }
+            settings.seed = argc > 6 ? atoi(argv[6]) : DEFAULT_SEED;
+            settings.numThreads = argc > 7 ? atoi(argv[7]) : DEFAULT_THREADS;
+            benchmarkOptimizer(*trie, settings);
+        } else {
+            int boardsPerSize = argc > 2 ? atoi(argv[2]) : DEFAULT_BOARDS_PER_SIZE;
+            int seed = argc > 3 ? atoi(argv[3]) : DEFAULT_SEED;
+            int numThreads = argc > 4 ? atoi(argv[4]) : DEFAULT_THREADS;
+            benchmarkSolvers(dictionary, *trie, boardsPerSize, seed, numThreads);
+        }
+    } catch (const string& problem) {
+        cout << problem << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/* Function: printUsage()
+ * Usage: printUsage(program)
+ * -----------------------------------------------------------------------------
+ * Prints the arguments of every mode of the program.
+ */
+static void printUsage(const string& program) {
+    cout << "Usage: " << program << " dictionary [boards per size] [seed] [threads]" << endl;
+    cout << "       " << program << " dictionary " << SIZES_MODE << " [boards per size] [seed] [threads]" << endl;
+    cout << "       " << program << " dictionary " << SERVER_MODE
+         << " [submissions per second] [games] [clients] [workers]" << endl;
+    cout << "       " << program << " dictionary " << OPTIMIZE_MODE
+         << " [board size] [chains] [iterations] [seed] [threads]" << endl;
+}
+
+/* Function: addWords()
+ * Usage: addWords(trie, node, word, dictionary)
+ * -----------------------------------------------------------------------------
+ * Adds to dictionary every word of trie starting with word, the letters leading to node.
+ */
+static void addWords(const CompactLexicon& trie, int node, string& word, Lexicon& dictionary) {
+    if (trie.isWord(node)) {
+        dictionary.add(word);
+    }
+    uint32_t letters = trie.childMask(node);
+    for (int letterIndex = 0; letterIndex < 26; letterIndex++) {
+        if (letters & (1u << letterIndex)) {
+            word += (char) ('A' + letterIndex);
+            addWords(trie, trie.child(node, 'A' + letterIndex), word, dictionary);
+            word.pop_back();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * File: BenchmarkNgrams.cpp
+ * -------------------------
+ * This file implements the N-gram benchmark program: it reads the words of a text file once and
+ * runs benchmarkNgramModel on them, without the console prompts of the Random Writer, then times
+ * building the model from the file with more and more threads (benchmarkParallelBuild), and saving
+ * the model to a model file and loading it back (benchmarkModelFile).
+ * Usage: BenchmarkNgrams textFile [N] [words generated] [seed] [threads] [model file]
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "NgramBenchmark.h"
+using namespace std;
+
+/* Default values of the optional arguments */
+const int DEFAULT_N = 3;
+const int DEFAULT_WORDS_GENERATED = 1000000;
+const int DEFAULT_SEED = 106;
+const int DEFAULT_THREADS = 0;
+const string DEFAULT_MODEL_FILE = "BenchmarkNgrams.model";
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " textFile [N] [words generated] [seed] [threads] [model file]" << endl;
+        return 1;
+    }
+    int n = argc > 2 ? atoi(argv[2]) : DEFAULT_N;
+    int numWords = argc > 3 ? atoi(argv[3]) : DEFAULT_WORDS_GENERATED;
+    int seed = argc > 4 ? atoi(argv[4]) : DEFAULT_SEED;
+    int numThreads = argc > 5 ? atoi(argv[5]) : DEFAULT_THREADS;
+    string modelFile = argc > 6 ? argv[6] : DEFAULT_MODEL_FILE;
+    ifstream input(argv[1]);
+    if (!input) {
+        cout << "Cannot open " << argv[1] << endl;
+        return 1;
+    }
+    vector<string> words;
+    string word;
+    while (input >> word) {
+        words.push_back(word);
+    }
+    try {
+        benchmarkNgramModel(words, n, numWords, seed);
+        benchmarkParallelBuild(argv[1], n, numThreads);
+        NgramModel model(argv[1], n, numThreads);
+        benchmarkModelFile(model, modelFile, numWords, seed);
+    } catch (const string& problem) {
+        cout << problem << endl;
+        return 1;
+    }
+    return 0;
+}
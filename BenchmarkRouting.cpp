@@ -0,0 +1,155 @@
+/*
+ * File: BenchmarkRouting.cpp
+ * --------------------------
+ * This file implements the routing benchmark program: it generates a seeded road network (a square
+ * grid of intersections joined to their horizontal and vertical neighbors by two-way roads of
+ * random costs) and runs one of the benchmarks of RoutingBenchmark.h on it, without the map GUI.
+ * The mode given first selects the benchmark: "planner" incremental re-planning
+ * (benchmarkIncrementalPlanner, from one corner of the grid to the opposite one), "snapshot" index
+ * snapshots (benchmarkSnapshot), "ordering" node orders (benchmarkNodeOrdering), "delta" parallel
+ * delta-stepping (benchmarkDeltaStepping), "timedependent" rush hour profiles
+ * (benchmarkTimeDependent) and "partition" graph partition queries (benchmarkPartition). Every
+ * benchmark starts its searches from the first corner of the grid.
+ * Usage: BenchmarkRouting planner [grid size] [seed] [perturbations]
+ *        BenchmarkRouting snapshot [grid size] [seed] [queries] [snapshot file]
+ *        BenchmarkRouting ordering [grid size] [seed] [queries]
+ *        BenchmarkRouting delta [grid size] [seed] [threads] [checks]
+ *        BenchmarkRouting timedependent [grid size] [seed] [queries] [period]
+ *        BenchmarkRouting partition [grid size] [seed] [cell size] [queries]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "RoadGraph.h"
+#include "RoutingBenchmark.h"
+#include "random.h"
+#include "vector.h"
+using namespace std;
+
+/* Default values of the optional arguments */
+const int DEFAULT_GRID_SIZE = 200;
+const int DEFAULT_SEED = 106;
+const int DEFAULT_PERTURBATIONS = 100;
+const int DEFAULT_QUERIES = 100;
+const string DEFAULT_SNAPSHOT_FILE = "BenchmarkRouting.snapshot";
+const int DEFAULT_THREADS = 0;
+const int DEFAULT_CHECKS = 100;
+const double DEFAULT_PERIOD = 1440;
+const int DEFAULT_CELL_SIZE = 256;
+
+/* Largest cost of a road of the generated grid per unit of length (the smallest is 1) */
+const double MAX_ROAD_SLOWDOWN = 3.0;
+
+/* Modes selected by the first argument */
+const string PLANNER_MODE = "planner";
+const string SNAPSHOT_MODE = "snapshot";
+const string ORDERING_MODE = "ordering";
+const string DELTA_MODE = "delta";
+const string TIME_DEPENDENT_MODE = "timedependent";
+const string PARTITION_MODE = "partition";
+
+/* Function prototypes */
+static void printUsage(const string& program);
+static void makeGridGraph(RoadGraph& graph, int size, Vector<RoadNode*>& nodes);
+
+int main(int argc, char** argv) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode != PLANNER_MODE && mode != SNAPSHOT_MODE && mode != ORDERING_MODE && mode != DELTA_MODE
+            && mode != TIME_DEPENDENT_MODE && mode != PARTITION_MODE) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    int gridSize = argc > 2 ? atoi(argv[2]) : DEFAULT_GRID_SIZE;
+    if (gridSize < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    setRandomSeed(argc > 3 ? atoi(argv[3]) : DEFAULT_SEED);
+    try {
+        RoadGraph graph;
+        Vector<RoadNode*> nodes;
+        makeGridGraph(graph, gridSize, nodes);
+        RoadNode* start = nodes[0];
+        if (mode == PLANNER_MODE) {
+            int perturbations = argc > 4 ? atoi(argv[4]) : DEFAULT_PERTURBATIONS;
+            benchmarkIncrementalPlanner(graph, start, nodes[nodes.size() - 1], perturbations);
+        } else if (mode == SNAPSHOT_MODE) {
+            int queries = argc > 4 ? atoi(argv[4]) : DEFAULT_QUERIES;
+            string snapshotFile = argc > 5 ? argv[5] : DEFAULT_SNAPSHOT_FILE;
+            benchmarkSnapshot(graph, start, snapshotFile, queries);
+        } else if (mode == ORDERING_MODE) {
+            int queries = argc > 4 ? atoi(argv[4]) : DEFAULT_QUERIES;
+            benchmarkNodeOrdering(graph, start, queries);
+        } else if (mode == DELTA_MODE) {
+            int maxThreads = argc > 4 ? atoi(argv[4]) : DEFAULT_THREADS;
+            if (maxThreads <= 0) {
+                maxThreads = max((int) thread::hardware_concurrency(), 1);
+            }
+            int checks = argc > 5 ? atoi(argv[5]) : DEFAULT_CHECKS;
+            benchmarkDeltaStepping(graph, start, maxThreads, checks);
+        } else if (mode == TIME_DEPENDENT_MODE) {
+            int queries = argc > 4 ? atoi(argv[4]) : DEFAULT_QUERIES;
+            double period = argc > 5 ? atof(argv[5]) : DEFAULT_PERIOD;
+            benchmarkTimeDependent(graph, start, queries, period);
+        } else {
+            int maxCellSize = argc > 4 ? atoi(argv[4]) : DEFAULT_CELL_SIZE;
+            int queries = argc > 5 ? atoi(argv[5]) : DEFAULT_QUERIES;
+            benchmarkPartition(graph, start, maxCellSize, queries);
+        }
+    } catch (const string& problem) {
+        cout << problem << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/* Function: printUsage()
+ * Usage: printUsage(program)
+ * -----------------------------------------------------------------------------
+ * Prints the arguments of every mode of the program.
+ */
+static void printUsage(const string& program) {
+    cout << "Usage: " << program << " " << PLANNER_MODE << " [grid size] [seed] [perturbations]" << endl;
+    cout << "       " << program << " " << SNAPSHOT_MODE << " [grid size] [seed] [queries] [snapshot file]" << endl;
+    cout << "       " << program << " " << ORDERING_MODE << " [grid size] [seed] [queries]" << endl;
+    cout << "       " << program << " " << DELTA_MODE << " [grid size] [seed] [threads] [checks]" << endl;
+    cout << "       " << program << " " << TIME_DEPENDENT_MODE << " [grid size] [seed] [queries] [period]" << endl;
+    cout << "       " << program << " " << PARTITION_MODE << " [grid size] [seed] [cell size] [queries]" << endl;
+}
+
+/* Function: makeGridGraph()
+ * Usage: makeGridGraph(graph, size, nodes)
+ * -----------------------------------------------------------------------------
+ * Adds to graph a size x size grid of intersections one unit of length apart, appended to nodes
+ * row by row, and two roads (one each way) between every intersection and its right and lower
+ * neighbors. Both roads of a pair cost their length times a random factor between 1 and
+ * MAX_ROAD_SLOWDOWN, so the straight line distance never overestimates the cost of a path.
+ * @param: graph type RoadGraph - graph the intersections and roads are added to.
+ * @param: size type int - number of rows and columns of intersections.
+ * @param: nodes type Vector<RoadNode*> - intersections added, row by row.
+ */
+static void makeGridGraph(RoadGraph& graph, int size, Vector<RoadNode*>& nodes) {
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            nodes.add(graph.addNode(to_string(row * size + col), GPoint(col, row)));
+        }
+    }
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            RoadNode* node = nodes[row * size + col];
+            if (col + 1 < size) {
+                double cost = randomReal(1, MAX_ROAD_SLOWDOWN);
+                graph.addEdge(node, nodes[row * size + col + 1], cost);
+                graph.addEdge(nodes[row * size + col + 1], node, cost);
+            }
+            if (row + 1 < size) {
+                double cost = randomReal(1, MAX_ROAD_SLOWDOWN);
+                graph.addEdge(node, nodes[(row + 1) * size + col], cost);
+                graph.addEdge(nodes[(row + 1) * size + col], node, cost);
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * File: BoardSolution.cpp
+ * -----------------------
+ * This file implements the BoardSolution class, which includes the following methods
+ * - BoardSolution constructors, which find every word of the board with BoggleBoard::findWords, or
+ * with LetterHistogramIndex::findWords when it is faster, and index the words by text.
+ * - methods to look up a word and read the cells of its path.
+ */
+
+#include "BoardSolution.h"
+
+/** Method: BoardSolution
+ * Usage: BoardSolution solution
+ * -----------------------------------------------------
+ * Creates the solution of a board without words.
+ */
+BoardSolution::BoardSolution() {
+    pathOffsets.push_back(0);
+}
+
+/** Method: BoardSolution
+ * Usage: BoardSolution solution(board, trie, minLength)
+ * -----------------------------------------------------
+ * Finds every word of trie with at least minLength letters that can be formed on board, and one
+ * path of cells forming each.
+ * @param board - BoggleBoard type, board searched.
+ * @param trie - CompactLexicon type, words searched.
+ * @param minLength - int type, smallest number of letters of a word.
+ */
+BoardSolution::BoardSolution(const BoggleBoard& board, const CompactLexicon& trie, int minLength) {
+    pathOffsets.push_back(0);
+    board.findWords(trie, minLength, foundWords, pathCells, pathOffsets);
+    indexWords();
+}
+
+/** Method: BoardSolution
+ * Usage: BoardSolution solution(board, histograms)
+ * -----------------------------------------------------
+ * Same as BoardSolution(board, *histograms.dictionary(), histograms.minLength()), finding the words
+ * with the dictionary scan of histograms instead of the board search when
+ * histograms.prefersScan(board) says it is faster (histograms.findWordsFastest). The words are the
+ * same either way, in another order.
+ * @param histograms - LetterHistogramIndex type, letter counts of the words of its dictionary.
+ */
+BoardSolution::BoardSolution(const BoggleBoard& board, const LetterHistogramIndex& histograms) {
+    pathOffsets.push_back(0);
+    histograms.findWordsFastest(board, foundWords, pathCells, pathOffsets);
+    indexWords();
+}
+
+/** Method: indexWords
+ * Usage: indexWords()
+ * -----------------------------------------------------
+ * Computes the index of every word found by text.
+ */
+void BoardSolution::indexWords() {
+    wordIndexes.reserve(foundWords.size());
+    for (int i = 0; i < (int) foundWords.size(); i++) {
+        wordIndexes[foundWords[i]] = i;
+    }
+}
+
+/** Method: wordCount
+ * Usage: solution.wordCount()
+ * -----------------------------------------------------
+ * @return int type, number of words of the board.
+ */
+int BoardSolution::wordCount() const {
+    return foundWords.size();
+}
+
+/** Method: word
+ * Usage: solution.word(index)
+ * -----------------------------------------------------
+ * @param index - int type, index of a word, between 0 and wordCount() - 1.
+ * @return string type, the word (upper case).
+ */
+const string& BoardSolution::word(int index) const {
+    return foundWords[index];
+}
+
+/** Method: indexOf
+ * Usage: solution.indexOf(word)
+ * -----------------------------------------------------
+ * @param word - string type, word looked up (upper case).
+ * @return int type, index of word, -1 if it cannot be formed on the board (or is not in the
+ * dictionary, or is too short).
+ */
+int BoardSolution::indexOf(const string& word) const {
+    auto found = wordIndexes.find(word);
+    return found == wordIndexes.end() ? -1 : found->second;
+}
+
+/** Method: contains
+ * Usage: solution.contains(word)
+ * -----------------------------------------------------
+ * @param word - string type, word looked up (upper case).
+ * @return bool type, true if word is one of the words of the board.
+ */
+bool BoardSolution::contains(const string& word) const {
+    return wordIndexes.count(word) != 0;
+}
+
+/** Method: pathBegin
+ * Usage: for (const int* cell = solution.pathBegin(index); cell != solution.pathEnd(index); cell++)
+ * -----------------------------------------------------
+ * Returns the first of the cells forming the word of number index on the board, in the order of
+ * its letters (one cell per tile, so a word using a "QU" tile has fewer cells than letters).
+ * pathEnd returns the position after the last cell.
+ */
+const int* BoardSolution::pathBegin(int index) const {
+    return pathCells.data() + pathOffsets[index];
+}
+
+const int* BoardSolution::pathEnd(int index) const {
+    return pathCells.data() + pathOffsets[index + 1];
+}
+
+/** Method: words
+ * Usage: solution.words()
+ * -----------------------------------------------------
+ * @return vector<string> type, every word of the board, in the order they were found.
+ */
+const vector<string>& BoardSolution::words() const {
+    return foundWords;
+}
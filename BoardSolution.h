@@ -0,0 +1,46 @@
+/*
+ * File: BoardSolution.h
+ * ---------------------
+ * This file declares the BoardSolution class, every word of a dictionary that can be formed on a
+ * BoggleBoard together with the cells of one path forming it. It is computed once, with one
+ * exhaustive search, when a board is created; afterwards checking a word a player submits is one
+ * hash lookup, and the cells to highlight come from the stored path instead of a new search.
+ * The words can be found with the board search (BoggleBoard::findWords) or, for small
+ * dictionaries, by checking every word of the dictionary against the board (LetterHistogramIndex).
+ * A BoardSolution is never changed after it is built, so one solution can be read by any number of
+ * threads at the same time.
+ */
+
+#ifndef _boardsolution_h
+#define _boardsolution_h
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BoggleBoard.h"
+#include "CompactLexicon.h"
+#include "LetterHistogramIndex.h"
+using namespace std;
+
+class BoardSolution {
+public:
+    BoardSolution();
+    BoardSolution(const BoggleBoard& board, const CompactLexicon& trie, int minLength);
+    BoardSolution(const BoggleBoard& board, const LetterHistogramIndex& histograms);
+    int wordCount() const;
+    const string& word(int index) const;
+    int indexOf(const string& word) const;
+    bool contains(const string& word) const;
+    const int* pathBegin(int index) const;
+    const int* pathEnd(int index) const;
+    const vector<string>& words() const;
+
+private:
+    // instance variables
+    vector<string> foundWords;              // words of the board, in the order they were found
+    vector<int> pathOffsets;                // path of word i is pathCells[pathOffsets[i] .. pathOffsets[i + 1])
+    vector<int> pathCells;
+    unordered_map<string, int> wordIndexes; // index of every word in foundWords
+    void indexWords();
+};
+
+#endif // _boardsolution_h
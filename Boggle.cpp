@@ -9,13 +9,21 @@
  * - method to check if a word is valid (> 4 letters, found in dictionary, not found previously by user)
  * - method to check if a word can be made by a chain of letters in a boggle object board
  * - method to find all the valid words that can be found in a board and that have not been found
- * previously by the human player.
+ * previously by the human player. The search walks a CompactLexicon (trie) along with the board, one
+ * child lookup per letter, instead of looking up every partial word in the Lexicon.
+ * Letters are kept in a BoggleBoard, which precomputes the neighbors of every cube and tracks the cubes
+ * used by a word in a bitmask, so the searches do not allocate memory at every step.
+ * Every word of the board, with one path forming it, is found once when the board is created
+ * (BoardSolution): checking a word of the human player is then a lookup, not a search.
  * - method to update the list of words found by the user.
  * This file does not contain any extension functionality. Please refer to files with "extension"
  * suffix for extension functionality.
  */
  
 #include "Boggle.h"
+#include <cctype>
+#include <cmath>
+#include <vector>
 #include "shuffle.h"
 #include "random.h"
 #include "bogglegui.h"
@@ -37,57 +45,111 @@ static string BIG_BOGGLE_CUBES[25] = {
     "FIPRSY", "GORRVW", "HIPRRY", "NOOTUW", "OOOTTU"
 };
  
-/*Grid dimensions*/
-const int GRID_SIZE = 4;
- 
 /*Minimum word length*/
 const int MIN_WORD_LENGTH = 4;
  
+const string EXCEPTION_MIN_LENGTH = "Letter histograms must index the words of at least " +
+        to_string(MIN_WORD_LENGTH) + " letters";
+ 
 /** Method: Boggle
- * Usage: Boggle(dictionary, boardText)
+ * Usage: Boggle(dictionary, boardText, boardSize)
  * -----------------------------------------------------
  * Instantiates one boggle object and sets default value for instance variables.
  * Constructor initializes the Boggle oject board to use the given dictionary
  * lexicon to look up words and uses the string passed as parameter to initialize the board cubes
- * from top left to bottom right. If the string passed as parameter is an empty string, the method
- * generates a random shuffled board. The random shuffled board is made by positioning each of the
- * 16 strings of letter cubes in CUBES randomly first and then selecting a random letter in each of
- * the cubes. Board is populated in upper case.
- * Assumptions: string passed as parameter is a 16 letter string or an empty string.
+ * from top left to bottom right. The board is square, with as many rows as the square root of the
+ * length of the string. If the string passed as parameter is an empty string, the method
+ * generates a random shuffled board of boardSize x boardSize cubes (see randomBoardLetters).
+ * Board is populated in upper case. A Q on the board is the "Qu" face of the cubes (see boggleTiles).
+ * Throws a string exception if the length of the string is not a square.
  * This method is case-insensitive and accepts board text in upper, lower and mixed case.
- * Default vaues for other instance variables are 0 for userScore and computerScore, empty sets
- * for userWordsFound and computerWordsFound, and dictionary for the dictionary.
+ * Default vaues for other instance variables are 0 for userScore and computerScore, and empty sets
+ * for userWordsFound and computerWordsFound. The dictionary is not copied: its words are stored in a
+ * CompactLexicon (trie), used both to check the words of the user and for the computer search.
+ * The solution of the board (every word with at least MIN_WORD_LENGTH letters and one path forming
+ * it) is computed here.
  * @param dictionary - Lexicon type. Lexicon used to check if the words provided by user
  * or found during word search are valid English words.
  * @param boardText: string type
+ * @param boardSize: int type, number of rows and columns of a random board.
+ */
+Boggle::Boggle(const Lexicon& dictionary, string boardText, int boardSize)
+    : Boggle(make_shared<CompactLexicon>(dictionary), boardText, boardSize) {
+}
+ 
+/** Method: Boggle
+ * Usage: Boggle(trie, boardText, boardSize)
+ * -----------------------------------------------------
+ * Same as Boggle(dictionary, boardText, boardSize), using a trie of dictionary that was already built. Building
+ * the trie takes longer than a word search, so programs creating many boards should build it once and
+ * share it between all the boards.
+ * @param trie - shared_ptr<const CompactLexicon> type. Trie of the words of the dictionary, used by
+ * checkWord and computerWordSearch.
+ * @param boardText: string type
+ * @param boardSize: int type, number of rows and columns of a random board.
  */
-Boggle::Boggle(const Lexicon& dictionary, string boardText) {
-    this->board = Grid<char>(GRID_SIZE, GRID_SIZE);
-    shuffle(CUBES, 16);
-    int index = 0;
-    for (int r = 0; r < GRID_SIZE ; r++) {
-        for (int c = 0; c < GRID_SIZE; c++) {
-            // random grid generation if empty string passed as parameter
-            if (boardText.length() == 0) {
-                string cubeLetters = CUBES[GRID_SIZE * r + c];
-                int randomNumber = randomInteger(0, 5);
-                this->board[r][c] = cubeLetters[randomNumber];
-            } else {
-                string textboard = toUpperCase(boardText);
-                this->board[r][c] = textboard[index];
-                index++;
-            }
- 
-         }
-     }
- 
-    this->dictionary = dictionary;
+Boggle::Boggle(shared_ptr<const CompactLexicon> trie, string boardText, int boardSize)
+    : Boggle(trie, nullptr, boardText, boardSize) {
+}
+ 
+/** Method: Boggle
+ * Usage: Boggle(histograms, boardText, boardSize)
+ * -----------------------------------------------------
+ * Same as Boggle(histograms->dictionary(), boardText, boardSize), except that the words of the board
+ * are found by checking every word of the dictionary against the letters of the board when
+ * histograms says it is faster for this board size (small dictionaries), instead of always
+ * searching the board.
+ * Throws a string exception if the minimum word length of histograms is not MIN_WORD_LENGTH, the
+ * length checkWord, humanWordSearch and computerWordSearch use for the words of both players.
+ * @param histograms - shared_ptr<const LetterHistogramIndex> type. Letter counts of the words of the
+ * dictionary, built once and shared between all the boards.
+ * @param boardText: string type
+ * @param boardSize: int type, number of rows and columns of a random board.
+ */
+Boggle::Boggle(shared_ptr<const LetterHistogramIndex> histograms, string boardText, int boardSize)
+    : Boggle(histograms->dictionary(), histograms, boardText, boardSize) {
+}
+ 
+/** Method: Boggle
+ * Usage: Boggle(trie, histograms, boardText, boardSize)
+ * -----------------------------------------------------
+ * Creates the board and its solution, found with histograms when it is not null.
+ */
+Boggle::Boggle(shared_ptr<const CompactLexicon> trie, shared_ptr<const LetterHistogramIndex> histograms,
+               string boardText, int boardSize) {
+    if (histograms && histograms->minLength() != MIN_WORD_LENGTH) {
+        throw EXCEPTION_MIN_LENGTH;
+    }
+    string letters = toUpperCase(boardText);
+    // random grid generation if empty string passed as parameter
+    if (letters.length() == 0) {
+        letters = randomBoardLetters(boardSize, boardSize);
+    } else {
+        boardSize = (int) round(sqrt(letters.length()));
+    }
+    this->board = BoggleBoard(boardSize, boardSize, boggleTiles(letters));
+    this->trie = trie;
+    if (histograms) {
+        this->solution = make_shared<const BoardSolution>(board, *histograms);
+    } else {
+        this->solution = make_shared<const BoardSolution>(board, *trie, MIN_WORD_LENGTH);
+    }
     this->userWordsFound = {};
     this->computerWordsFound = {};
     this->userScore = 0;
     this->computerScore = 0;
 }
  
+/** Method: getBoardSize
+ * Usage: b.getBoardSize()
+ * -----------------------------------------------------
+ * Returns the number of rows (and columns) of the board of the boggle object.
+ * @return int type, number of rows of the board.
+ */
+int Boggle::getBoardSize() const {
+    return board.numRows();
+}
+ 
 /** Method: getLetter
  * Usage: b.getLetter(row, col)
  * -----------------------------------------------------
@@ -103,7 +165,7 @@ char Boggle::getLetter(int row, int col) {
     if (!board.inBounds(row, col)) {
         throw -1;
     } else {
-        return board[row][col];
+        return board.letter(board.cellAt(row, col));
     }
 }
  
@@ -118,7 +180,7 @@ char Boggle::getLetter(int row, int col) {
  */
 bool Boggle::checkWord(string word) {
     string wordUpperCase = toUpperCase(word);
-    return (dictionary.contains(wordUpperCase) && (word.length() >= MIN_WORD_LENGTH) &&
+    return (trie->contains(wordUpperCase) && (word.length() >= MIN_WORD_LENGTH) &&
             (!userWordsFound.contains(wordUpperCase)));
 }
  
@@ -128,86 +190,34 @@ bool Boggle::checkWord(string word) {
  * Checks to see of an individual word can be formed on the board of the Bogle object this method is
  * called on, by tracing a path through neighoring letters. Two letters are neighbors if they are next
  * to each other horizontally, vertically or diagonally. Each cube can be used at most once in a word.
- * Finds where the word can start, and from each starting point it recursively tries to extend to find
- * the target word "word" with a recursive helper function.
- * Returns true if the word can be formed on the board, false otherwise. Uses recursive backtracking
- * and ahelper function to search for words. As each cube is explored it is highlighted and
- * subsequently unhighlighted if the cube is not part of a successful path to form the target word.
- * Once the word has been found the cubes selected to build it remain highlighted.
+ * Returns true if the word can be formed on the board, false otherwise. Words of the dictionary with
+ * at least MIN_WORD_LENGTH letters are looked up in the solution of the board, which also gives the
+ * cubes forming them; other words are searched with recursive backtracking by the BoggleBoard
+ * (BoggleBoard::findPath). Once the word has been found the cubes selected to build it are highlighted.
  * Assumptions: word passed is in uppercase. Letters in grid are in uppercase.
  * @param word: string type. Word we're searching in the board.
  * @return boolean: true if the word was found in the board, false otherwise.
  */
 bool Boggle::humanWordSearch(string word) {
     BoggleGUI::clearHighlighting();
-    string currentWord;
-    // Keeps track of which cubes have been used
-    Grid<bool> hasBeenSelected(GRID_SIZE, GRID_SIZE);
-    // Keeps track of position in the word we're considering
-    int index = 0;
-    // search for first letter
-    for (int r = 0; r < board.numRows(); r++) {
-        for (int c = 0; c < board.numCols(); c++) {
-            BoggleGUI::setHighlighted(r, c, true);
-            if (board[r][c] == word[index]) {
-                //choose
-                hasBeenSelected[r][c] = true;
-                currentWord += board[r][c];
-                //recurse/explore
-                if (humanWordHelper(word, currentWord, r, c, hasBeenSelected, index + 1)) {
-                    return true;
-                }
-                // unchoose/undo changes
-                hasBeenSelected[r][c] = false;
-                currentWord = currentWord.substr(0, currentWord.length() - 1);
-            }
-            BoggleGUI::setHighlighted(r, c, false);
+    int index = solution->indexOf(word);
+    if (index != -1) {
+        for (const int* cell = solution->pathBegin(index); cell != solution->pathEnd(index); cell++) {
+            BoggleGUI::setHighlighted(*cell / board.numCols(), *cell % board.numCols(), true);
         }
-    }
-    return false;
-}
- 
-/** Method: humanWordHelper
- * Usage: humanWordHelper(word, currentWord, r, c, hasBeelSelected, currentIndex)
- * ---------------------------------------------------------------------------------
- * Recursively tries to extend currentWord to find word, adding letters to currentWord from cubes that
- * have not been used yet and that are neighbors of position r,c.
- * If currentWord is equal to word we were able to find the word in the board and the function returns true.
- * @param word: string type. Word we're searching for in the board.
- * @param currentWord: string type. Word we're buiding by exploring neighoring letters from a given position.
- * @param hasBeenSelected: Grid<bool> type keeping track of cubes that have been used (one cube can be used at most
- * once in a word).
- * @param currentIndex: index of the character from our target word we're looking for in the board.
- * @return boolean: true if the word was found in the board, false otherwise.
- */
-bool Boggle::humanWordHelper(string word, string currentWord, int r, int c, Grid<bool> &hasBeenSelected, int currentIndex) {
-    if (word == currentWord) {
         return true;
-    } else {
-        for (int newr = r - 1; newr <= r + 1; newr++) {
-            for (int newc = c - 1; newc <= c + 1; newc++) {
-                // exclude current cell
-                if (newr == r && newc == c) continue;
-                if (board.inBounds(newr, newc) && !hasBeenSelected[newr][newc]) {
-                    if (board[newr][newc] == word[currentIndex]) {
-                        // choose
-                        currentWord += board[newr][newc];
-                        hasBeenSelected[newr][newc]= true;
-                        BoggleGUI::setHighlighted(newr, newc, true);
-                        // explore
-                        if(humanWordHelper(word, currentWord, newr, newc, hasBeenSelected, currentIndex + 1)) {
-                            return true;
-                        }
-                        //unchoose
-                        hasBeenSelected[newr][newc]= false;
-                        currentWord = currentWord.substr(0, currentWord.length() - 1);
-                        BoggleGUI::setHighlighted(newr, newc, false);
-                    }
-                }
-            }
-        }
+    }
+    if (word.length() >= MIN_WORD_LENGTH && trie->contains(word)) {
+        return false;
+    }
+    vector<int> path;
+    if (!board.findPath(word, path)) {
         return false;
     }
+    for (int cell : path) {
+        BoggleGUI::setHighlighted(cell / board.numCols(), cell % board.numCols(), true);
+    }
+    return true;
 }
  
 /** Method: getScoreHuman
@@ -249,64 +259,31 @@ Set<string> Boggle::getComputerWordsFound() const {
  * for all words that can be formed and that have not been found by the human player. Returns the list of
  * all words as a Set of strings.
  * Each cube can be used at most once in a word.
- * Relies on recursive helper function that prunes searches by not exploring partial paths that will
- * not be able to form a valid word.
+ * The words come from the solution of the board, found by BoggleBoard::findWords when the board was
+ * created: it prunes searches by not exploring partial paths that will not be able to form a valid
+ * word, a path is only extended while its letters lead to a node of the trie.
  */
 Set<string> Boggle::computerWordSearch() {
-    Grid<bool> hasBeenSelected(GRID_SIZE, GRID_SIZE);
-    string currentWord;
     Set<string> result;
-    for (int r =0 ; r < board.numRows(); r++) {
-        for (int c =0; c < board.numCols(); c++) {
-            // choose
-            hasBeenSelected[r][c]= true;
-            currentWord += board[r][c];
-            // explore
-            helperComputer(r, c, hasBeenSelected, result, dictionary, currentWord);
-            // unchoose
-            hasBeenSelected[r][c]= false;
-            currentWord = currentWord.substr(0, currentWord.length() - 1);
+    for (const string& word : solution->words()) {
+        if (!userWordsFound.contains(word)) {
+            result.add(word);
+            computerScore += 1 + word.length() - MIN_WORD_LENGTH;
         }
     }
     return result;
 }
  
-/** Method: helperComputer
- * Usage: helperComputer(r, c, hasBeenSelected, result, dictionary, currentWord)
+/** Method: getSolution
+ * Usage: b.getSolution()
  * ---------------------------------------------------------------------------------
- * Recursively searches paths via unselected neighboring cells to find words in dictionary that are of valid length
- * and that have not been found by human user. Prunes searches by not exploring partial paths that will not be
- * able to form a valid word.
- * If a valid word is found it adds it to the set of words passed as parameter to this method.
- * @param: r (type int) row of position for which we're exploring neighboring cubes in board
- * @param: c (type int) column of position for which we're exploring neighboring cubes in board
- * @param: hasBeenSelected (Grid<bool> type): keeps track of the cubes that have already been used
- * @param: result (Set<string>) list of 4+ letter unique english words that can be found in board and that have
- * not been found by human player.
- * @param: dictionary (type Lexicon) - used to check if word found is an English word
- * @param: currentWord (type string) - word that is being built and for which we check validity
+ * Returns the solution of the board of the Boggle object: every word with at least MIN_WORD_LENGTH
+ * letters that can be formed on it, with one path per word. The solution never changes and can be
+ * shared with other threads.
+ * @return solution: type shared_ptr<const BoardSolution>.
  */
-void Boggle::helperComputer(int r, int c, Grid<bool> &hasBeenSelected, Set<string> &result, const Lexicon &dictionary,
-                            string currentWord) {
-    if (dictionary.contains(currentWord) && !userWordsFound.contains(currentWord) && checkWord(currentWord)){
-        result.add(currentWord);
-        computerScore += 1 + currentWord.length() - MIN_WORD_LENGTH;
-    // prune search - we do not explore partial paths that will not be able to form valid word
-    } else if (!dictionary.containsPrefix(currentWord)){
-       return;
-    }
-    for (int newr = r - 1; newr <= r + 1; newr++) {
-        for (int newc = c - 1; newc <= c + 1; newc++) {
-            if (newr == r && newc == c) continue;
-            if (board.inBounds(newr, newc) && !hasBeenSelected[newr][newc]) {
-                currentWord += board[newr][newc];
-                hasBeenSelected[newr][newc]= true;
-                helperComputer(newr, newc, hasBeenSelected, result, dictionary, currentWord);
-                hasBeenSelected[newr][newc]= false;
-                currentWord = currentWord.substr(0, currentWord.length() - 1);
-            }
-        }
-    }
+shared_ptr<const BoardSolution> Boggle::getSolution() const {
+    return solution;
 }
  
 /** Method: setComputerWordsFound
@@ -374,7 +351,7 @@ void Boggle::setScoreHuman(int score) {
 ostream& operator<<(ostream& out, const Boggle& boggle) {
     for (int r = 0; r < boggle.board.numRows(); r++) {
         for (int c = 0 ; c < boggle.board.numCols(); c++) {
-            out << boggle.board[r][c];
+            out << boggle.board.letter(boggle.board.cellAt(r, c));
         }
         out << endl;
     }
@@ -386,3 +363,78 @@ ostream& operator<<(ostream& out, const Boggle& boggle) {
  
  
     
+ 
+/** Function: randomBoardLetters
+ * Usage: randomBoardLetters(rows, cols)
+ * ---------------------------------------------------------------------------------
+ * Returns the letters of a random rows x cols board, row by row, in upper case. A 4x4 board is made by
+ * positioning each of the 16 strings of letter cubes in CUBES randomly first and then selecting a
+ * random letter in each of the cubes, and a 5x5 board the same way with the 25 cubes of
+ * BIG_BOGGLE_CUBES. Boards of other sizes have no official set of cubes: each position gets a cube of
+ * BIG_BOGGLE_CUBES chosen at random (cubes can repeat) and a random letter of that cube.
+ * Not thread-safe: the cube arrays are shuffled in place.
+ * @param rows - int type, number of rows of the board.
+ * @param cols - int type, number of columns of the board.
+ * @return string type, rows * cols letters.
+ */
+string randomBoardLetters(int rows, int cols) {
+    string letters;
+    int numCubes = rows * cols;
+    if (numCubes == BOGGLE_SIZE * BOGGLE_SIZE) {
+        shuffle(CUBES, numCubes);
+    } else if (numCubes == BIG_BOGGLE_SIZE * BIG_BOGGLE_SIZE) {
+        shuffle(BIG_BOGGLE_CUBES, numCubes);
+    }
+    for (int cube = 0; cube < numCubes; cube++) {
+        string cubeLetters;
+        if (numCubes == BOGGLE_SIZE * BOGGLE_SIZE) {
+            cubeLetters = CUBES[cube];
+        } else if (numCubes == BIG_BOGGLE_SIZE * BIG_BOGGLE_SIZE) {
+            cubeLetters = BIG_BOGGLE_CUBES[cube];
+        } else {
+            cubeLetters = BIG_BOGGLE_CUBES[randomInteger(0, BIG_BOGGLE_SIZE * BIG_BOGGLE_SIZE - 1)];
+        }
+        int randomNumber = randomInteger(0, 5);
+        letters += cubeLetters[randomNumber];
+    }
+    return letters;
+}
+ 
+/** Function: boggleCubes
+ * Usage: boggleCubes(rows, cols)
+ * ---------------------------------------------------------------------------------
+ * Returns the letters on all 6 sides of every cube of a rows x cols board: CUBES for a 4x4 board,
+ * BIG_BOGGLE_CUBES for a 5x5 board, and no cubes for other sizes.
+ * @param rows - int type, number of rows of the board.
+ * @param cols - int type, number of columns of the board.
+ * @return vector<string> type, one string of 6 letters per cube, empty if the size has no cubes.
+ */
+vector<string> boggleCubes(int rows, int cols) {
+    if (rows * cols == BOGGLE_SIZE * BOGGLE_SIZE) {
+        return vector<string>(CUBES, CUBES + BOGGLE_SIZE * BOGGLE_SIZE);
+    } else if (rows * cols == BIG_BOGGLE_SIZE * BIG_BOGGLE_SIZE) {
+        return vector<string>(BIG_BOGGLE_CUBES, BIG_BOGGLE_CUBES + BIG_BOGGLE_SIZE * BIG_BOGGLE_SIZE);
+    }
+    return vector<string>();
+}
+ 
+/** Function: boggleTiles
+ * Usage: BoggleBoard board(rows, cols, boggleTiles(letters))
+ * ---------------------------------------------------------------------------------
+ * Returns the tiles of a board whose letters are letters (one per cube face, as returned by
+ * randomBoardLetters): every Q is the "Qu" face of the cubes, the tile Q_TILE, and every other letter a
+ * tile of its own. Words then use Q only followed by U, and QU counts as two letters.
+ * @param letters - string type, letters of the board, row by row, in any case.
+ * @return vector<string> type, one tile per letter.
+ */
+vector<string> boggleTiles(const string& letters) {
+    vector<string> tiles;
+    for (char letter : letters) {
+        if (toupper((unsigned char) letter) == Q_TILE[0]) {
+            tiles.push_back(Q_TILE);
+        } else {
+            tiles.push_back(string(1, letter));
+        }
+    }
+    return tiles;
+}
@@ -10,18 +10,35 @@
 #ifndef _boggle_h
 #define _boggle_h
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
+#include "BoardSolution.h"
+#include "BoggleBoard.h"
+#include "CompactLexicon.h"
+#include "LetterHistogramIndex.h"
 #include "lexicon.h"
-#include "grid.h"
+#include "set.h"
 using namespace std;
  
+/* Number of rows and columns of a standard board and of a "Big Boggle" board */
+const int BOGGLE_SIZE = 4;
+const int BIG_BOGGLE_SIZE = 5;
+ 
+/* Tile of the Q face of the cubes: Q is always followed by U */
+const string Q_TILE = "QU";
+ 
 class Boggle {
 public:
-    Boggle(const Lexicon& dictionary, string boardText = "");
+    Boggle(const Lexicon& dictionary, string boardText = "", int boardSize = BOGGLE_SIZE);
+    Boggle(shared_ptr<const CompactLexicon> trie, string boardText = "", int boardSize = BOGGLE_SIZE);
+    Boggle(shared_ptr<const LetterHistogramIndex> histograms, string boardText = "", int boardSize = BOGGLE_SIZE);
+    int getBoardSize() const;
     bool checkWord(string word);
     bool gridContains(char currentChar);
     bool humanWordSearch(string word);
     Set<string> computerWordSearch();
+    shared_ptr<const BoardSolution> getSolution() const;
     char getLetter(int row, int col);
     Set<string> getComputerWordsFound() const;
     Set<string> getUserWordsFound() const;
@@ -37,13 +54,17 @@ private:
     // instance variables
     Set<string> userWordsFound;
     Set<string> computerWordsFound;
-    Grid<char> board;
+    BoggleBoard board;
     int userScore;
     int computerScore;
-    Lexicon dictionary;
-    bool humanWordHelper(string word, string currentWord, int r, int c, Grid<bool> &hasBeenSelected, int currentIndex);
-    void helperComputer(int r, int c, Grid<bool> &hasBeenSelected, Set<string> &result, const Lexicon &dictionary, string currentWord);
+    shared_ptr<const CompactLexicon> trie;
+    shared_ptr<const BoardSolution> solution;
+    Boggle(shared_ptr<const CompactLexicon> trie, shared_ptr<const LetterHistogramIndex> histograms,
+           string boardText, int boardSize);
 };
  
+string randomBoardLetters(int rows, int cols);
+vector<string> boggleCubes(int rows, int cols);
+vector<string> boggleTiles(const string& letters);
+ 
 #endif // _boggle_h
- 
\ No newline at end of file
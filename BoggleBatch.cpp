@@ -0,0 +1,94 @@
+/*
+ * File: BoggleBatch.cpp
+ * ---------------------
+ * This file implements solveBoards. Every thread repeatedly takes the next BATCH_CHUNK boards that
+ * no thread has taken yet (an atomic counter) and solves them, so threads that get easy boards
+ * simply take more of them. Threads only read the trie and the board strings and each one writes
+ * the results of its own boards, so no lock is needed.
+ */
+
+#include "BoggleBatch.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Boggle.h"
+#include "BoggleBoard.h"
+
+/* Number of boards a thread takes at a time */
+static const int BATCH_CHUNK = 16;
+
+/* Exceptions */
+const string EXCEPTION_BOARD_SIZE = "Board letters do not match its size";
+
+/* Function prototypes */
+static void solveBoardsWorker(const CompactLexicon& trie, const vector<string>& boards, int rows, int cols,
+                              int minLength, atomic<int>& nextBoard, vector<BoardResult>& results);
+
+/* Function: solveBoards()
+ * Usage: solveBoards(trie, boards, rows, cols, minLength, numThreads, boardsPerSecond)
+ * -----------------------------------------------------------------------------
+ * Finds every word of trie with at least minLength letters on each board, and its score (one
+ * point for a word of minLength letters plus one point per extra letter), using numThreads
+ * threads. A Q on a board is the "Qu" tile of the cubes, as in a game (see boggleTiles).
+ * Throws a string exception (before starting any thread) if a board does not have rows * cols
+ * letters.
+ * @param: trie type CompactLexicon - words searched, shared by all the threads.
+ * @param: boards type vector<string> - letters of every board, row by row.
+ * @param: rows type int - number of rows of the boards.
+ * @param: cols type int - number of columns of the boards.
+ * @param: minLength type int - smallest number of letters of a word.
+ * @param: numThreads type int - number of threads used (0 for one per hardware thread).
+ * @param: boardsPerSecond type double - set to the number of boards solved per second.
+ * @return: vector<BoardResult> type, words and score of every board, in the order of boards.
+ */
+vector<BoardResult> solveBoards(const CompactLexicon& trie, const vector<string>& boards, int rows, int cols,
+                                int minLength, int numThreads, double &boardsPerSecond) {
+    for (const string& letters : boards) {
+        if (rows < 0 || cols < 0 || (int) letters.length() != rows * cols) {
+            throw EXCEPTION_BOARD_SIZE;
+        }
+    }
+    if (numThreads <= 0) {
+        numThreads = max((int) thread::hardware_concurrency(), 1);
+    }
+    vector<BoardResult> results(boards.size());
+    atomic<int> nextBoard(0);
+    auto startTime = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) {
+        workers.push_back(thread(solveBoardsWorker, cref(trie), cref(boards), rows, cols, minLength,
+                                 ref(nextBoard), ref(results)));
+    }
+    solveBoardsWorker(trie, boards, rows, cols, minLength, nextBoard, results);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    boardsPerSecond = seconds > 0 ? boards.size() / seconds : 0;
+    return results;
+}
+
+/* Function: solveBoardsWorker()
+ * Usage: solveBoardsWorker(trie, boards, rows, cols, minLength, nextBoard, results)
+ * -----------------------------------------------------------------------------
+ * Body of every thread: solves chunks of boards until none is left.
+ */
+static void solveBoardsWorker(const CompactLexicon& trie, const vector<string>& boards, int rows, int cols,
+                              int minLength, atomic<int>& nextBoard, vector<BoardResult>& results) {
+    int numBoards = boards.size();
+    while (true) {
+        int first = nextBoard.fetch_add(BATCH_CHUNK);
+        if (first >= numBoards) {
+            return;
+        }
+        for (int b = first; b < min(first + BATCH_CHUNK, numBoards); b++) {
+            BoggleBoard board(rows, cols, boggleTiles(boards[b]));
+            BoardResult& result = results[b];
+            board.findWords(trie, minLength, result.words);
+            result.score = 0;
+            for (const string& word : result.words) {
+                result.score += 1 + word.length() - minLength;
+            }
+        }
+    }
+}
@@ -0,0 +1,25 @@
+/*
+ * File: BoggleBatch.h
+ * -------------------
+ * This file declares solveBoards, which finds the words and scores of many Boggle boards at once
+ * using several threads that share one read-only CompactLexicon, and the BoardResult struct
+ * holding the result of one board.
+ */
+
+#ifndef _bogglebatch_h
+#define _bogglebatch_h
+#include <string>
+#include <vector>
+#include "CompactLexicon.h"
+using namespace std;
+
+/* Words found on one board and their total score */
+struct BoardResult {
+    vector<string> words;
+    int score;
+};
+
+vector<BoardResult> solveBoards(const CompactLexicon& trie, const vector<string>& boards, int rows, int cols,
+                                int minLength, int numThreads, double &boardsPerSecond);
+
+#endif // _bogglebatch_h
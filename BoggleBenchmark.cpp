@@ -0,0 +1,381 @@
+/*
+ * File: BoggleBenchmark.cpp
+ * -------------------------
+ * This file implements functions that time the Boggle solvers on random boards and print the
+ * results to the console:
+ * - every solver variant on the same seeded corpora of 4x4 and 5x5 boards: the recursive search
+ * asking a Lexicon about every partial word (the search Boggle used before the trie), the trie
+ * search of BoggleBoard, the trie search of the same boards with their Q as the "Qu" tile of the
+ * game (boggleTiles), the same search also recording the paths of the words (BoardSolution,
+ * what Boggle does when a board is created), the dictionary scan of LetterHistogramIndex, the
+ * solution built with whichever of the search and the scan is faster, and batch solving with
+ * several threads.
+ * - batch solving (solveBoards) of boards of increasing sizes, from 4x4 to boards of more than 64
+ * cells, which use the wide visited-cell mask.
+ * - a load generator for BoggleSessionServer: client threads submit words for the players of many
+ * games as fast as they can, and the throughput and latency percentiles of the server are printed.
+ * - the board optimizer (optimizeBoards): the best board of every chain and its score.
+ * Random boards are generated with randomBoardLetters before the timing starts.
+ */
+
+#include "BoggleBenchmark.h"
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <set>
+#include <vector>
+#include "BoardSolution.h"
+#include "Boggle.h"
+#include "BoggleBatch.h"
+#include "BoggleSessionServer.h"
+#include "LetterHistogramIndex.h"
+#include "random.h"
+
+/* Minimum word length used by the benchmarks */
+static const int BENCHMARK_MIN_WORD_LENGTH = 4;
+
+/* Letters the first board of every corpus starts with, so the Qu variants find QUIET on it */
+static const string QU_BOARD_START = "QIET";
+
+/* Fraction of the submissions of the load generator that are words of the board */
+static const double BOARD_WORD_FRACTION = 0.5;
+
+/* Rows and columns of the boards timed by benchmarkBoardSizes */
+static const int BOARD_SIZES[][2] = {{4, 4}, {5, 5}, {6, 6}, {4, 8}, {8, 8}, {9, 9}, {12, 12}};
+
+/* Function prototypes */
+static void lexiconSearch(const BoggleBoard& board, const Lexicon& dictionary, int cell, string& word,
+                          vector<bool>& visited, set<string>& words, WordSearchStats& stats);
+
+/* Function: benchmarkSolvers()
+ * Usage: benchmarkSolvers(dictionary, trie, boardsPerSize, seed, numThreads)
+ * -----------------------------------------------------------------------------
+ * Generates boardsPerSize random 4x4 boards and boardsPerSize random 5x5 boards after seeding the
+ * random number generator with seed, so the same seed always gives the same corpora, then solves
+ * every corpus with every solver variant and prints, per variant, the boards solved per second,
+ * the average number of paths explored by the depth-first search (DFS nodes) and of dictionary
+ * lookups (Lexicon calls or trie child lookups) per board, and the average number of words found,
+ * which must be the same for every variant except the Qu tile one and batch solving, which also
+ * reads a Q as the Qu tile (boards with a Q form other words; the first board of every corpus
+ * starts with QU_BOARD_START so they always differ). The batch row prints whether it found the
+ * same words as the Qu tile variant on every board. The solution and batch variants do not
+ * count their work, so they print n/a for the counters; the scan variant prints the words of the
+ * dictionary that reached the path search (candidates) and the words it checked instead.
+ * @param: dictionary type Lexicon - words searched by the Lexicon variant.
+ * @param: trie type CompactLexicon - the same words, searched by the other variants.
+ * @param: boardsPerSize type int - number of boards of every corpus.
+ * @param: seed type int - seed of the random number generator.
+ * @param: numThreads type int - number of threads of the batch variant (0 for one per hardware thread).
+ */
+void benchmarkSolvers(const Lexicon& dictionary, const CompactLexicon& trie, int boardsPerSize, int seed,
+                      int numThreads) {
+    // the index does not own trie, which outlives it
+    LetterHistogramIndex histograms(shared_ptr<const CompactLexicon>(shared_ptr<const CompactLexicon>(), &trie),
+                                    BENCHMARK_MIN_WORD_LENGTH);
+    setRandomSeed(seed);
+    cout << fixed << setprecision(1);
+    for (int size : {BOGGLE_SIZE, BIG_BOGGLE_SIZE}) {
+        vector<string> letters;
+        vector<BoggleBoard> corpus;
+        vector<BoggleBoard> tileCorpus;   // the same boards with Qu tiles
+        for (int i = 0; i < boardsPerSize; i++) {
+            letters.push_back(randomBoardLetters(size, size));
+            if (i == 0) {
+                letters.back().replace(0, QU_BOARD_START.length(), QU_BOARD_START);
+            }
+            corpus.push_back(BoggleBoard(size, size, letters.back()));
+            tileCorpus.push_back(BoggleBoard(size, size, boggleTiles(letters.back())));
+        }
+        int count = max(boardsPerSize, 1);
+        cout << size << "x" << size << " corpus, seed " << seed << ", " << boardsPerSize << " boards" << endl;
+
+        WordSearchStats total = {0, 0};
+        long numWords = 0;
+        auto startTime = chrono::steady_clock::now();
+        for (const BoggleBoard& board : corpus) {
+            set<string> words;
+            vector<bool> visited(board.cellCount(), false);
+            string word;
+            for (int cell = 0; cell < board.cellCount(); cell++) {
+                lexiconSearch(board, dictionary, cell, word, visited, words, total);
+            }
+            numWords += words.size();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        cout << "  lexicon:  " << (seconds > 0 ? corpus.size() / seconds : 0) << " boards/s, "
+             << (double) total.pathsExtended / count << " DFS nodes, " << (double) total.trieProbes / count
+             << " probes, " << (double) numWords / count << " words" << endl;
+
+        total = {0, 0};
+        numWords = 0;
+        startTime = chrono::steady_clock::now();
+        for (const BoggleBoard& board : corpus) {
+            vector<string> words;
+            WordSearchStats stats;
+            board.findWords(trie, BENCHMARK_MIN_WORD_LENGTH, words, stats);
+            total.pathsExtended += stats.pathsExtended;
+            total.trieProbes += stats.trieProbes;
+            numWords += words.size();
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        cout << "  trie:     " << (seconds > 0 ? corpus.size() / seconds : 0) << " boards/s, "
+             << (double) total.pathsExtended / count << " DFS nodes, " << (double) total.trieProbes / count
+             << " probes, " << (double) numWords / count << " words" << endl;
+
+        WordSearchStats tileTotal = {0, 0};
+        vector<vector<string>> tileWords(tileCorpus.size());
+        numWords = 0;
+        startTime = chrono::steady_clock::now();
+        for (size_t b = 0; b < tileCorpus.size(); b++) {
+            vector<string>& words = tileWords[b];
+            WordSearchStats stats;
+            tileCorpus[b].findWords(trie, BENCHMARK_MIN_WORD_LENGTH, words, stats);
+            tileTotal.pathsExtended += stats.pathsExtended;
+            tileTotal.trieProbes += stats.trieProbes;
+            numWords += words.size();
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        cout << "  qu tiles: " << (seconds > 0 ? tileCorpus.size() / seconds : 0) << " boards/s, "
+             << (double) tileTotal.pathsExtended / count << " DFS nodes, " << (double) tileTotal.trieProbes / count
+             << " probes, " << (double) numWords / count << " words" << endl;
+
+        numWords = 0;
+        startTime = chrono::steady_clock::now();
+        for (const BoggleBoard& board : corpus) {
+            BoardSolution solution(board, trie, BENCHMARK_MIN_WORD_LENGTH);
+            numWords += solution.wordCount();
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        cout << "  solution: " << (seconds > 0 ? corpus.size() / seconds : 0) << " boards/s, "
+             << "n/a DFS nodes, n/a probes, " << (double) numWords / count << " words" << endl;
+
+        WordSearchStats scanTotal = {0, 0};
+        numWords = 0;
+        startTime = chrono::steady_clock::now();
+        for (const BoggleBoard& board : corpus) {
+            vector<string> words;
+            vector<int> pathCells;
+            vector<int> pathEnds;
+            WordSearchStats stats;
+            histograms.findWords(board, words, pathCells, pathEnds, stats);
+            scanTotal.pathsExtended += stats.pathsExtended;
+            scanTotal.trieProbes += stats.trieProbes;
+            numWords += words.size();
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        cout << "  scan:     " << (seconds > 0 ? corpus.size() / seconds : 0) << " boards/s, "
+             << (double) scanTotal.pathsExtended / count << " candidates, " << (double) scanTotal.trieProbes / count
+             << " words checked, " << (double) numWords / count << " words" << endl;
+
+        numWords = 0;
+        startTime = chrono::steady_clock::now();
+        for (const BoggleBoard& board : corpus) {
+            BoardSolution solution(board, histograms);
+            numWords += solution.wordCount();
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        bool scan = !corpus.empty() && histograms.prefersScan(corpus.back());
+        cout << "  auto:     " << (seconds > 0 ? corpus.size() / seconds : 0) << " boards/s, "
+             << (scan ? "scan" : "search") << " chosen, " << (double) numWords / count << " words" << endl;
+
+        double boardsPerSecond = 0;
+        vector<BoardResult> results = solveBoards(trie, letters, size, size, BENCHMARK_MIN_WORD_LENGTH, numThreads,
+                                                  boardsPerSecond);
+        numWords = 0;
+        bool sameWords = true;
+        for (size_t b = 0; b < results.size(); b++) {
+            numWords += results[b].words.size();
+            sameWords = sameWords && set<string>(results[b].words.begin(), results[b].words.end())
+                    == set<string>(tileWords[b].begin(), tileWords[b].end());
+        }
+        cout << "  batch:    " << boardsPerSecond << " boards/s, n/a DFS nodes, n/a probes, "
+             << (double) numWords / count << " words, "
+             << (sameWords ? "same words as qu tiles" : "DIFFERENT WORDS FROM QU TILES") << endl;
+    }
+}
+
+/* Function: lexiconSearch()
+ * Usage: lexiconSearch(board, dictionary, cell, word, visited, words, stats)
+ * -----------------------------------------------------------------------------
+ * Recursive search of the Lexicon variant, as Boggle searched boards before the trie: adds the
+ * letter of cell to word, records word if it is a word of dictionary long enough, and goes on to
+ * every unused neighbor while word is a prefix of a dictionary word. Counts every call in
+ * stats.pathsExtended and every Lexicon lookup in stats.trieProbes.
+ */
+static void lexiconSearch(const BoggleBoard& board, const Lexicon& dictionary, int cell, string& word,
+                          vector<bool>& visited, set<string>& words, WordSearchStats& stats) {
+    stats.pathsExtended++;
+    word += board.letter(cell);
+    visited[cell] = true;
+    if ((int) word.length() >= BENCHMARK_MIN_WORD_LENGTH) {
+        stats.trieProbes++;
+        if (dictionary.contains(word)) {
+            words.insert(word);
+        }
+    }
+    stats.trieProbes++;
+    if (dictionary.containsPrefix(word)) {
+        for (const int* neighbor = board.neighborsBegin(cell); neighbor != board.neighborsEnd(cell); neighbor++) {
+            if (!visited[*neighbor]) {
+                lexiconSearch(board, dictionary, *neighbor, word, visited, words, stats);
+            }
+        }
+    }
+    visited[cell] = false;
+    word.pop_back();
+}
+
+/* Function: benchmarkBoardSizes()
+ * Usage: benchmarkBoardSizes(trie, boardsPerSize, numThreads)
+ * -----------------------------------------------------------------------------
+ * Solves boardsPerSize random boards of every size of BOARD_SIZES with solveBoards and prints,
+ * for every size, the number of boards solved per second and the average number of words and
+ * score per board.
+ * @param: trie type CompactLexicon - words searched.
+ * @param: boardsPerSize type int - number of boards solved for every size.
+ * @param: numThreads type int - number of threads used (0 for one per hardware thread).
+ */
+void benchmarkBoardSizes(const CompactLexicon& trie, int boardsPerSize, int numThreads) {
+    cout << fixed << setprecision(1);
+    for (const int* size : BOARD_SIZES) {
+        int rows = size[0];
+        int cols = size[1];
+        vector<string> boards;
+        for (int i = 0; i < boardsPerSize; i++) {
+            boards.push_back(randomBoardLetters(rows, cols));
+        }
+        double boardsPerSecond = 0;
+        vector<BoardResult> results = solveBoards(trie, boards, rows, cols, BENCHMARK_MIN_WORD_LENGTH, numThreads,
+                                                  boardsPerSecond);
+        double words = 0, score = 0;
+        for (const BoardResult& result : results) {
+            words += result.words.size();
+            score += result.score;
+        }
+        int count = max(boardsPerSize, 1);
+        cout << rows << "x" << cols << ": " << boardsPerSecond << " boards/s, " << words / count
+             << " words, score " << score / count << endl;
+    }
+}
+
+/* Function: latencyPercentile()
+ * Usage: latencyPercentile(sortedLatencies, fraction)
+ * -----------------------------------------------------------------------------
+ * Returns the latency below which fraction of the sorted latencies fall (0 if there are none).
+ */
+static double latencyPercentile(const vector<double>& sortedLatencies, double fraction) {
+    if (sortedLatencies.empty()) {
+        return 0;
+    }
+    size_t position = (size_t) (fraction * (sortedLatencies.size() - 1));
+    return sortedLatencies[position];
+}
+
+/* Function: benchmarkSessionServer()
+ * Usage: benchmarkSessionServer(trie, numGames, playersPerGame, submissionsPerPlayer, numClients, numWorkers,
+ *                               submissionsPerSecond)
+ * -----------------------------------------------------------------------------
+ * Creates numGames games on random 4x4 boards and has numClients threads submit
+ * submissionsPerPlayer words for every player of every game, without waiting for answers, at a
+ * steady total rate of submissionsPerSecond (or as fast as they can if it is 0: latencies then
+ * mostly measure the time spent waiting in the queue). Client threads share the players between
+ * them; about BOARD_WORD_FRACTION of the submissions are words of the board (players often submit
+ * the same word), the others random letters. Prints the submissions processed per second, how
+ * they were answered, and the 50th, 99th and 99.9th percentiles and maximum of the time between
+ * submission and scoring.
+ * @param: trie type shared_ptr<const CompactLexicon> - words of the dictionary.
+ * @param: numGames type int - number of games played at the same time.
+ * @param: playersPerGame type int - number of players of every game.
+ * @param: submissionsPerPlayer type int - number of words submitted by every player.
+ * @param: numClients type int - number of threads submitting words.
+ * @param: numWorkers type int - number of worker threads of the server (0 for one per hardware thread).
+ * @param: submissionsPerSecond type double - total rate of the clients, 0 for no limit.
+ */
+void benchmarkSessionServer(shared_ptr<const CompactLexicon> trie, int numGames, int playersPerGame,
+                            int submissionsPerPlayer, int numClients, int numWorkers, double submissionsPerSecond) {
+    numClients = max(numClients, 1);
+    BoggleSessionServer server(trie, numGames, numWorkers, BENCHMARK_MIN_WORD_LENGTH, true);
+    auto setupStart = chrono::steady_clock::now();
+    vector<shared_ptr<const BoardSolution>> solutions;   // read by the clients to pick words of the boards
+    for (int g = 0; g < numGames; g++) {
+        solutions.push_back(server.solution(server.createGame("", playersPerGame)));
+    }
+    double setupMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - setupStart).count();
+
+    long numPlayers = (long) numGames * playersPerGame;
+    auto startTime = chrono::steady_clock::now();
+    vector<thread> clients;
+    for (int c = 0; c < numClients; c++) {
+        clients.push_back(thread([&server, &solutions, c, numClients, numPlayers, playersPerGame, submissionsPerPlayer,
+                                  submissionsPerSecond, startTime] {
+            mt19937 generator(c + 1);
+            uniform_real_distribution<double> coin(0, 1);
+            double secondsBetween = submissionsPerSecond > 0 ? numClients / submissionsPerSecond : 0;
+            long sent = 0;
+            for (int round = 0; round < submissionsPerPlayer; round++) {
+                for (long player = c; player < numPlayers; player += numClients) {
+                    if (secondsBetween > 0) {
+                        this_thread::sleep_until(startTime + chrono::duration_cast<chrono::steady_clock::duration>(
+                                                     chrono::duration<double>(sent * secondsBetween)));
+                    }
+                    sent++;
+                    int game = player / playersPerGame;
+                    const BoardSolution* solution = solutions[game].get();
+                    string word;
+                    if (solution->wordCount() > 0 && coin(generator) < BOARD_WORD_FRACTION) {
+                        word = solution->word(generator() % solution->wordCount());
+                    } else {
+                        for (int i = 0; i < BENCHMARK_MIN_WORD_LENGTH + (int) (generator() % 4); i++) {
+                            word += (char) ('a' + generator() % 26);
+                        }
+                    }
+                    server.submit(game, player % playersPerGame, word);
+                }
+            }
+        }));
+    }
+    for (thread& client : clients) {
+        client.join();
+    }
+    SessionStats stats = server.shutdown();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    sort(stats.latencyMicros.begin(), stats.latencyMicros.end());
+    cout << fixed << setprecision(1);
+    cout << numGames << " games created in " << setupMillis << " ms; " << stats.processed << " submissions from "
+         << numClients << " clients: " << (seconds > 0 ? stats.processed / seconds : 0) << " submissions/s" << endl;
+    cout << "  " << stats.accepted << " accepted, " << stats.alreadyClaimed << " already claimed, "
+         << stats.rejected << " rejected" << endl;
+    cout << "  latency (us): p50 " << latencyPercentile(stats.latencyMicros, 0.5) << ", p99 "
+         << latencyPercentile(stats.latencyMicros, 0.99) << ", p99.9 " << latencyPercentile(stats.latencyMicros, 0.999)
+         << ", max " << (stats.latencyMicros.empty() ? 0 : stats.latencyMicros.back()) << endl;
+}
+
+/* Function: benchmarkOptimizer()
+ * Usage: benchmarkOptimizer(trie, settings)
+ * -----------------------------------------------------------------------------
+ * Runs optimizeBoards with settings and prints the time it took, then the best board of every
+ * chain, one row of letters after the other, with its score.
+ * @param: trie type CompactLexicon - words searched.
+ * @param: settings type OptimizerSettings - settings of the optimizer.
+ */
+void benchmarkOptimizer(const CompactLexicon& trie, const OptimizerSettings& settings) {
+    auto startTime = chrono::steady_clock::now();
+    vector<OptimizedBoard> boards = optimizeBoards(trie, settings);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << fixed << setprecision(1);
+    cout << settings.rows << "x" << settings.cols << " boards" << (settings.useCubes ? " rolled with the cubes" : "")
+         << ", " << settings.numChains << " chains of " << settings.iterations << " iterations, seed "
+         << settings.seed << ": " << seconds << " s" << endl;
+    for (const OptimizedBoard& board : boards) {
+        cout << " ";
+        for (int row = 0; row < settings.rows; row++) {
+            cout << " " << board.letters.substr(row * settings.cols, settings.cols);
+        }
+        cout << "  score " << board.score << endl;
+    }
+}
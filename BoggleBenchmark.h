@@ -0,0 +1,23 @@
+/*
+ * File: BoggleBenchmark.h
+ * -----------------------
+ * This file declares functions that time the Boggle solvers on random boards and print the
+ * results to the console. BenchmarkBoggle.cpp runs them from the command line.
+ */
+
+#ifndef _bogglebenchmark_h
+#define _bogglebenchmark_h
+#include <memory>
+#include "BoggleOptimizer.h"
+#include "CompactLexicon.h"
+#include "lexicon.h"
+using namespace std;
+
+void benchmarkSolvers(const Lexicon& dictionary, const CompactLexicon& trie, int boardsPerSize, int seed,
+                      int numThreads);
+void benchmarkBoardSizes(const CompactLexicon& trie, int boardsPerSize, int numThreads);
+void benchmarkSessionServer(shared_ptr<const CompactLexicon> trie, int numGames, int playersPerGame,
+                            int submissionsPerPlayer, int numClients, int numWorkers, double submissionsPerSecond);
+void benchmarkOptimizer(const CompactLexicon& trie, const OptimizerSettings& settings);
+
+#endif // _bogglebenchmark_h
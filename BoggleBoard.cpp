@@ -0,0 +1,464 @@
+/*
+ * File: BoggleBoard.cpp
+ * ---------------------
+ * This file implements the BoggleBoard class, which includes the following methods
+ * - BoggleBoard constructors, which store the tiles and compute the neighbors of every cell.
+ * - methods to read and change the tiles of the board.
+ * - method to find every word of a CompactLexicon that can be formed on the board, walking the
+ * trie one letter at a time along with the board.
+ * - method to find every word of a CompactLexicon that can be formed on the board with the cells of
+ * one path forming it, to answer later questions about the board without searching it again.
+ * - method to find the cells forming a given word.
+ * Two cells are neighbors if they are next to each other horizontally, vertically or diagonally,
+ * and each cell can be used at most once in a word. A word goes through all the letters of the
+ * tile of every cell it uses: a "QU" tile forms QUIT with a T and an I, never QI.
+ * The searches are templates over the set of visited cells: boards of up to SMALL_BOARD_CELLS
+ * cells use SmallVisitedCells (one 64-bit word in a register), larger boards WideVisitedCells
+ * (one bit per cell in an array of 64-bit words).
+ */
+
+#include "BoggleBoard.h"
+#include <cctype>
+
+/* Text for string exceptions */
+const string EXCEPTION_BOARD_SIZE = "Board letters do not match its size";
+const string EXCEPTION_TILE_LENGTH = "Board tiles must have 1 to " + to_string(MAX_TILE_LETTERS) + " letters";
+
+/* Function prototypes */
+static vector<string> singleLetterTiles(const string& letters);
+
+/* Cells used by the current path of a board of up to SMALL_BOARD_CELLS cells */
+struct SmallVisitedCells {
+    uint64_t bits;
+    SmallVisitedCells(int) : bits(0) {}
+    bool contains(int cell) const { return bits & (uint64_t(1) << cell); }
+    void add(int cell) { bits |= uint64_t(1) << cell; }
+    void remove(int cell) { bits &= ~(uint64_t(1) << cell); }
+};
+
+/* Cells used by the current path of a board of any size */
+struct WideVisitedCells {
+    vector<uint64_t> words;
+    WideVisitedCells(int cellCount) : words((cellCount + 63) / 64, 0) {}
+    bool contains(int cell) const { return words[cell >> 6] & (uint64_t(1) << (cell & 63)); }
+    void add(int cell) { words[cell >> 6] |= uint64_t(1) << (cell & 63); }
+    void remove(int cell) { words[cell >> 6] &= ~(uint64_t(1) << (cell & 63)); }
+};
+
+/** Method: BoggleBoard
+ * Usage: BoggleBoard board;
+ * -----------------------------------------------------
+ * Instantiates an empty board (0 rows, 0 columns).
+ */
+BoggleBoard::BoggleBoard() : BoggleBoard(0, 0, "") {
+}
+
+/** Method: BoggleBoard
+ * Usage: BoggleBoard board(rows, cols, letters)
+ * -----------------------------------------------------
+ * Instantiates a rows x cols board of one-letter tiles whose letters are given from top left to
+ * bottom right, in any case. Throws a string exception if letters does not have rows * cols
+ * characters.
+ * @param rows - int type, number of rows.
+ * @param cols - int type, number of columns.
+ * @param letters - string type, letters of the board, row by row.
+ */
+BoggleBoard::BoggleBoard(int rows, int cols, const string& letters)
+    : BoggleBoard(rows, cols, singleLetterTiles(letters)) {
+}
+
+/** Method: BoggleBoard
+ * Usage: BoggleBoard board(rows, cols, tiles)
+ * -----------------------------------------------------
+ * Instantiates a rows x cols board whose tiles are given from top left to bottom right, in any
+ * case. Throws a string exception if there are not rows * cols tiles or if a tile does not have
+ * 1 to MAX_TILE_LETTERS letters.
+ * @param rows - int type, number of rows.
+ * @param cols - int type, number of columns.
+ * @param tiles - vector<string> type, tiles of the board, row by row ("QU" for the Qu face).
+ */
+BoggleBoard::BoggleBoard(int rows, int cols, const vector<string>& tiles) {
+    if (rows < 0 || cols < 0 || (int) tiles.size() != rows * cols) {
+        throw EXCEPTION_BOARD_SIZE;
+    }
+    this->rows = rows;
+    this->cols = cols;
+    numLetters = 0;
+    cells.assign(tiles.size(), ' ');
+    tileLengths.assign(tiles.size(), 0);
+    tileLetters.assign(tiles.size() * MAX_TILE_LETTERS, ' ');
+    for (int cell = 0; cell < (int) tiles.size(); cell++) {
+        setTile(cell, tiles[cell]);
+    }
+    neighborOffsets.push_back(0);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            for (int newr = r - 1; newr <= r + 1; newr++) {
+                for (int newc = c - 1; newc <= c + 1; newc++) {
+                    if ((newr != r || newc != c) && inBounds(newr, newc)) {
+                        neighborCells.push_back(cellAt(newr, newc));
+                    }
+                }
+            }
+            neighborOffsets.push_back(neighborCells.size());
+        }
+    }
+}
+
+/** Method: numRows
+ * Usage: board.numRows()
+ * -----------------------------------------------------
+ * @return int type, number of rows of the board.
+ */
+int BoggleBoard::numRows() const {
+    return rows;
+}
+
+/** Method: numCols
+ * Usage: board.numCols()
+ * -----------------------------------------------------
+ * @return int type, number of columns of the board.
+ */
+int BoggleBoard::numCols() const {
+    return cols;
+}
+
+/** Method: cellCount
+ * Usage: board.cellCount()
+ * -----------------------------------------------------
+ * @return int type, number of cells of the board.
+ */
+int BoggleBoard::cellCount() const {
+    return cells.size();
+}
+
+/** Method: letterCount
+ * Usage: board.letterCount()
+ * -----------------------------------------------------
+ * @return int type, number of letters of all the tiles of the board (the length of the longest
+ * word that could be formed on it).
+ */
+int BoggleBoard::letterCount() const {
+    return numLetters;
+}
+
+/** Method: cellAt
+ * Usage: board.cellAt(row, col)
+ * -----------------------------------------------------
+ * @return int type, number of the cell at row, col. Assumption: row, col is in bounds.
+ */
+int BoggleBoard::cellAt(int row, int col) const {
+    return row * cols + col;
+}
+
+/** Method: inBounds
+ * Usage: board.inBounds(row, col)
+ * -----------------------------------------------------
+ * @return bool type, true if row, col is a cell of the board.
+ */
+bool BoggleBoard::inBounds(int row, int col) const {
+    return row >= 0 && row < rows && col >= 0 && col < cols;
+}
+
+/** Method: tile
+ * Usage: board.tile(cell)
+ * -----------------------------------------------------
+ * @return string type, letters of the tile of cell, in upper case (tileLength(cell) letters, the
+ * first one being letter(cell)).
+ */
+string BoggleBoard::tile(int cell) const {
+    return string(tileLetters.data() + cell * MAX_TILE_LETTERS, tileLengths[cell]);
+}
+
+/** Method: setLetter
+ * Usage: board.setLetter(cell, letter)
+ * -----------------------------------------------------
+ * Changes the tile of cell to the one letter given (stored in upper case).
+ * @param cell - int type, number of the cell.
+ * @param letter - char type, new letter of the cell.
+ */
+void BoggleBoard::setLetter(int cell, char letter) {
+    setTile(cell, string(1, letter));
+}
+
+/** Method: setTile
+ * Usage: board.setTile(cell, tile)
+ * -----------------------------------------------------
+ * Changes the tile of cell (stored in upper case). Throws a string exception if tile does not have
+ * 1 to MAX_TILE_LETTERS letters.
+ * @param cell - int type, number of the cell.
+ * @param tile - string type, new letters of the cell.
+ */
+void BoggleBoard::setTile(int cell, const string& tile) {
+    if (tile.empty() || (int) tile.length() > MAX_TILE_LETTERS) {
+        throw EXCEPTION_TILE_LENGTH;
+    }
+    numLetters += tile.length() - tileLengths[cell];
+    tileLengths[cell] = tile.length();
+    for (int i = 0; i < (int) tile.length(); i++) {
+        tileLetters[cell * MAX_TILE_LETTERS + i] = toupper((unsigned char) tile[i]);
+    }
+    cells[cell] = tileLetters[cell * MAX_TILE_LETTERS];
+}
+
+/** Method: findWords
+ * Usage: board.findWords(trie, minLength, words)
+ * -----------------------------------------------------
+ * Appends to words every word of trie with at least minLength letters that can be formed on the
+ * board, once each, by an exhaustive search from every cell. A path is only extended while its
+ * letters lead to a node of the trie.
+ * @param trie - CompactLexicon type, words searched.
+ * @param minLength - int type, smallest number of letters of a word.
+ * @param words - vector<string> type, words found are appended to it.
+ */
+void BoggleBoard::findWords(const CompactLexicon& trie, int minLength, vector<string>& words) const {
+    WordSearch search(trie, minLength, words, NULL, NULL, cellCount());
+    if (cellCount() <= SMALL_BOARD_CELLS) {
+        SmallVisitedCells visited(cellCount());
+        findWords(search, visited);
+    } else {
+        WideVisitedCells visited(cellCount());
+        findWords(search, visited);
+    }
+}
+
+/** Method: findWords
+ * Usage: board.findWords(trie, minLength, words, pathCells, pathEnds)
+ * -----------------------------------------------------
+ * Same as findWords(trie, minLength, words), also appending to pathCells the cells of the path that
+ * formed every word found, one cell per tile, in the order of the words, and to pathEnds the size
+ * of pathCells after every path: the path of the i-th word appended follows the paths of the words
+ * before it and ends where pathEnds says.
+ * @param pathCells - vector<int> type, cells of the words found are appended to it.
+ * @param pathEnds - vector<int> type, end of the path of every word found in pathCells is appended to it.
+ */
+void BoggleBoard::findWords(const CompactLexicon& trie, int minLength, vector<string>& words,
+                            vector<int>& pathCells, vector<int>& pathEnds) const {
+    WordSearch search(trie, minLength, words, &pathCells, &pathEnds, cellCount());
+    if (cellCount() <= SMALL_BOARD_CELLS) {
+        SmallVisitedCells visited(cellCount());
+        findWords(search, visited);
+    } else {
+        WideVisitedCells visited(cellCount());
+        findWords(search, visited);
+    }
+}
+
+/** Method: findPath
+ * Usage: board.findPath(word, path)
+ * -----------------------------------------------------
+ * Looks for a chain of neighboring cells whose tiles form word (upper case), each cell used at most once.
+ * @param word - string type, word searched.
+ * @param path - vector<int> type, set to the cells forming word, in order, if it is found.
+ * @return bool type, true if word can be formed on the board.
+ */
+bool BoggleBoard::findPath(const string& word, vector<int>& path) const {
+    path.clear();
+    if (word.empty() || (int) word.length() > letterCount()) {
+        return false;
+    }
+    if (cellCount() <= SMALL_BOARD_CELLS) {
+        SmallVisitedCells visited(cellCount());
+        return findPath(word, visited, path);
+    } else {
+        WideVisitedCells visited(cellCount());
+        return findPath(word, visited, path);
+    }
+}
+
+/** Method: findWords
+ * Usage: board.findWords(trie, minLength, words, stats)
+ * -----------------------------------------------------
+ * Same as findWords(trie, minLength, words), also returning the number of paths explored and of
+ * trie lookups made by the search (the counters are always kept, so the search costs the same).
+ * @param stats - WordSearchStats type, set to the counters of the search.
+ */
+void BoggleBoard::findWords(const CompactLexicon& trie, int minLength, vector<string>& words,
+                            WordSearchStats& stats) const {
+    WordSearch search(trie, minLength, words, NULL, NULL, cellCount());
+    if (cellCount() <= SMALL_BOARD_CELLS) {
+        SmallVisitedCells visited(cellCount());
+        findWords(search, visited);
+    } else {
+        WideVisitedCells visited(cellCount());
+        findWords(search, visited);
+    }
+    stats = search.stats;
+}
+
+/** Method: findWords
+ * Usage: findWords(search, visited)
+ * -----------------------------------------------------
+ * Starts the word search of findWords from every cell whose tile leads from the trie root to a node,
+ * then appends to search.words the letters of the paths the search recorded, one word per path.
+ */
+template <typename VisitedCells>
+void BoggleBoard::findWords(WordSearch& search, VisitedCells& visited) const {
+    const CompactLexicon& trie = search.trie;
+    for (int cell = 0; cell < cellCount(); cell++) {
+        int wordIndex = 0;
+        int length = 1;
+        int node = trie.child(trie.root(), cells[cell], wordIndex);
+        search.stats.trieProbes++;
+        if (node != -1 && tileLengths[cell] > 1) {
+            node = followTile(search, cell, node, wordIndex, length);
+        }
+        if (node != -1) {
+            search.path[0] = cell;
+            visited.add(cell);
+            extendWord(search, cell, node, wordIndex, length, 1, visited);
+            visited.remove(cell);
+        }
+    }
+    int start = search.firstPathCell;
+    for (int w = search.firstPathEnd; w < (int) search.pathEnds->size(); w++) {
+        int end = (*search.pathEnds)[w];
+        string word;
+        for (int i = start; i < end; i++) {
+            int pathCell = (*search.pathCells)[i];
+            word.append(tileLetters.data() + pathCell * MAX_TILE_LETTERS, tileLengths[pathCell]);
+        }
+        search.words.push_back(word);
+        start = end;
+    }
+}
+
+/** Method: extendWord
+ * Usage: extendWord(search, cell, node, wordIndex, length, pathLength, visited)
+ * -----------------------------------------------------
+ * Recursive step of findWords: the current path ends at cell, has pathLength cells (in
+ * search.path) and length letters, leads to node in the trie and uses the cells in visited.
+ * wordIndex is the index the letters of the path have if they form a word: trie nodes are shared
+ * by many words, so words already found are told apart by index, one bit of search.foundWords each.
+ * Records the path of the word if it is new and long enough, then tries every unused neighbor
+ * whose tile leads to a node of the trie. A one-letter tile costs one trie lookup, as the search
+ * did before tiles; only the cells holding longer tiles go through followTile.
+ */
+template <typename VisitedCells>
+void BoggleBoard::extendWord(WordSearch& search, int cell, int node, int wordIndex, int length, int pathLength,
+                             VisitedCells& visited) const {
+    const CompactLexicon& trie = search.trie;
+    search.stats.pathsExtended++;
+    if (trie.isWord(node) && length >= search.minLength) {
+        uint64_t& found = search.foundWords[wordIndex / 64];
+        uint64_t bit = uint64_t(1) << (wordIndex % 64);
+        if (!(found & bit)) {
+            found |= bit;
+            search.pathCells->insert(search.pathCells->end(), search.path.begin(), search.path.begin() + pathLength);
+            search.pathEnds->push_back(search.pathCells->size());
+        }
+    }
+    if (!trie.hasChildren(node)) {
+        return;
+    }
+    for (const int* neighbor = neighborsBegin(cell); neighbor != neighborsEnd(cell); neighbor++) {
+        if (visited.contains(*neighbor)) {
+            continue;
+        }
+        int nextIndex = wordIndex;
+        int nextLength = length + 1;
+        int next = trie.child(node, cells[*neighbor], nextIndex);
+        search.stats.trieProbes++;
+        if (next != -1 && tileLengths[*neighbor] > 1) {
+            next = followTile(search, *neighbor, next, nextIndex, nextLength);
+        }
+        if (next != -1) {
+            search.path[pathLength] = *neighbor;
+            visited.add(*neighbor);
+            extendWord(search, *neighbor, next, nextIndex, nextLength, pathLength + 1, visited);
+            visited.remove(*neighbor);
+        }
+    }
+}
+
+/** Method: followTile
+ * Usage: node = followTile(search, cell, node, wordIndex, length)
+ * -----------------------------------------------------
+ * Walks the trie from node, reached with the first letter of the tile of cell, through the other
+ * letters of the tile (at most MAX_TILE_LETTERS - 1 lookups), adding them to length and to
+ * wordIndex.
+ * @return int type, node reached with the whole tile, -1 if the tile leaves the trie.
+ */
+int BoggleBoard::followTile(WordSearch& search, int cell, int node, int& wordIndex, int& length) const {
+    const char* tile = tileLetters.data() + cell * MAX_TILE_LETTERS;
+    for (int i = 1; i < tileLengths[cell] && node != -1; i++) {
+        node = search.trie.child(node, tile[i], wordIndex);
+        search.stats.trieProbes++;
+        length++;
+    }
+    return node;
+}
+
+/** Method: findPath
+ * Usage: findPath(word, visited, path)
+ * -----------------------------------------------------
+ * Starts the search of findPath from every cell whose tile starts word.
+ */
+template <typename VisitedCells>
+bool BoggleBoard::findPath(const string& word, VisitedCells& visited, vector<int>& path) const {
+    for (int cell = 0; cell < cellCount(); cell++) {
+        if (cells[cell] == word[0] && tileMatches(word, 0, cell)) {
+            path.push_back(cell);
+            visited.add(cell);
+            if (extendPath(word, cell, tileLengths[cell], visited, path)) {
+                return true;
+            }
+            visited.remove(cell);
+            path.pop_back();
+        }
+    }
+    return false;
+}
+
+/** Method: extendPath
+ * Usage: extendPath(word, cell, length, visited, path)
+ * -----------------------------------------------------
+ * Recursive step of findPath: path holds the cells of the first length letters of word, ending at
+ * cell. Returns true once the whole word is formed.
+ */
+template <typename VisitedCells>
+bool BoggleBoard::extendPath(const string& word, int cell, int length, VisitedCells& visited, vector<int>& path) const {
+    if (length == (int) word.length()) {
+        return true;
+    }
+    for (const int* neighbor = neighborsBegin(cell); neighbor != neighborsEnd(cell); neighbor++) {
+        if (!visited.contains(*neighbor) && cells[*neighbor] == word[length] && tileMatches(word, length, *neighbor)) {
+            path.push_back(*neighbor);
+            visited.add(*neighbor);
+            if (extendPath(word, *neighbor, length + tileLengths[*neighbor], visited, path)) {
+                return true;
+            }
+            visited.remove(*neighbor);
+            path.pop_back();
+        }
+    }
+    return false;
+}
+
+/** Method: tileMatches
+ * Usage: if (tileMatches(word, position, cell)) ...
+ * -----------------------------------------------------
+ * @return bool type, true if the letters of word from position on start with the whole tile of
+ * cell. Assumption: the first letter of the tile was already compared.
+ */
+bool BoggleBoard::tileMatches(const string& word, int position, int cell) const {
+    if (tileLengths[cell] == 1) {
+        return true;
+    }
+    return word.compare(position, tileLengths[cell], tileLetters.data() + cell * MAX_TILE_LETTERS,
+                        tileLengths[cell]) == 0;
+}
+
+/* Function: singleLetterTiles()
+ * Usage: singleLetterTiles(letters)
+ * -----------------------------------------------------------------------------
+ * Returns one tile per character of letters.
+ */
+static vector<string> singleLetterTiles(const string& letters) {
+    vector<string> tiles;
+    tiles.reserve(letters.length());
+    for (char letter : letters) {
+        tiles.push_back(string(1, letter));
+    }
+    return tiles;
+}
@@ -0,0 +1,122 @@
+/*
+ * File: BoggleBoard.h
+ * -------------------
+ * This file declares the BoggleBoard class, a rectangular board of letters of any size laid out
+ * for fast word searches. Cells are numbered row by row, the neighbors of every cell are computed
+ * once when the board is created, and searches keep the cells used by the current path in a
+ * bitmask (one 64-bit word for boards of up to 64 cells, an array of words for larger boards) and
+ * only record the cells of the words they find, whose letters are read once the search is over,
+ * so the backtracking loop does not build strings.
+ * Every cell holds a tile of one letter or of a few letters (the "Qu" face of the dice): words
+ * are read through a tile's letters in order, and a tile's letters are stored next to each other
+ * so the search follows them with a bounded number of trie lookups. The first letter of every
+ * tile is also kept in its own array, which is all the search reads for one-letter tiles.
+ * Letters are stored in upper case.
+ */
+
+#ifndef _boggleboard_h
+#define _boggleboard_h
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CompactLexicon.h"
+using namespace std;
+
+/* Largest number of cells of a board whose visited cells fit in one 64-bit mask */
+const int SMALL_BOARD_CELLS = 64;
+
+/* Largest number of letters of the tile of one cell */
+const int MAX_TILE_LETTERS = 4;
+
+/* Counters of one word search of a board */
+struct WordSearchStats {
+    long pathsExtended;   // paths explored by the depth-first search (their letters lead to a trie node)
+    long trieProbes;      // child lookups in the trie
+};
+
+class BoggleBoard {
+public:
+    BoggleBoard();
+    BoggleBoard(int rows, int cols, const string& letters);
+    BoggleBoard(int rows, int cols, const vector<string>& tiles);
+    int numRows() const;
+    int numCols() const;
+    int cellCount() const;
+    int letterCount() const;
+    int cellAt(int row, int col) const;
+    bool inBounds(int row, int col) const;
+    char letter(int cell) const;
+    int tileLength(int cell) const;
+    string tile(int cell) const;
+    void setLetter(int cell, char letter);
+    void setTile(int cell, const string& tile);
+    const int* neighborsBegin(int cell) const;
+    const int* neighborsEnd(int cell) const;
+    void findWords(const CompactLexicon& trie, int minLength, vector<string>& words) const;
+    void findWords(const CompactLexicon& trie, int minLength, vector<string>& words, vector<int>& pathCells,
+                   vector<int>& pathEnds) const;
+    void findWords(const CompactLexicon& trie, int minLength, vector<string>& words, WordSearchStats& stats) const;
+    bool findPath(const string& word, vector<int>& path) const;
+
+private:
+    /* State of one findWords call, shared by all the levels of the recursion */
+    struct WordSearch {
+        const CompactLexicon& trie;
+        int minLength;
+        vector<string>& words;
+        vector<uint64_t> foundWords;      // one bit per index in the trie, set once its word is found
+        vector<int> path;                 // cells of the current path
+        vector<int> ownPathCells;         // paths of the words found if the caller does not want them
+        vector<int> ownPathEnds;
+        vector<int>* pathCells;           // the path of every word found is appended to it
+        vector<int>* pathEnds;            // and the size of pathCells after it to pathEnds
+        int firstPathCell;                // sizes of pathCells and pathEnds before the search
+        int firstPathEnd;
+        WordSearchStats stats;
+        WordSearch(const CompactLexicon& trie, int minLength, vector<string>& words, vector<int>* pathCells,
+                   vector<int>* pathEnds, int cellCount)
+            : trie(trie), minLength(minLength), words(words), foundWords((trie.size() + 63) / 64, 0),
+              path(cellCount), pathCells(pathCells != NULL ? pathCells : &ownPathCells),
+              pathEnds(pathEnds != NULL ? pathEnds : &ownPathEnds), firstPathCell(this->pathCells->size()),
+              firstPathEnd(this->pathEnds->size()), stats{0, 0} {}
+    };
+
+    // instance variables
+    int rows;
+    int cols;
+    int numLetters;
+    vector<char> cells;            // first letter of the tile of every cell
+    vector<int> tileLengths;       // number of letters of the tile of every cell
+    vector<char> tileLetters;      // tile of cell c is tileLetters[c * MAX_TILE_LETTERS .. + tileLengths[c])
+    vector<int> neighborOffsets;   // neighbors of cell c are neighborCells[neighborOffsets[c] .. neighborOffsets[c + 1])
+    vector<int> neighborCells;
+    template <typename VisitedCells>
+    void findWords(WordSearch& search, VisitedCells& visited) const;
+    template <typename VisitedCells>
+    void extendWord(WordSearch& search, int cell, int node, int wordIndex, int length, int pathLength,
+                    VisitedCells& visited) const;
+    int followTile(WordSearch& search, int cell, int node, int& wordIndex, int& length) const;
+    bool tileMatches(const string& word, int position, int cell) const;
+    template <typename VisitedCells>
+    bool findPath(const string& word, VisitedCells& visited, vector<int>& path) const;
+    template <typename VisitedCells>
+    bool extendPath(const string& word, int cell, int length, VisitedCells& visited, vector<int>& path) const;
+};
+
+inline char BoggleBoard::letter(int cell) const {
+    return cells[cell];
+}
+
+inline int BoggleBoard::tileLength(int cell) const {
+    return tileLengths[cell];
+}
+
+inline const int* BoggleBoard::neighborsBegin(int cell) const {
+    return neighborCells.data() + neighborOffsets[cell];
+}
+
+inline const int* BoggleBoard::neighborsEnd(int cell) const {
+    return neighborCells.data() + neighborOffsets[cell + 1];
+}
+
+#endif // _boggleboard_h
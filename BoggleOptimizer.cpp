@@ -0,0 +1,211 @@
+/*
+ * File: BoggleOptimizer.cpp
+ * -------------------------
+ * This file implements optimizeBoards. Every chain starts from a random board and repeatedly
+ * changes it a little, keeping the change if the score goes up, and also, with a probability that
+ * decreases as the temperature goes down, if the score goes down (simulated annealing), so chains
+ * can leave local maxima early and settle on a good board at the end.
+ * Two changes are tried: giving one cube (or cell) a new letter, and swapping the cubes of two
+ * cells. With useCubes, every cell holds one of the cubes of the board size and shows one of its
+ * faces; without it, new letters are drawn from the faces of all the Big Boggle cubes, so letters
+ * keep realistic frequencies. A Q face is the "Qu" tile, as in a game and in solveBoards.
+ * A score depends on every word of the board, and a changed letter can add or remove words far
+ * from its cell, so boards are re-solved rather than updated. Chains revisit boards often (a
+ * rejected change is frequently tried again), so every chain keeps the scores of the boards it
+ * solved in a cache, and changes that leave the board as it was are not solved at all.
+ * Chains run in threads taking chain numbers from an atomic counter, each with its own random
+ * number generator, and only share the read-only trie.
+ */
+
+#include "BoggleOptimizer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include "Boggle.h"
+#include "BoggleBoard.h"
+
+/* Text for string exceptions */
+const string EXCEPTION_NO_CUBES = "There are no cubes for boards of this size";
+const string EXCEPTION_BAD_SETTINGS = "Board size, iterations and temperatures of the optimizer must be positive";
+
+/* Largest number of scores kept in the cache of a chain before it is emptied */
+static const size_t MAX_CACHED_SCORES = 1 << 20;
+
+/* Function prototypes */
+static void optimizerWorker(const CompactLexicon& trie, const OptimizerSettings& settings, const vector<string>& cubes,
+                            atomic<int>& nextChain, vector<OptimizedBoard>& results);
+static OptimizedBoard annealChain(const CompactLexicon& trie, const OptimizerSettings& settings,
+                                  const vector<string>& cubes, int chain);
+static int boardScore(const CompactLexicon& trie, const BoggleBoard& board, int minLength, vector<string>& words);
+static void setFace(BoggleBoard& board, int cell, char letter);
+
+/* Function: optimizeBoards()
+ * Usage: optimizeBoards(trie, settings)
+ * -----------------------------------------------------------------------------
+ * Runs settings.numChains simulated annealing chains looking for the settings.rows x
+ * settings.cols board with the highest score (same scoring as solveBoards) and returns the best
+ * board of every chain, best first. Throws a string exception if the board size, the number of
+ * iterations or a temperature is not positive, or if settings.useCubes is true and the board size
+ * has no cubes (only 4x4 and 5x5 boards do: other sizes, including boards of more than
+ * SMALL_BOARD_CELLS cells, need useCubes false and give every cell its own cube).
+ * @param: trie type CompactLexicon - words searched, shared by all the chains.
+ * @param: settings type OptimizerSettings - board size, number of chains and iterations,
+ * temperatures, threads and random seed.
+ * @return: vector<OptimizedBoard> type, best board of every chain, sorted by decreasing score.
+ */
+vector<OptimizedBoard> optimizeBoards(const CompactLexicon& trie, const OptimizerSettings& settings) {
+    if (settings.rows <= 0 || settings.cols <= 0 || settings.iterations <= 0 || !(settings.startTemperature > 0)
+            || !(settings.endTemperature > 0)) {
+        throw EXCEPTION_BAD_SETTINGS;
+    }
+    vector<string> cubes = boggleCubes(settings.rows, settings.cols);
+    if (settings.useCubes && cubes.empty()) {
+        throw EXCEPTION_NO_CUBES;
+    }
+    if (!settings.useCubes) {
+        // one "cube" per cell holding every face of the Big Boggle cubes
+        string faces;
+        for (const string& cube : boggleCubes(BIG_BOGGLE_SIZE, BIG_BOGGLE_SIZE)) {
+            faces += cube;
+        }
+        cubes.assign(settings.rows * settings.cols, faces);
+    }
+    int numThreads = settings.numThreads > 0 ? settings.numThreads : max((int) thread::hardware_concurrency(), 1);
+    vector<OptimizedBoard> results(max(settings.numChains, 0));
+    atomic<int> nextChain(0);
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) {
+        workers.push_back(thread(optimizerWorker, cref(trie), cref(settings), cref(cubes), ref(nextChain), ref(results)));
+    }
+    optimizerWorker(trie, settings, cubes, nextChain, results);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    sort(results.begin(), results.end(), [](const OptimizedBoard& a, const OptimizedBoard& b) {
+        return a.score > b.score;
+    });
+    return results;
+}
+
+/* Function: optimizerWorker()
+ * Usage: optimizerWorker(trie, settings, cubes, nextChain, results)
+ * -----------------------------------------------------------------------------
+ * Body of every thread: runs chains until none is left.
+ */
+static void optimizerWorker(const CompactLexicon& trie, const OptimizerSettings& settings, const vector<string>& cubes,
+                            atomic<int>& nextChain, vector<OptimizedBoard>& results) {
+    while (true) {
+        int chain = nextChain.fetch_add(1);
+        if (chain >= (int) results.size()) {
+            return;
+        }
+        results[chain] = annealChain(trie, settings, cubes, chain);
+    }
+}
+
+/* Function: annealChain()
+ * Usage: annealChain(trie, settings, cubes, chain)
+ * -----------------------------------------------------------------------------
+ * Runs one simulated annealing chain and returns the best board it visited. cubeOf[cell] is the
+ * cube shown in cell; with cubes of the board size it is a permutation of the cubes, otherwise
+ * every cell has its own copy of the same cube.
+ */
+static OptimizedBoard annealChain(const CompactLexicon& trie, const OptimizerSettings& settings,
+                                  const vector<string>& cubes, int chain) {
+    mt19937 random(settings.seed + chain);
+    int numCells = settings.rows * settings.cols;
+    vector<int> cubeOf(numCells);
+    for (int cell = 0; cell < numCells; cell++) {
+        cubeOf[cell] = cell;
+    }
+    shuffle(cubeOf.begin(), cubeOf.end(), random);
+    string letters;
+    for (int cell = 0; cell < numCells; cell++) {
+        const string& cube = cubes[cubeOf[cell]];
+        letters += cube[random() % cube.length()];
+    }
+    BoggleBoard board(settings.rows, settings.cols, boggleTiles(letters));
+    vector<string> words;
+    unordered_map<string, int> scoreCache;
+    int score = boardScore(trie, board, settings.minLength, words);
+    OptimizedBoard best = {letters, score};
+    double cooling = pow(settings.endTemperature / settings.startTemperature, 1.0 / settings.iterations);
+    double temperature = settings.startTemperature;
+    uniform_real_distribution<double> probability(0, 1);
+
+    for (int i = 0; i < settings.iterations; i++, temperature *= cooling) {
+        // change the board: new face for one cube, or swap the cubes of two cells
+        string previous = letters;
+        int first = random() % numCells;
+        int second = first;
+        if (numCells > 1 && random() % 2 == 0) {
+            second = random() % numCells;
+            swap(cubeOf[first], cubeOf[second]);
+            swap(letters[first], letters[second]);
+        } else {
+            const string& cube = cubes[cubeOf[first]];
+            letters[first] = cube[random() % cube.length()];
+        }
+        if (letters == previous) {
+            continue;
+        }
+        int newScore;
+        auto cached = scoreCache.find(letters);
+        if (cached != scoreCache.end()) {
+            newScore = cached->second;
+        } else {
+            setFace(board, first, letters[first]);
+            setFace(board, second, letters[second]);
+            newScore = boardScore(trie, board, settings.minLength, words);
+            if (scoreCache.size() >= MAX_CACHED_SCORES) {
+                scoreCache.clear();
+            }
+            scoreCache[letters] = newScore;
+        }
+        if (newScore >= score || probability(random) < exp((newScore - score) / temperature)) {
+            score = newScore;
+            if (score > best.score) {
+                best = {letters, score};
+            }
+        } else {
+            // undo the change
+            swap(cubeOf[first], cubeOf[second]);
+            letters = previous;
+        }
+        setFace(board, first, letters[first]);
+        setFace(board, second, letters[second]);
+    }
+    return best;
+}
+
+/* Function: boardScore()
+ * Usage: boardScore(trie, board, minLength, words)
+ * -----------------------------------------------------------------------------
+ * Returns the score of board: one point for every word of minLength letters plus one point per
+ * extra letter. words is only used as a buffer, to avoid allocating it for every board.
+ */
+static int boardScore(const CompactLexicon& trie, const BoggleBoard& board, int minLength, vector<string>& words) {
+    words.clear();
+    board.findWords(trie, minLength, words);
+    int score = 0;
+    for (const string& word : words) {
+        score += 1 + word.length() - minLength;
+    }
+    return score;
+}
+
+/* Function: setFace()
+ * Usage: setFace(board, cell, letter)
+ * -----------------------------------------------------------------------------
+ * Shows the cube face letter in cell: the tile Q_TILE for a Q, the letter alone otherwise.
+ */
+static void setFace(BoggleBoard& board, int cell, char letter) {
+    if (letter == Q_TILE[0]) {
+        board.setTile(cell, Q_TILE);
+    } else {
+        board.setLetter(cell, letter);
+    }
+}
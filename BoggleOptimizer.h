@@ -0,0 +1,38 @@
+/*
+ * File: BoggleOptimizer.h
+ * -----------------------
+ * This file declares optimizeBoards, which searches for Boggle boards with the highest score by
+ * simulated annealing, running independent chains in parallel, and the settings and results of
+ * the search.
+ */
+
+#ifndef _boggleoptimizer_h
+#define _boggleoptimizer_h
+#include <string>
+#include <vector>
+#include "CompactLexicon.h"
+using namespace std;
+
+/* Parameters of optimizeBoards */
+struct OptimizerSettings {
+    int rows = 4;
+    int cols = 4;
+    int minLength = 4;                // smallest number of letters of a word
+    bool useCubes = true;             // only boards that can be rolled with the cubes of this size
+    int numChains = 8;                // independent annealing chains
+    int iterations = 20000;           // board changes tried by every chain
+    double startTemperature = 50;     // score loss accepted with probability 1/e at the start
+    double endTemperature = 0.5;      // same at the end (the temperature decreases geometrically)
+    int numThreads = 0;               // 0 for one per hardware thread
+    unsigned int seed = 1;            // chain c uses seed + c, so results can be reproduced
+};
+
+/* Best board found by one chain */
+struct OptimizedBoard {
+    string letters;
+    int score;
+};
+
+vector<OptimizedBoard> optimizeBoards(const CompactLexicon& trie, const OptimizerSettings& settings);
+
+#endif // _boggleoptimizer_h
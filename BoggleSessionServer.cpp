@@ -0,0 +1,316 @@
+/*
+ * File: BoggleSessionServer.cpp
+ * -----------------------------
+ * This file implements the SubmissionQueue and BoggleSessionServer classes.
+ * Games are created in slots allocated by the constructor and published by increasing an atomic
+ * game count, so workers and score queries read games without taking a lock; createGame solves
+ * the board first and only takes a lock to fill the next slot. Workers take up to WORKER_BATCH
+ * submissions from the queue at a time, to lock it less often, and keep their own counters, merged
+ * by shutdown.
+ */
+
+#include "BoggleSessionServer.h"
+#include <cctype>
+#include <cmath>
+#include "Boggle.h"
+#include "BoggleBoard.h"
+
+/* Text for string exceptions */
+const string EXCEPTION_TOO_MANY_GAMES = "The server already hosts its maximum number of games";
+const string EXCEPTION_UNKNOWN_GAME = "There is no game with this number or player";
+const string EXCEPTION_SERVER_STOPPED = "The server has been shut down";
+const string EXCEPTION_NO_PLAYERS = "A game needs at least one player";
+
+/* Largest number of submissions a worker takes from the queue at a time */
+static const int WORKER_BATCH = 64;
+
+/** Method: SubmissionQueue
+ * Usage: SubmissionQueue queue
+ * -----------------------------------------------------
+ * Creates an empty, open queue.
+ */
+SubmissionQueue::SubmissionQueue() {
+    closed = false;
+}
+
+/** Method: push
+ * Usage: queue.push(submission)
+ * -----------------------------------------------------
+ * Adds submission at the end of the queue and wakes up one waiting consumer.
+ * @return bool type, false if the queue is closed (submission is dropped).
+ */
+bool SubmissionQueue::push(WordSubmission submission) {
+    {
+        lock_guard<mutex> guard(queueLock);
+        if (closed) {
+            return false;
+        }
+        submissions.push_back(move(submission));
+    }
+    notEmpty.notify_one();
+    return true;
+}
+
+/** Method: pop
+ * Usage: queue.pop(batch, maxCount)
+ * -----------------------------------------------------
+ * Waits until the queue is not empty or is closed, then moves up to maxCount submissions from the
+ * front of the queue to batch (which is cleared first).
+ * @return bool type, false once the queue is closed and empty: there will be no more submissions.
+ */
+bool SubmissionQueue::pop(vector<WordSubmission>& batch, int maxCount) {
+    batch.clear();
+    unique_lock<mutex> guard(queueLock);
+    notEmpty.wait(guard, [&] { return closed || !submissions.empty(); });
+    if (submissions.empty()) {
+        return false;
+    }
+    while (!submissions.empty() && (int) batch.size() < maxCount) {
+        batch.push_back(move(submissions.front()));
+        submissions.pop_front();
+    }
+    return true;
+}
+
+/** Method: close
+ * Usage: queue.close()
+ * -----------------------------------------------------
+ * Refuses new submissions and wakes up every consumer. Submissions already queued are still popped.
+ */
+void SubmissionQueue::close() {
+    {
+        lock_guard<mutex> guard(queueLock);
+        closed = true;
+    }
+    notEmpty.notify_all();
+}
+
+/** Method: BoggleSessionServer
+ * Usage: BoggleSessionServer server(trie, maxGames, numWorkers, minLength, recordLatencies)
+ * -----------------------------------------------------
+ * Creates a server without games and starts its worker threads. The latency of every submission is
+ * only kept when recordLatencies is true, as it takes memory for as long as the server runs.
+ * @param trie - shared_ptr<const CompactLexicon> type, words of the dictionary, shared by all games.
+ * @param maxGames - int type, largest number of games the server can host.
+ * @param numWorkers - int type, number of threads validating submissions (0 for one per hardware thread).
+ * @param minLength - int type, smallest number of letters of a word.
+ * @param recordLatencies - bool type, true to return the latency of every submission from shutdown.
+ */
+BoggleSessionServer::BoggleSessionServer(shared_ptr<const CompactLexicon> trie, int maxGames, int numWorkers,
+                                         int minLength, bool recordLatencies)
+    : trie(trie), minLength(minLength), recordLatencies(recordLatencies), games(max(maxGames, 0)), numGames(0),
+      stopped(false) {
+    if (numWorkers <= 0) {
+        numWorkers = max((int) thread::hardware_concurrency(), 1);
+    }
+    workerStats.assign(numWorkers, SessionStats{0, 0, 0, 0, vector<double>()});
+    for (int w = 0; w < numWorkers; w++) {
+        workers.push_back(thread(&BoggleSessionServer::workerLoop, this, w));
+    }
+}
+
+/** Method: ~BoggleSessionServer
+ * -----------------------------------------------------
+ * Shuts the server down if shutdown was not called.
+ */
+BoggleSessionServer::~BoggleSessionServer() {
+    if (!stopped) {
+        shutdown();
+    }
+}
+
+/** Method: createGame
+ * Usage: int game = server.createGame(boardText, numPlayers)
+ * -----------------------------------------------------
+ * Creates a game on a square board and computes its solution. Can be called while other games are
+ * being played. Throws a string exception if numPlayers is less than 1, if the server hosts
+ * maxGames games already (checked before solving the board, and again when the game is added) or
+ * if the length of boardText is not a square.
+ * @param boardText - string type, letters of the board row by row (any case, a Q being the "Qu"
+ * face of the cubes), empty for a random 4x4 board.
+ * @param numPlayers - int type, number of players of the game, numbered from 0.
+ * @return int type, number of the game.
+ */
+int BoggleSessionServer::createGame(const string& boardText, int numPlayers) {
+    if (numPlayers < 1) {
+        throw EXCEPTION_NO_PLAYERS;
+    }
+    if (numGames.load() >= (int) games.size()) {
+        throw EXCEPTION_TOO_MANY_GAMES;
+    }
+    string letters = boardText;
+    if (letters == "") {
+        lock_guard<mutex> guard(createLock);   // randomBoardLetters shuffles shared cube arrays
+        letters = randomBoardLetters(BOGGLE_SIZE, BOGGLE_SIZE);
+    }
+    int boardSize = (int) round(sqrt(letters.length()));
+    BoggleBoard board(boardSize, boardSize, boggleTiles(letters));
+    unique_ptr<GameSession> session(new GameSession());
+    session->solution = make_shared<const BoardSolution>(board, *trie, minLength);
+    session->numPlayers = numPlayers;
+    int maskWords = (session->solution->wordCount() + 63) / 64;
+    session->claimMasks.reset(new atomic<uint64_t>[maskWords]);
+    for (int i = 0; i < maskWords; i++) {
+        session->claimMasks[i].store(0);
+    }
+    session->scores.reset(new atomic<int>[session->numPlayers]);
+    for (int p = 0; p < session->numPlayers; p++) {
+        session->scores[p].store(0);
+    }
+    session->numClaimed.store(0);
+
+    lock_guard<mutex> guard(createLock);
+    int game = numGames.load();
+    if (game >= (int) games.size()) {
+        throw EXCEPTION_TOO_MANY_GAMES;
+    }
+    games[game] = move(session);
+    numGames.store(game + 1, memory_order_release);
+    return game;
+}
+
+/** Method: submit
+ * Usage: server.submit(game, player, word)
+ * -----------------------------------------------------
+ * Queues a word submitted by a player of a game; it is validated and scored by a worker thread.
+ * Can be called from any thread. Throws a string exception if the server has been shut down.
+ * @param game - int type, number of the game.
+ * @param player - int type, number of the player in the game.
+ * @param word - string type, word submitted (any case).
+ */
+void BoggleSessionServer::submit(int game, int player, const string& word) {
+    if (!queue.push(WordSubmission{game, player, word, chrono::steady_clock::now()})) {
+        throw EXCEPTION_SERVER_STOPPED;
+    }
+}
+
+/** Method: solution
+ * Usage: server.solution(game)
+ * -----------------------------------------------------
+ * Returns the solution of the board of a game. Throws a string exception if there is no such game.
+ */
+shared_ptr<const BoardSolution> BoggleSessionServer::solution(int game) const {
+    if (game < 0 || game >= numGames.load(memory_order_acquire)) {
+        throw EXCEPTION_UNKNOWN_GAME;
+    }
+    return games[game]->solution;
+}
+
+/** Method: playerScore
+ * Usage: server.playerScore(game, player)
+ * -----------------------------------------------------
+ * Returns the score of a player of a game so far. Throws a string exception if there is no such
+ * game or player.
+ */
+int BoggleSessionServer::playerScore(int game, int player) const {
+    if (game < 0 || game >= numGames.load(memory_order_acquire) || player < 0 ||
+        player >= games[game]->numPlayers) {
+        throw EXCEPTION_UNKNOWN_GAME;
+    }
+    return games[game]->scores[player].load();
+}
+
+/** Method: claimedWords
+ * Usage: server.claimedWords(game)
+ * -----------------------------------------------------
+ * Returns the number of words of the board of a game claimed so far by its players. Throws a string
+ * exception if there is no such game.
+ */
+int BoggleSessionServer::claimedWords(int game) const {
+    if (game < 0 || game >= numGames.load(memory_order_acquire)) {
+        throw EXCEPTION_UNKNOWN_GAME;
+    }
+    return games[game]->numClaimed.load();
+}
+
+/** Method: gameCount
+ * Usage: server.gameCount()
+ * -----------------------------------------------------
+ * Returns the number of games created so far.
+ */
+int BoggleSessionServer::gameCount() const {
+    return numGames.load(memory_order_acquire);
+}
+
+/** Method: shutdown
+ * Usage: SessionStats stats = server.shutdown()
+ * -----------------------------------------------------
+ * Refuses new submissions, waits until the worker threads have processed every submission already
+ * queued and stops them. Scores can still be read afterwards.
+ * @return SessionStats type, counters of all the submissions processed by the server, and their
+ * latencies in no particular order if the server records them.
+ */
+SessionStats BoggleSessionServer::shutdown() {
+    queue.close();
+    for (thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    stopped = true;
+    SessionStats total = {0, 0, 0, 0, vector<double>()};
+    for (const SessionStats& stats : workerStats) {
+        total.processed += stats.processed;
+        total.accepted += stats.accepted;
+        total.alreadyClaimed += stats.alreadyClaimed;
+        total.rejected += stats.rejected;
+        total.latencyMicros.insert(total.latencyMicros.end(), stats.latencyMicros.begin(), stats.latencyMicros.end());
+    }
+    return total;
+}
+
+/** Method: workerLoop
+ * Usage: thread(&BoggleSessionServer::workerLoop, this, worker)
+ * -----------------------------------------------------
+ * Body of every worker thread: processes batches of submissions until the queue is closed and empty.
+ */
+void BoggleSessionServer::workerLoop(int worker) {
+    // counters kept on the worker's own stack, not next to the other workers' in workerStats
+    SessionStats stats = {0, 0, 0, 0, vector<double>()};
+    vector<WordSubmission> batch;
+    while (queue.pop(batch, WORKER_BATCH)) {
+        for (const WordSubmission& submission : batch) {
+            processSubmission(submission, stats);
+        }
+    }
+    workerStats[worker] = move(stats);
+}
+
+/** Method: processSubmission
+ * Usage: processSubmission(submission, stats)
+ * -----------------------------------------------------
+ * Validates one submission against the solution of its game and, if it is the first submission of
+ * a word of the board, claims the word and adds its points to the score of the player.
+ */
+void BoggleSessionServer::processSubmission(const WordSubmission& submission, SessionStats& stats) {
+    stats.processed++;
+    int index = -1;
+    GameSession* session = NULL;
+    if (submission.game >= 0 && submission.game < numGames.load(memory_order_acquire)) {
+        session = games[submission.game].get();
+    }
+    if (session != NULL && submission.player >= 0 && submission.player < session->numPlayers) {
+        string word = submission.word;
+        for (char& letter : word) {
+            letter = toupper((unsigned char) letter);
+        }
+        index = session->solution->indexOf(word);
+    }
+    if (index == -1) {
+        stats.rejected++;
+    } else {
+        uint64_t bit = uint64_t(1) << (index & 63);
+        if (session->claimMasks[index >> 6].fetch_or(bit) & bit) {
+            stats.alreadyClaimed++;
+        } else {
+            int points = 1 + session->solution->word(index).length() - minLength;
+            session->scores[submission.player].fetch_add(points);
+            session->numClaimed.fetch_add(1);
+            stats.accepted++;
+        }
+    }
+    if (recordLatencies) {
+        stats.latencyMicros.push_back(
+                    chrono::duration<double, micro>(chrono::steady_clock::now() - submission.submitted).count());
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * File: BoggleSessionServer.h
+ * ---------------------------
+ * This file declares the BoggleSessionServer class, a headless engine hosting many Boggle games at
+ * once. Players of any game submit words from any thread; submissions go through one thread-safe
+ * queue to a pool of worker threads that validate them against the solution of the game's board
+ * (a BoardSolution computed once when the game is created, read-only afterwards) and score them.
+ * Scoring is lock-free: the first player to submit a word of the board claims it by setting its
+ * bit in the game's atomic claim mask, and gets 1 + (length - minLength) points added to an atomic
+ * score. Later submissions of the same word score nothing.
+ * The file also declares SubmissionQueue, the queue of the server, and SessionStats, the counters
+ * returned when the server shuts down.
+ */
+
+#ifndef _bogglesessionserver_h
+#define _bogglesessionserver_h
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BoardSolution.h"
+#include "CompactLexicon.h"
+using namespace std;
+
+/* One word submitted by a player of a game */
+struct WordSubmission {
+    int game;
+    int player;
+    string word;
+    chrono::steady_clock::time_point submitted;
+};
+
+/* Counters of the submissions processed by a server, and the time from submission to scoring of each
+ * when the server records latencies */
+struct SessionStats {
+    long processed;
+    long accepted;           // words of the board claimed by the player who submitted them
+    long alreadyClaimed;     // words of the board claimed before by a player of the game
+    long rejected;           // words that cannot be formed on the board, and unknown games or players
+    vector<double> latencyMicros;
+};
+
+/* Queue of submissions shared by the players (producers) and the worker threads (consumers) */
+class SubmissionQueue {
+public:
+    SubmissionQueue();
+    bool push(WordSubmission submission);
+    bool pop(vector<WordSubmission>& batch, int maxCount);
+    void close();
+
+private:
+    // instance variables
+    deque<WordSubmission> submissions;
+    bool closed;
+    mutex queueLock;
+    condition_variable notEmpty;
+};
+
+class BoggleSessionServer {
+public:
+    BoggleSessionServer(shared_ptr<const CompactLexicon> trie, int maxGames, int numWorkers, int minLength,
+                        bool recordLatencies = false);
+    ~BoggleSessionServer();
+    int createGame(const string& boardText, int numPlayers);
+    void submit(int game, int player, const string& word);
+    shared_ptr<const BoardSolution> solution(int game) const;
+    int playerScore(int game, int player) const;
+    int claimedWords(int game) const;
+    int gameCount() const;
+    SessionStats shutdown();
+
+private:
+    /* State of one game. The solution and the number of players never change; claims and scores
+     * are only changed with atomic operations by the workers. */
+    struct GameSession {
+        shared_ptr<const BoardSolution> solution;
+        int numPlayers;
+        unique_ptr<atomic<uint64_t>[]> claimMasks;   // bit w % 64 of claimMasks[w / 64] is set once word w is claimed
+        unique_ptr<atomic<int>[]> scores;            // score of every player
+        atomic<int> numClaimed;
+    };
+
+    // instance variables
+    shared_ptr<const CompactLexicon> trie;
+    int minLength;
+    bool recordLatencies;                    // keep the latency of every submission (benchmarks)
+    vector<unique_ptr<GameSession>> games;   // slots allocated up front so workers can read them without a lock
+    atomic<int> numGames;
+    mutex createLock;
+    SubmissionQueue queue;
+    vector<thread> workers;
+    vector<SessionStats> workerStats;        // set by every worker when it stops, merged by shutdown
+    bool stopped;
+    BoggleSessionServer(const BoggleSessionServer& other);
+    BoggleSessionServer& operator=(const BoggleSessionServer& other);
+    void workerLoop(int worker);
+    void processSubmission(const WordSubmission& submission, SessionStats& stats);
+};
+
+#endif // _bogglesessionserver_h
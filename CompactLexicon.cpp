@@ -0,0 +1,391 @@
+/*
+ * File: CompactLexicon.cpp
+ * ------------------------
+ * This file implements the CompactLexicon class, which includes the following methods
+ * - CompactLexicon constructor, which builds the trie of the words of a Lexicon, merges identical
+ * subtrees into a minimized DAWG and lays it out in one image in breadth first order.
+ * - CompactLexicon constructor which memory-maps a file written by save.
+ * - method to write the lexicon to a file.
+ * - methods to check whether a string is a word or a prefix of a word and to get the rank of a word.
+ * - methods returning the number of words, nodes and edges.
+ * Minimization: trie nodes are created after their parent, so visiting them from the last one
+ * created to the first visits every child before its parent. Each node gets the number of an
+ * equivalent node (same end-of-word flag, same letters leading to the same equivalent children)
+ * from a table of the nodes already seen, or becomes a new node of the DAWG.
+ * Files are written in the byte order of the machine that saves them, and loading a file with
+ * another byte order is refused.
+ */
+
+#include "CompactLexicon.h"
+#include <array>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "queue.h"
+
+/* Text for string exceptions */
+const string EXCEPTION_DAWG_OPEN = "Dictionary file could not be opened";
+const string EXCEPTION_DAWG_FORMAT = "File is not a compact dictionary or is truncated";
+const string EXCEPTION_DAWG_VERSION = "Compact dictionary version is not supported";
+const string EXCEPTION_DAWG_WRITE = "Compact dictionary could not be written";
+
+/* File identification */
+static const char DAWG_MAGIC[8] = {'W', 'O', 'R', 'D', 'D', 'A', 'W', 'G'};
+static const uint32_t DAWG_BYTE_ORDER = 0x01020304;
+
+/** Method: CompactLexicon
+ * Usage: CompactLexicon dawg(dictionary)
+ * -----------------------------------------------------
+ * Builds the minimized DAWG of every word of dictionary, in upper case. Words containing
+ * characters other than letters are skipped (they can never be formed on a board).
+ * @param dictionary - Lexicon type, words stored.
+ */
+CompactLexicon::CompactLexicon(const Lexicon& dictionary) {
+    mappedImage = NULL;
+    mappedSize = 0;
+    // trie of the words, one array of 26 children per node
+    vector<array<int, 26>> children(1);
+    children[0].fill(-1);
+    vector<bool> terminal(1, false);
+    numWords = 0;
+    for (string word : dictionary) {
+        bool lettersOnly = !word.empty();
+        for (char letter : word) {
+            lettersOnly = lettersOnly && isalpha((unsigned char) letter);
+        }
+        if (!lettersOnly) {
+            continue;
+        }
+        int node = 0;
+        for (char letter : word) {
+            int letterIndex = toupper((unsigned char) letter) - 'A';
+            if (children[node][letterIndex] == -1) {
+                children[node][letterIndex] = children.size();
+                children.push_back(array<int, 26>());
+                children.back().fill(-1);
+                terminal.push_back(false);
+            }
+            node = children[node][letterIndex];
+        }
+        if (!terminal[node]) {
+            terminal[node] = true;
+            numWords++;
+        }
+    }
+
+    // minimize: equivalent[node] is the DAWG node of every trie node, children before parents
+    vector<int> equivalent(children.size());
+    vector<uint32_t> dawgMasks;
+    vector<int> dawgChildOffsets(1, 0);   // children of DAWG node d are dawgChildren[dawgChildOffsets[d] ..]
+    vector<int> dawgChildren;
+    vector<int> dawgWordCounts;
+    unordered_map<string, int> registry;
+    string signature;
+    for (int node = children.size() - 1; node >= 0; node--) {
+        uint32_t mask = terminal[node] ? TERMINAL_BIT : 0;
+        signature.assign(1, terminal[node] ? '1' : '0');
+        for (int letterIndex = 0; letterIndex < 26; letterIndex++) {
+            int next = children[node][letterIndex];
+            if (next != -1) {
+                mask |= 1u << letterIndex;
+                int target = equivalent[next];
+                signature += (char) ('A' + letterIndex);
+                signature.append((const char*) &target, sizeof(target));
+            }
+        }
+        auto found = registry.find(signature);
+        if (found != registry.end()) {
+            equivalent[node] = found->second;
+            continue;
+        }
+        int dawgNode = dawgMasks.size();
+        registry[signature] = dawgNode;
+        equivalent[node] = dawgNode;
+        dawgMasks.push_back(mask);
+        int wordCount = terminal[node] ? 1 : 0;
+        for (int letterIndex = 0; letterIndex < 26; letterIndex++) {
+            if (children[node][letterIndex] != -1) {
+                int target = equivalent[children[node][letterIndex]];
+                dawgChildren.push_back(target);
+                wordCount += dawgWordCounts[target];
+            }
+        }
+        dawgChildOffsets.push_back(dawgChildren.size());
+        dawgWordCounts.push_back(wordCount);
+    }
+
+    // lay the DAWG out in breadth first order from the root, which gets position 0
+    int dawgRoot = equivalent[0];
+    numNodes = dawgMasks.size();
+    numEdges = dawgChildren.size();
+    ownedImage.assign((imageSizeFor(numNodes, numEdges) + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    char* image = (char*) ownedImage.data();
+    FileHeader* header = (FileHeader*) image;
+    memcpy(header->magic, DAWG_MAGIC, sizeof(DAWG_MAGIC));
+    header->version = COMPACT_LEXICON_VERSION;
+    header->byteOrder = DAWG_BYTE_ORDER;
+    header->nodeCount = numNodes;
+    header->edgeCount = numEdges;
+    header->wordCount = numWords;
+    header->imageSize = imageSizeFor(numNodes, numEdges);
+    DawgNode* outNodes = (DawgNode*) (image + sizeof(FileHeader));
+    DawgEdge* outEdges = (DawgEdge*) (outNodes + numNodes);
+    vector<int> positions(numNodes, -1);
+    Queue<int> toVisit;
+    toVisit.enqueue(dawgRoot);
+    positions[dawgRoot] = 0;
+    int nextPosition = 1;
+    int nextEdge = 0;
+    while (!toVisit.isEmpty()) {
+        int dawgNode = toVisit.dequeue();
+        DawgNode& packed = outNodes[positions[dawgNode]];
+        packed.children = dawgMasks[dawgNode];
+        packed.firstEdge = nextEdge;
+        int rank = (dawgMasks[dawgNode] & TERMINAL_BIT) ? 1 : 0;
+        for (int i = dawgChildOffsets[dawgNode]; i < dawgChildOffsets[dawgNode + 1]; i++) {
+            int target = dawgChildren[i];
+            if (positions[target] == -1) {
+                positions[target] = nextPosition++;
+                toVisit.enqueue(target);
+            }
+            outEdges[nextEdge].target = positions[target];
+            outEdges[nextEdge].rank = rank;
+            nextEdge++;
+            rank += dawgWordCounts[target];
+        }
+    }
+    attachImage(image);
+}
+
+/** Method: CompactLexicon
+ * Usage: CompactLexicon dawg(dawgFile)
+ * -----------------------------------------------------
+ * Loads a lexicon from a file written by save. The file is memory-mapped read-only, not read
+ * into memory of the process, and processes loading the same file share its pages. The nodes and
+ * edges are read once to check that every edge and child stays in the arrays and that the graph
+ * has no cycle, so a damaged file is refused instead of making searches read outside of the mapping.
+ * Throws a string exception if the file cannot be opened, is not a compact dictionary, is
+ * truncated or inconsistent, or was written with another format version or byte order.
+ * @param dawgFile - string type, name of the file.
+ */
+CompactLexicon::CompactLexicon(const string& dawgFile) {
+    mappedImage = NULL;
+    mappedSize = 0;
+    int fd = open(dawgFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw EXCEPTION_DAWG_OPEN;
+    }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < (off_t) sizeof(FileHeader)) {
+        close(fd);
+        throw EXCEPTION_DAWG_FORMAT;
+    }
+    void* image = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        throw EXCEPTION_DAWG_OPEN;
+    }
+    const FileHeader* header = (const FileHeader*) image;
+    string problem;
+    if (memcmp(header->magic, DAWG_MAGIC, sizeof(DAWG_MAGIC)) != 0 || header->byteOrder != DAWG_BYTE_ORDER) {
+        problem = EXCEPTION_DAWG_FORMAT;
+    } else if (header->version != COMPACT_LEXICON_VERSION) {
+        problem = EXCEPTION_DAWG_VERSION;
+    } else if (header->nodeCount < 1 || header->nodeCount > INT_MAX || header->edgeCount < 0 ||
+               header->edgeCount > INT_MAX || header->wordCount < 0 || header->wordCount > INT_MAX ||
+               header->imageSize != (uint64_t) fileInfo.st_size ||
+               header->imageSize != imageSizeFor(header->nodeCount, header->edgeCount)) {
+        problem = EXCEPTION_DAWG_FORMAT;
+    }
+    if (problem == "") {
+        attachImage((const char*) image);
+        if (!validImage()) {
+            problem = EXCEPTION_DAWG_FORMAT;
+        }
+    }
+    if (problem != "") {
+        munmap(image, fileInfo.st_size);
+        throw problem;
+    }
+    mappedImage = image;
+    mappedSize = fileInfo.st_size;
+}
+
+/** Method: ~CompactLexicon
+ * -----------------------------------------------------
+ * Unmaps the file, if the lexicon was loaded from one.
+ */
+CompactLexicon::~CompactLexicon() {
+    if (mappedImage != NULL) {
+        munmap(mappedImage, mappedSize);
+    }
+}
+
+/** Method: save
+ * Usage: dawg.save(dawgFile)
+ * -----------------------------------------------------
+ * Writes the lexicon to a file that can be loaded with the file constructor. Throws a string
+ * exception if the file cannot be written.
+ * @param dawgFile - string type, name of the file written.
+ */
+void CompactLexicon::save(const string& dawgFile) const {
+    ofstream out(dawgFile.c_str(), ios::binary | ios::trunc);
+    const char* image = mappedImage != NULL ? (const char*) mappedImage : (const char*) ownedImage.data();
+    out.write(image, imageSizeFor(numNodes, numEdges));
+    if (!out) {
+        throw EXCEPTION_DAWG_WRITE;
+    }
+}
+
+/** Method: contains
+ * Usage: dawg.contains(word)
+ * -----------------------------------------------------
+ * @param word - string type, word looked up (any case).
+ * @return bool type, true if word is in the lexicon.
+ */
+bool CompactLexicon::contains(const string& word) const {
+    int wordIndex = 0;
+    int node = walk(word, wordIndex);
+    return node != -1 && isWord(node);
+}
+
+/** Method: containsPrefix
+ * Usage: dawg.containsPrefix(prefix)
+ * -----------------------------------------------------
+ * @param prefix - string type, letters looked up (any case).
+ * @return bool type, true if some word of the lexicon starts with prefix.
+ */
+bool CompactLexicon::containsPrefix(const string& prefix) const {
+    int wordIndex = 0;
+    return walk(prefix, wordIndex) != -1;
+}
+
+/** Method: indexOf
+ * Usage: dawg.indexOf(word)
+ * -----------------------------------------------------
+ * @param word - string type, word looked up (any case).
+ * @return int type, rank of word in alphabetical order among the words of the lexicon (0 for the
+ * first word), -1 if word is not in the lexicon.
+ */
+int CompactLexicon::indexOf(const string& word) const {
+    int wordIndex = 0;
+    int node = walk(word, wordIndex);
+    return node != -1 && isWord(node) ? wordIndex : -1;
+}
+
+/** Method: size
+ * Usage: dawg.size()
+ * -----------------------------------------------------
+ * @return int type, number of words in the lexicon.
+ */
+int CompactLexicon::size() const {
+    return numWords;
+}
+
+/** Method: nodeCount
+ * Usage: dawg.nodeCount()
+ * -----------------------------------------------------
+ * @return int type, number of nodes of the DAWG (8 bytes each).
+ */
+int CompactLexicon::nodeCount() const {
+    return numNodes;
+}
+
+/** Method: edgeCount
+ * Usage: dawg.edgeCount()
+ * -----------------------------------------------------
+ * @return int type, number of edges of the DAWG (8 bytes each).
+ */
+int CompactLexicon::edgeCount() const {
+    return numEdges;
+}
+
+/** Method: walk
+ * Usage: int node = walk(letters, wordIndex)
+ * -----------------------------------------------------
+ * Returns the node reached from the root by following letters (any case), -1 if there is none.
+ * wordIndex is increased by the ranks of the edges followed.
+ */
+int CompactLexicon::walk(const string& letters, int& wordIndex) const {
+    int node = root();
+    for (size_t i = 0; i < letters.length() && node != -1; i++) {
+        node = child(node, toupper((unsigned char) letters[i]), wordIndex);
+    }
+    return node;
+}
+
+/** Method: attachImage
+ * Usage: attachImage(image)
+ * -----------------------------------------------------
+ * Points the node and edge arrays into image, whose header has already been checked.
+ */
+void CompactLexicon::attachImage(const char* image) {
+    const FileHeader* header = (const FileHeader*) image;
+    numNodes = header->nodeCount;
+    numEdges = header->edgeCount;
+    numWords = header->wordCount;
+    nodes = (const DawgNode*) (image + sizeof(FileHeader));
+    edges = (const DawgEdge*) (nodes + numNodes);
+}
+
+/** Method: validImage
+ * Usage: if (validImage()) ...
+ * -----------------------------------------------------
+ * Checks the nodes and edges of a lexicon attached to the image of a file: child masks only use
+ * letter bits and TERMINAL_BIT, the edges of every node are in the edge array, edges lead to nodes
+ * of the array with ranks between 0 and the number of words, and the graph has no cycle (checked
+ * by removing nodes without parents one after the other until none is left), so every walk ends.
+ * @return bool type, true if the image is consistent.
+ */
+bool CompactLexicon::validImage() const {
+    vector<int> parentCounts(numNodes, 0);
+    for (int node = 0; node < numNodes; node++) {
+        uint32_t children = nodes[node].children;
+        int numChildren = __builtin_popcount(children & LETTER_BITS);
+        if ((children & ~(LETTER_BITS | TERMINAL_BIT)) != 0 ||
+                (numChildren > 0 && (nodes[node].firstEdge < 0 || nodes[node].firstEdge > numEdges - numChildren))) {
+            return false;
+        }
+        for (int edge = nodes[node].firstEdge; edge < nodes[node].firstEdge + numChildren; edge++) {
+            if (edges[edge].target < 0 || edges[edge].target >= numNodes || edges[edge].rank < 0 ||
+                    edges[edge].rank > numWords) {
+                return false;
+            }
+            parentCounts[edges[edge].target]++;
+        }
+    }
+    vector<int> orphans;
+    for (int node = 0; node < numNodes; node++) {
+        if (parentCounts[node] == 0) {
+            orphans.push_back(node);
+        }
+    }
+    int numRemoved = 0;
+    while (!orphans.empty()) {
+        int node = orphans.back();
+        orphans.pop_back();
+        numRemoved++;
+        int numChildren = __builtin_popcount(nodes[node].children & LETTER_BITS);
+        for (int edge = nodes[node].firstEdge; edge < nodes[node].firstEdge + numChildren; edge++) {
+            if (--parentCounts[edges[edge].target] == 0) {
+                orphans.push_back(edges[edge].target);
+            }
+        }
+    }
+    return numRemoved == numNodes;
+}
+
+/** Method: imageSizeFor
+ * Usage: size_t size = imageSizeFor(numNodes, numEdges)
+ * -----------------------------------------------------
+ * Returns the number of bytes of the image (and file) of a lexicon with the given sizes.
+ */
+size_t CompactLexicon::imageSizeFor(int64_t numNodes, int64_t numEdges) {
+    return sizeof(FileHeader) + numNodes * sizeof(DawgNode) + numEdges * sizeof(DawgEdge);
+}
@@ -0,0 +1,146 @@
+/*
+ * File: CompactLexicon.h
+ * ----------------------
+ * This file declares the CompactLexicon class, a read-only dictionary stored as a minimized
+ * DAWG (directed acyclic word graph: a trie in which identical subtrees, such as common word
+ * endings, are stored once) in one array, made for searches that extend a word one letter at a
+ * time (Boggle, word ladders). Instead of asking a Lexicon whether a whole string is a word or a
+ * prefix at every step, a search keeps the node of the letters chosen so far and moves to the
+ * child of the next letter, which costs one bit test, one population count and one array read.
+ * Every word also has a number, its rank in alphabetical order, computed along the way: each
+ * edge stores how many words its letter skips, so a search can tell words apart without
+ * building strings even though nodes are shared by many words.
+ * A CompactLexicon can be saved to a binary file with save and memory-mapped back with the file
+ * constructor, without parsing; loading reads the nodes and edges once to check them.
+ * Words are stored in upper case and only contain the letters A to Z; lookups accept any case.
+ */
+
+#ifndef _compactlexicon_h
+#define _compactlexicon_h
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lexicon.h"
+using namespace std;
+
+/* Version of the file format written by save */
+const uint32_t COMPACT_LEXICON_VERSION = 1;
+
+/* Bit of a node's child mask marking the end of a word */
+const uint32_t TERMINAL_BIT = 1u << 31;
+
+/* Mask of the letter bits of a node's child mask: bit i is set if the node has a child for 'A' + i */
+const uint32_t LETTER_BITS = (1u << 26) - 1;
+
+class CompactLexicon {
+public:
+    CompactLexicon(const Lexicon& dictionary);
+    CompactLexicon(const string& dawgFile);
+    ~CompactLexicon();
+    void save(const string& dawgFile) const;
+    int root() const;
+    int child(int node, char letter) const;
+    int child(int node, char letter, int& wordIndex) const;
+    bool isWord(int node) const;
+    bool hasChildren(int node) const;
+    uint32_t childMask(int node) const;
+    bool contains(const string& word) const;
+    bool containsPrefix(const string& prefix) const;
+    int indexOf(const string& word) const;
+    int size() const;
+    int nodeCount() const;
+    int edgeCount() const;
+
+private:
+    /* One node: its child mask (letter bits and TERMINAL_BIT) and the position of the edge of its
+     * first child. The edges of the children of a node are stored next to each other in letter order. */
+    struct DawgNode {
+        uint32_t children;
+        int32_t firstEdge;
+    };
+
+    /* One edge: the child node, and the number of words that come before the words of the child in
+     * alphabetical order among the words of the parent (the parent itself if it is a word, and the
+     * words of the children of smaller letters). */
+    struct DawgEdge {
+        int32_t target;
+        int32_t rank;
+    };
+
+    /* First bytes of a saved file, followed by the nodes and the edges */
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        int64_t nodeCount;
+        int64_t edgeCount;
+        int64_t wordCount;
+        uint64_t imageSize;
+    };
+
+    // instance variables
+    const DawgNode* nodes;
+    const DawgEdge* edges;
+    int numNodes;
+    int numEdges;
+    int numWords;
+    vector<uint64_t> ownedImage;   // image of a lexicon built in memory
+    void* mappedImage;             // image of a lexicon loaded from a file
+    size_t mappedSize;
+    CompactLexicon(const CompactLexicon& other);
+    CompactLexicon& operator=(const CompactLexicon& other);
+    int edgeFor(int node, char letter) const;
+    int walk(const string& letters, int& wordIndex) const;
+    void attachImage(const char* image);
+    bool validImage() const;
+    static size_t imageSizeFor(int64_t numNodes, int64_t numEdges);
+};
+
+/*
+ * The methods below are called at every step of a board search, so they are defined here to let
+ * the compiler inline them.
+ */
+inline int CompactLexicon::root() const {
+    return 0;
+}
+
+inline int CompactLexicon::edgeFor(int node, char letter) const {
+    unsigned int letterIndex = (unsigned char) letter - 'A';
+    if (letterIndex >= 26) {
+        return -1;
+    }
+    uint32_t bit = 1u << letterIndex;
+    const DawgNode& dawgNode = nodes[node];
+    if (!(dawgNode.children & bit)) {
+        return -1;
+    }
+    return dawgNode.firstEdge + __builtin_popcount(dawgNode.children & (bit - 1));
+}
+
+inline int CompactLexicon::child(int node, char letter) const {
+    int edge = edgeFor(node, letter);
+    return edge == -1 ? -1 : edges[edge].target;
+}
+
+inline int CompactLexicon::child(int node, char letter, int& wordIndex) const {
+    int edge = edgeFor(node, letter);
+    if (edge == -1) {
+        return -1;
+    }
+    wordIndex += edges[edge].rank;
+    return edges[edge].target;
+}
+
+inline bool CompactLexicon::isWord(int node) const {
+    return nodes[node].children & TERMINAL_BIT;
+}
+
+inline bool CompactLexicon::hasChildren(int node) const {
+    return nodes[node].children & LETTER_BITS;
+}
+
+inline uint32_t CompactLexicon::childMask(int node) const {
+    return nodes[node].children & LETTER_BITS;
+}
+
+#endif // _compactlexicon_h
@@ -0,0 +1,274 @@
+/*
+ * File: DeltaStepping.cpp
+ * -----------------------
+ * This file implements delta-stepping, a parallel version of Dijkstra's algorithm.
+ * Nodes are kept in buckets of width delta by tentative cost: bucket i holds nodes whose cost is
+ * in [i * delta, (i + 1) * delta). Buckets are processed in increasing order, but all the nodes of
+ * a bucket are processed at once, in parallel. Edges are split into light edges (cost <= delta),
+ * which can put a node back in the bucket being processed, and heavy edges, which can only reach
+ * later buckets and are therefore relaxed once, after the bucket is empty.
+ * Every node is owned by one thread (node % numThreads). A thread only reads and writes the cost,
+ * predecessor and bucket entries of the nodes it owns: relaxing an edge towards another thread's
+ * node sends a request to that thread, and requests are applied by their owner after a barrier.
+ * This way no locks or atomic operations are needed on the per-node arrays.
+ */
+
+#include "DeltaStepping.h"
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+/* Text for string exceptions */
+const string EXCEPTION_BAD_DELTA_SOURCE = "Source node is not in the index";
+
+/* Cost of nodes that have not been reached */
+static const double UNREACHED = numeric_limits<double>::infinity();
+
+/* Bucket number meaning "no bucket left" */
+static const long NO_BUCKET = numeric_limits<long>::max();
+
+/* Request sent to the owner of node: node can be reached with cost distance through parent */
+struct RelaxRequest {
+    int node;
+    int parent;
+    double distance;
+};
+
+/* Barrier that makes numThreads threads wait for each other (reusable) */
+class ThreadBarrier {
+public:
+    ThreadBarrier(int numThreads) : numThreads(numThreads), waiting(0), generation(0) {}
+    void wait() {
+        unique_lock<mutex> guard(barrierLock);
+        long arrivedGeneration = generation;
+        if (++waiting == numThreads) {
+            waiting = 0;
+            generation++;
+            allArrived.notify_all();
+        } else {
+            allArrived.wait(guard, [&] { return generation != arrivedGeneration; });
+        }
+    }
+
+private:
+    int numThreads;
+    int waiting;
+    long generation;
+    mutex barrierLock;
+    condition_variable allArrived;
+};
+
+/* State shared by the threads of one deltaStepping call */
+struct DeltaSteppingState {
+    const RoadGraphIndex& index;
+    double delta;
+    int numThreads;
+    vector<double>& distance;
+    vector<int>& parent;
+    vector<long> settledInBucket;                 // last bucket in which a node was processed
+    vector<vector<vector<int>>> buckets;          // buckets[thread][bucket] = owned nodes
+    vector<vector<vector<RelaxRequest>>> outbox;  // outbox[from][to] = requests from one thread to another
+    vector<char> bucketNotEmpty;                  // per thread, set after each light phase
+    vector<long> nextBucket;                      // per thread, smallest non-empty bucket
+    ThreadBarrier barrier;
+    DeltaSteppingState(const RoadGraphIndex& index, double delta, int numThreads,
+                       vector<double>& distance, vector<int>& parent)
+        : index(index), delta(delta), numThreads(numThreads), distance(distance), parent(parent),
+          settledInBucket(index.nodeCount(), -1),
+          buckets(numThreads),
+          outbox(numThreads, vector<vector<RelaxRequest>>(numThreads)),
+          bucketNotEmpty(numThreads, 0),
+          nextBucket(numThreads, NO_BUCKET),
+          barrier(numThreads) {}
+};
+
+/* Function prototypes */
+static void deltaSteppingWorker(DeltaSteppingState& state, int thread);
+static void addToBucket(DeltaSteppingState& state, int thread, int node);
+static void applyRequests(DeltaSteppingState& state, int thread);
+static long smallestBucket(const DeltaSteppingState& state, int thread, long from);
+
+/* Function: deltaStepping()
+ * Usage: deltaStepping(index, source, delta, numThreads, distance, parent)
+ * -----------------------------------------------------------------------------
+ * Computes the cost of the shortest path from source to every node of index using numThreads
+ * threads. Returns the same costs as running Dijkstra's algorithm from source until every node is
+ * settled. With a small delta the search does as little extra work as Dijkstra's algorithm but
+ * has little parallelism; with a large delta buckets hold more nodes but nodes can be relaxed
+ * several times. suggestedDelta(index) is a reasonable default.
+ * Throws a string exception if source is not a node of index.
+ * @param: index type RoadGraphIndex - graph searched. Assumption: edge costs are not negative.
+ * @param: source type int - id of the node the paths start from.
+ * @param: delta type double - width of the buckets (<= 0 to use suggestedDelta(index)).
+ * @param: numThreads type int - number of threads used (at least 1).
+ * @param: distance type vector<double> - set to the cost of the shortest path from source to
+ * every node (infinity for nodes that cannot be reached).
+ * @param: parent type vector<int> - set to the predecessor of every node on its shortest path
+ * (-1 for source and for nodes that cannot be reached).
+ */
+void deltaStepping(const RoadGraphIndex& index, int source, double delta, int numThreads,
+                   vector<double>& distance, vector<int>& parent) {
+    if (source < 0 || source >= index.nodeCount()) {
+        throw EXCEPTION_BAD_DELTA_SOURCE;
+    }
+    if (delta <= 0) {
+        delta = suggestedDelta(index);
+    }
+    numThreads = max(numThreads, 1);
+    distance.assign(index.nodeCount(), UNREACHED);
+    parent.assign(index.nodeCount(), -1);
+    DeltaSteppingState state(index, delta, numThreads, distance, parent);
+    distance[source] = 0;
+    addToBucket(state, source % numThreads, source);
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) {
+        workers.push_back(thread(deltaSteppingWorker, ref(state), t));
+    }
+    deltaSteppingWorker(state, 0);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/* Function: suggestedDelta()
+ * Usage: suggestedDelta(index)
+ * -----------------------------------------------------------------------------
+ * Returns the average edge cost of index, a bucket width for which most road edges are light and
+ * buckets hold about one "ring" of nodes around the source.
+ */
+double suggestedDelta(const RoadGraphIndex& index) {
+    double total = 0;
+    for (int e = 0; e < index.edgeCount(); e++) {
+        total += index.edgeCost(e);
+    }
+    return index.edgeCount() == 0 || total == 0 ? 1 : total / index.edgeCount();
+}
+
+/* Function: deltaSteppingWorker()
+ * Usage: deltaSteppingWorker(state, thread)
+ * -----------------------------------------------------------------------------
+ * Body of every thread. All the threads go through the same sequence of barriers and take the
+ * same decisions (which bucket to process, whether the bucket is empty) from values published
+ * before a barrier, so they stay in step until the last bucket is processed.
+ */
+static void deltaSteppingWorker(DeltaSteppingState& state, int thread) {
+    const RoadGraphIndex& index = state.index;
+    vector<int> processed;   // nodes processed in the current bucket, for the heavy edges
+    vector<int> frontier;
+    long current = 0;
+    while (true) {
+        // agree on the next bucket to process
+        state.nextBucket[thread] = smallestBucket(state, thread, current);
+        state.barrier.wait();
+        current = NO_BUCKET;
+        for (int t = 0; t < state.numThreads; t++) {
+            current = min(current, state.nextBucket[t]);
+        }
+        if (current == NO_BUCKET) {
+            return;
+        }
+
+        // light edges, until no thread has nodes left in the bucket
+        while (true) {
+            frontier.clear();
+            if (current < (long) state.buckets[thread].size()) {
+                frontier.swap(state.buckets[thread][current]);
+            }
+            for (int node : frontier) {
+                // skip entries left behind when the node moved to an earlier bucket
+                if ((long) (state.distance[node] / state.delta) != current) {
+                    continue;
+                }
+                if (state.settledInBucket[node] != current) {
+                    state.settledInBucket[node] = current;
+                    processed.push_back(node);
+                }
+                for (int edge = index.firstEdge(node); edge < index.firstEdge(node + 1); edge++) {
+                    if (index.edgeCost(edge) <= state.delta) {
+                        int target = index.edgeTarget(edge);
+                        state.outbox[thread][target % state.numThreads].push_back(
+                                    {target, node, state.distance[node] + index.edgeCost(edge)});
+                    }
+                }
+            }
+            state.barrier.wait();
+            applyRequests(state, thread);
+            state.bucketNotEmpty[thread] = current < (long) state.buckets[thread].size() &&
+                                           !state.buckets[thread][current].empty();
+            state.barrier.wait();
+            bool anyNotEmpty = false;
+            for (int t = 0; t < state.numThreads; t++) {
+                anyNotEmpty = anyNotEmpty || state.bucketNotEmpty[t];
+            }
+            if (!anyNotEmpty) {
+                break;
+            }
+        }
+
+        // heavy edges of every node processed in the bucket
+        for (int node : processed) {
+            for (int edge = index.firstEdge(node); edge < index.firstEdge(node + 1); edge++) {
+                if (index.edgeCost(edge) > state.delta) {
+                    int target = index.edgeTarget(edge);
+                    state.outbox[thread][target % state.numThreads].push_back(
+                                {target, node, state.distance[node] + index.edgeCost(edge)});
+                }
+            }
+        }
+        processed.clear();
+        state.barrier.wait();
+        applyRequests(state, thread);
+        state.barrier.wait();
+    }
+}
+
+/* Function: addToBucket()
+ * Usage: addToBucket(state, thread, node)
+ * -----------------------------------------------------------------------------
+ * Adds node (owned by thread) to the bucket of its current cost.
+ */
+static void addToBucket(DeltaSteppingState& state, int thread, int node) {
+    long bucket = (long) (state.distance[node] / state.delta);
+    vector<vector<int>>& threadBuckets = state.buckets[thread];
+    if (bucket >= (long) threadBuckets.size()) {
+        threadBuckets.resize(bucket + 1);
+    }
+    threadBuckets[bucket].push_back(node);
+}
+
+/* Function: applyRequests()
+ * Usage: applyRequests(state, thread)
+ * -----------------------------------------------------------------------------
+ * Applies every request sent to thread since the last barrier: a request that lowers the cost of
+ * its node updates the cost and predecessor and moves the node to its new bucket.
+ */
+static void applyRequests(DeltaSteppingState& state, int thread) {
+    for (int from = 0; from < state.numThreads; from++) {
+        vector<RelaxRequest>& inbox = state.outbox[from][thread];
+        for (const RelaxRequest& request : inbox) {
+            if (request.distance < state.distance[request.node]) {
+                state.distance[request.node] = request.distance;
+                state.parent[request.node] = request.parent;
+                addToBucket(state, thread, request.node);
+            }
+        }
+        inbox.clear();
+    }
+}
+
+/* Function: smallestBucket()
+ * Usage: smallestBucket(state, thread, from)
+ * -----------------------------------------------------------------------------
+ * Returns the smallest non-empty bucket of thread numbered from or more, NO_BUCKET if none.
+ */
+static long smallestBucket(const DeltaSteppingState& state, int thread, long from) {
+    const vector<vector<int>>& threadBuckets = state.buckets[thread];
+    for (long bucket = from; bucket < (long) threadBuckets.size(); bucket++) {
+        if (!threadBuckets[bucket].empty()) {
+            return bucket;
+        }
+    }
+    return NO_BUCKET;
+}
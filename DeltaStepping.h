@@ -0,0 +1,19 @@
+/*
+ * File: DeltaStepping.h
+ * ---------------------
+ * This file declares deltaStepping, a parallel single-source shortest path search over a
+ * RoadGraphIndex that returns the cost of the shortest path from one source to every node and
+ * the predecessor of every node on its shortest path (a shortest path tree).
+ */
+
+#ifndef _deltastepping_h
+#define _deltastepping_h
+#include <vector>
+#include "RoadGraphIndex.h"
+using namespace std;
+
+void deltaStepping(const RoadGraphIndex& index, int source, double delta, int numThreads,
+                   vector<double>& distance, vector<int>& parent);
+double suggestedDelta(const RoadGraphIndex& index);
+
+#endif // _deltastepping_h
@@ -0,0 +1,353 @@
+/*
+ * File: GraphPartition.cpp
+ * ------------------------
+ * This file implements the GraphPartition class, which includes the following methods
+ * - GraphPartition constructor, which splits the nodes into cells by inertial bisection, finds
+ * the boundary nodes of every cell and builds the clique of every cell.
+ * - methods returning the cells, their sizes and the size of the overlay.
+ * - method to rebuild a clique after an edge cost changed.
+ * - method answering shortest path queries over the cells of the start and end nodes and the
+ * overlay, and unpacking the clique edges of the route found into original nodes.
+ * Inertial bisection splits a set of nodes in two halves along the axis in which their
+ * locations are the most spread out (the principal axis of the locations), so cells are compact
+ * areas of the map and few roads cross from one cell to another.
+ * Cliques are computed with one Dijkstra search per boundary node restricted to the nodes of
+ * the cell, using local ids so each search only allocates arrays of the size of the cell.
+ */
+
+#include "GraphPartition.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+/* Cost of nodes that have not been reached */
+static const double UNREACHED = numeric_limits<double>::infinity();
+
+/* Function prototypes */
+static double elapsedMillis(chrono::steady_clock::time_point since);
+
+/** Method: GraphPartition
+ * Usage: GraphPartition partition(index, maxCellSize)
+ * -----------------------------------------------------
+ * Splits the nodes of index into cells of at most maxCellSize nodes and builds the overlay.
+ * Larger cells mean fewer boundary nodes in total but more work in the cells of a query.
+ * @param: index type RoadGraphIndex - graph partitioned. The partition keeps a reference to it.
+ * @param: maxCellSize type int - largest number of nodes in a cell.
+ */
+GraphPartition::GraphPartition(const RoadGraphIndex& index, int maxCellSize) : index(index) {
+    int numNodes = index.nodeCount();
+    cellNodes.resize(numNodes);
+    for (int node = 0; node < numNodes; node++) {
+        cellNodes[node] = node;
+    }
+    cellOffsets.push_back(0);
+    if (numNodes > 0) {
+        bisect(0, numNodes, max(maxCellSize, 1));
+    }
+    nodeCells.resize(numNodes);
+    localIds.resize(numNodes);
+    for (int cell = 0; cell < cellCount(); cell++) {
+        for (int i = cellOffsets[cell]; i < cellOffsets[cell + 1]; i++) {
+            nodeCells[cellNodes[i]] = cell;
+            localIds[cellNodes[i]] = i - cellOffsets[cell];
+        }
+    }
+
+    // boundary nodes: both ends of every edge between two cells
+    vector<bool> isBoundary(numNodes, false);
+    for (int edge = 0; edge < index.edgeCount(); edge++) {
+        int source = index.edgeSource(edge);
+        int target = index.edgeTarget(edge);
+        if (nodeCells[source] != nodeCells[target]) {
+            isBoundary[source] = true;
+            isBoundary[target] = true;
+        }
+    }
+    boundaryIds.assign(numNodes, -1);
+    boundaryOffsets.push_back(0);
+    cliqueOffsets.push_back(0);
+    for (int cell = 0; cell < cellCount(); cell++) {
+        for (int i = cellOffsets[cell]; i < cellOffsets[cell + 1]; i++) {
+            if (isBoundary[cellNodes[i]]) {
+                boundaryIds[cellNodes[i]] = boundaryNodes.size() - boundaryOffsets[cell];
+                boundaryNodes.push_back(cellNodes[i]);
+            }
+        }
+        boundaryOffsets.push_back(boundaryNodes.size());
+        long count = boundaryCount(cell);
+        cliqueOffsets.push_back(cliqueOffsets[cell] + count * count);
+    }
+    cliqueCosts.resize(cliqueOffsets[cellCount()]);
+    for (int cell = 0; cell < cellCount(); cell++) {
+        buildClique(cell);
+    }
+}
+
+/** Method: cellCount
+ * Usage: int count = partition.cellCount()
+ * -----------------------------------------------------
+ * @return int type, number of cells.
+ */
+int GraphPartition::cellCount() const {
+    return cellOffsets.size() - 1;
+}
+
+/** Method: cellOf
+ * Usage: int cell = partition.cellOf(node)
+ * -----------------------------------------------------
+ * @return int type, cell of the node with id node.
+ */
+int GraphPartition::cellOf(int node) const {
+    return nodeCells[node];
+}
+
+/** Method: cellSize
+ * Usage: int size = partition.cellSize(cell)
+ * -----------------------------------------------------
+ * @return int type, number of nodes of cell.
+ */
+int GraphPartition::cellSize(int cell) const {
+    return cellOffsets[cell + 1] - cellOffsets[cell];
+}
+
+/** Method: boundaryCount
+ * Usage: int count = partition.boundaryCount(cell)
+ * -----------------------------------------------------
+ * @return int type, number of boundary nodes of cell.
+ */
+int GraphPartition::boundaryCount(int cell) const {
+    return boundaryOffsets[cell + 1] - boundaryOffsets[cell];
+}
+
+/** Method: overlayEdgeCount
+ * Usage: long count = partition.overlayEdgeCount()
+ * -----------------------------------------------------
+ * @return long type, number of edges of the overlay: clique edges and edges between cells.
+ */
+long GraphPartition::overlayEdgeCount() const {
+    long count = 0;
+    for (int cell = 0; cell < cellCount(); cell++) {
+        count += (long) boundaryCount(cell) * (boundaryCount(cell) - 1);
+    }
+    for (int edge = 0; edge < index.edgeCount(); edge++) {
+        if (nodeCells[index.edgeSource(edge)] != nodeCells[index.edgeTarget(edge)]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/** Method: edgeCostChanged
+ * Usage: partition.edgeCostChanged(edge)
+ * -----------------------------------------------------
+ * Updates the overlay after the cost of edge was changed in the index (setEdgeCost). Only the
+ * clique of the cell containing edge is rebuilt; edges between cells are read from the index
+ * by the queries and need no update.
+ * @param: edge type int - id of the edge whose cost changed.
+ */
+void GraphPartition::edgeCostChanged(int edge) {
+    int cell = nodeCells[index.edgeSource(edge)];
+    if (cell == nodeCells[index.edgeTarget(edge)]) {
+        buildClique(cell);
+    }
+}
+
+/** Method: shortestPath
+ * Usage: Vector<int> path = partition.shortestPath(start, end, cost, stats)
+ * -----------------------------------------------------
+ * Returns the same shortest paths as dijkstrasAlgorithm(index, start, end). Dijkstra's algorithm
+ * runs over the original edges of the nodes in the cells of start and end, and over the overlay
+ * for the nodes of every other cell: from a boundary node, the search follows the clique of its
+ * cell and the edges leaving the cell. Any path through another cell enters and leaves it at
+ * boundary nodes, and the clique holds the cheapest way between them, so no route is missed.
+ * Clique edges of the route found are unpacked into the nodes they stand for with a search
+ * inside their cell. The counters of the search are recorded in searchStatsRegistry() under
+ * "overlay-dijkstra".
+ * @param: start type int, id of the starting vertex.
+ * @param: end type int, id of the ending vertex.
+ * @param: cost type double - set to the cost of the path returned (if path exists).
+ * @param: stats type SearchStats - set to the counters of the search.
+ * @return: Vector<int> type, ids of the nodes along the path found, empty if no path was found.
+ */
+Vector<int> GraphPartition::shortestPath(int start, int end, double &cost, SearchStats &stats) const {
+    stats = SearchStats();
+    auto startTime = chrono::steady_clock::now();
+    Vector<int> pathFound;
+    int startCell = nodeCells[start];
+    int endCell = nodeCells[end];
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queueofNodes;
+    vector<double> bestCost(index.nodeCount(), UNREACHED);
+    vector<int> previous(index.nodeCount(), -1);
+    vector<bool> viaClique(index.nodeCount(), false);
+    vector<bool> visitedPoints(index.nodeCount(), false);
+    bestCost[start] = 0;
+    queueofNodes.push(QueueEntry(0, start));
+    stats.heapPushes++;
+    stats.maxFrontier = 1;
+    while (!queueofNodes.empty()) {
+        int lastnode = queueofNodes.top().second;
+        queueofNodes.pop();
+        stats.heapPops++;
+        if (visitedPoints[lastnode]) {
+            stats.duplicatePops++;
+            continue;
+        }
+        visitedPoints[lastnode] = true;
+        stats.nodesSettled++;
+        if (lastnode == end) {
+            break;
+        }
+        int cell = nodeCells[lastnode];
+        bool searchedCell = cell == startCell || cell == endCell;
+        for (int edge = index.firstEdge(lastnode); edge < index.firstEdge(lastnode + 1); edge++) {
+            int node = index.edgeTarget(edge);
+            double newCost = bestCost[lastnode] + index.edgeCost(edge);
+            if ((searchedCell || nodeCells[node] != cell) && !visitedPoints[node] && newCost < bestCost[node]) {
+                bestCost[node] = newCost;
+                previous[node] = lastnode;
+                viaClique[node] = false;
+                queueofNodes.push(QueueEntry(newCost, node));
+                stats.edgesRelaxed++;
+                stats.heapPushes++;
+            }
+        }
+        if (!searchedCell) {
+            // lastnode is a boundary node of a cell that is not searched: follow its clique
+            int count = boundaryCount(cell);
+            const double* costs = &cliqueCosts[cliqueOffsets[cell] + (long) boundaryIds[lastnode] * count];
+            for (int j = 0; j < count; j++) {
+                int node = boundaryNodes[boundaryOffsets[cell] + j];
+                double newCost = bestCost[lastnode] + costs[j];
+                if (!visitedPoints[node] && newCost < bestCost[node]) {
+                    bestCost[node] = newCost;
+                    previous[node] = lastnode;
+                    viaClique[node] = true;
+                    queueofNodes.push(QueueEntry(newCost, node));
+                    stats.edgesRelaxed++;
+                    stats.heapPushes++;
+                }
+            }
+        }
+        stats.maxFrontier = max(stats.maxFrontier, (long) queueofNodes.size());
+    }
+    if (visitedPoints[end]) {
+        cost = bestCost[end];
+        vector<double> distance;
+        vector<int> inCell;
+        for (int node = end; node != -1; node = previous[node]) {
+            pathFound.add(node);
+            if (viaClique[node]) {
+                // add the nodes between previous[node] and node, found again inside their cell
+                cellDijkstra(nodeCells[node], previous[node], distance, inCell);
+                for (int inner = inCell[localIds[node]]; inner != previous[node]; inner = inCell[localIds[inner]]) {
+                    pathFound.add(inner);
+                }
+            }
+        }
+        reverse(pathFound.begin(), pathFound.end());
+    }
+    stats.wallTimeMs = elapsedMillis(startTime);
+    searchStatsRegistry().record("overlay-dijkstra", stats);
+    return pathFound;
+}
+
+/** Method: bisect
+ * Usage: bisect(first, last, maxCellSize)
+ * -----------------------------------------------------
+ * Splits the nodes cellNodes[first .. last) into cells of at most maxCellSize nodes, appended to
+ * cellOffsets in order: the nodes are projected on the principal axis of their locations, the
+ * lower half is moved before the upper half, and both halves are split again.
+ */
+void GraphPartition::bisect(int first, int last, int maxCellSize) {
+    if (last - first <= maxCellSize) {
+        cellOffsets.push_back(last);
+        return;
+    }
+    double meanX = 0, meanY = 0;
+    for (int i = first; i < last; i++) {
+        meanX += index.nodeX(cellNodes[i]);
+        meanY += index.nodeY(cellNodes[i]);
+    }
+    meanX /= last - first;
+    meanY /= last - first;
+    double varianceX = 0, varianceY = 0, covariance = 0;
+    for (int i = first; i < last; i++) {
+        double dx = index.nodeX(cellNodes[i]) - meanX;
+        double dy = index.nodeY(cellNodes[i]) - meanY;
+        varianceX += dx * dx;
+        varianceY += dy * dy;
+        covariance += dx * dy;
+    }
+    double angle = 0.5 * atan2(2 * covariance, varianceX - varianceY);
+    double axisX = cos(angle);
+    double axisY = sin(angle);
+    int middle = first + (last - first) / 2;
+    nth_element(cellNodes.begin() + first, cellNodes.begin() + middle, cellNodes.begin() + last,
+                [&](int a, int b) {
+        return index.nodeX(a) * axisX + index.nodeY(a) * axisY < index.nodeX(b) * axisX + index.nodeY(b) * axisY;
+    });
+    bisect(first, middle, maxCellSize);
+    bisect(middle, last, maxCellSize);
+}
+
+/** Method: buildClique
+ * Usage: buildClique(cell)
+ * -----------------------------------------------------
+ * Computes the cost of the shortest path inside cell from every boundary node of cell to every
+ * other one (infinity if there is none).
+ */
+void GraphPartition::buildClique(int cell) {
+    int count = boundaryCount(cell);
+    vector<double> distance;
+    vector<int> previous;
+    for (int i = 0; i < count; i++) {
+        cellDijkstra(cell, boundaryNodes[boundaryOffsets[cell] + i], distance, previous);
+        for (int j = 0; j < count; j++) {
+            cliqueCosts[cliqueOffsets[cell] + (long) i * count + j] =
+                    distance[localIds[boundaryNodes[boundaryOffsets[cell] + j]]];
+        }
+    }
+}
+
+/** Method: cellDijkstra
+ * Usage: cellDijkstra(cell, source, distance, previous)
+ * -----------------------------------------------------
+ * Dijkstra's algorithm from source using only the nodes and edges of cell. distance and previous
+ * are indexed by local id: distance is set to the cost from source to every node of the cell and
+ * previous to the id (not local id) of its predecessor, -1 if it has none.
+ */
+void GraphPartition::cellDijkstra(int cell, int source, vector<double>& distance, vector<int>& previous) const {
+    distance.assign(cellSize(cell), UNREACHED);
+    previous.assign(cellSize(cell), -1);
+    vector<bool> visitedPoints(cellSize(cell), false);
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queueofNodes;
+    distance[localIds[source]] = 0;
+    queueofNodes.push(QueueEntry(0, source));
+    while (!queueofNodes.empty()) {
+        int lastnode = queueofNodes.top().second;
+        queueofNodes.pop();
+        if (visitedPoints[localIds[lastnode]]) {
+            continue;
+        }
+        visitedPoints[localIds[lastnode]] = true;
+        double lastCost = distance[localIds[lastnode]];
+        for (int edge = index.firstEdge(lastnode); edge < index.firstEdge(lastnode + 1); edge++) {
+            int node = index.edgeTarget(edge);
+            if (nodeCells[node] == cell && lastCost + index.edgeCost(edge) < distance[localIds[node]]) {
+                distance[localIds[node]] = lastCost + index.edgeCost(edge);
+                previous[localIds[node]] = lastnode;
+                queueofNodes.push(QueueEntry(distance[localIds[node]], node));
+            }
+        }
+    }
+}
+
+/* Returns the number of milliseconds elapsed since the given time point */
+static double elapsedMillis(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
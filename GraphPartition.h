@@ -0,0 +1,52 @@
+/*
+ * File: GraphPartition.h
+ * ----------------------
+ * This file declares the GraphPartition class, which splits the nodes of a RoadGraphIndex into
+ * cells of nearby nodes and precomputes an overlay graph over the boundary nodes of the cells
+ * (nodes with an edge to or from another cell). Inside every cell, the cost of the shortest path
+ * between each pair of its boundary nodes is stored (a clique per cell). A query only searches
+ * the original edges of the cells of its start and end nodes; everywhere else it moves from
+ * boundary node to boundary node over the cliques and the edges between cells, so it touches a
+ * small part of the graph.
+ */
+
+#ifndef _graphpartition_h
+#define _graphpartition_h
+#include <vector>
+#include "RoadGraphIndex.h"
+#include "RoutingStats.h"
+#include "vector.h"
+using namespace std;
+
+/* Default largest number of nodes in a cell */
+const int DEFAULT_MAX_CELL_SIZE = 1024;
+
+class GraphPartition {
+public:
+    GraphPartition(const RoadGraphIndex& index, int maxCellSize = DEFAULT_MAX_CELL_SIZE);
+    int cellCount() const;
+    int cellOf(int node) const;
+    int cellSize(int cell) const;
+    int boundaryCount(int cell) const;
+    long overlayEdgeCount() const;
+    void edgeCostChanged(int edge);
+    Vector<int> shortestPath(int start, int end, double &cost, SearchStats &stats) const;
+
+private:
+    // instance variables
+    const RoadGraphIndex& index;
+    vector<int> nodeCells;          // cell of every node
+    vector<int> cellOffsets;        // nodes of cell c are cellNodes[cellOffsets[c] .. cellOffsets[c + 1])
+    vector<int> cellNodes;
+    vector<int> localIds;           // position of every node in the node list of its cell
+    vector<int> boundaryOffsets;    // boundary nodes of cell c are boundaryNodes[boundaryOffsets[c] .. boundaryOffsets[c + 1])
+    vector<int> boundaryNodes;
+    vector<int> boundaryIds;        // position of a node among the boundary nodes of its cell, -1 if not a boundary node
+    vector<long> cliqueOffsets;     // clique of cell c starts at cliqueCosts[cliqueOffsets[c]], boundaryCount(c)^2 costs
+    vector<double> cliqueCosts;     // cost from the i-th to the j-th boundary node of a cell at offset + i * count + j
+    void bisect(int first, int last, int maxCellSize);
+    void buildClique(int cell);
+    void cellDijkstra(int cell, int source, vector<double>& distance, vector<int>& previous) const;
+};
+
+#endif // _graphpartition_h
@@ -0,0 +1,198 @@
+/*
+ * File: IncrementalPlanner.cpp
+ * ----------------------------
+ * This file implements the IncrementalPlanner class (Lifelong Planning A*), which includes the
+ * following methods
+ * - IncrementalPlanner constructor
+ * - method to return the shortest path between start and goal, repairing the search if edge
+ * costs changed since the previous query.
+ * - method to change the cost of an edge and mark the node it leads to for repair.
+ * Every node has two cost estimates: g, the cost of the best path found so far, and rhs, the best
+ * cost reachable in one step from the g values of its predecessors. A node is consistent when
+ * both are equal. The queue only holds inconsistent nodes, ordered like in A*, and the search
+ * stops once the goal is consistent and no queued node could improve it. After an edge cost
+ * change only the node the edge leads to becomes inconsistent, so the next query only expands
+ * the nodes whose cost really changed.
+ * Assumption: edge costs never go below the travel time at the maximum road speed (the heuristic
+ * must stay a lower bound).
+ */
+
+#include "IncrementalPlanner.h"
+#include <algorithm>
+#include <limits>
+
+/* Cost of nodes that have not been reached */
+static const double INFINITE_COST = numeric_limits<double>::infinity();
+
+/** Method: IncrementalPlanner
+ * Usage: IncrementalPlanner planner(index, start, goal)
+ * -----------------------------------------------------
+ * Instantiates a planner for paths from start to goal in index. No search is run until plan()
+ * is called. The index is kept by reference: edge costs must be changed through
+ * updateEdgeCost so the planner knows which nodes to repair.
+ * @param index - RoadGraphIndex type, graph searched.
+ * @param start - int type, id of the starting node.
+ * @param goal - int type, id of the destination node.
+ */
+IncrementalPlanner::IncrementalPlanner(RoadGraphIndex& index, int start, int goal) : index(index) {
+    this->start = start;
+    this->goal = goal;
+    g.assign(index.nodeCount(), INFINITE_COST);
+    rhs.assign(index.nodeCount(), INFINITE_COST);
+    rhs[start] = 0;
+    openQueue.push({calculateKey(start), start});
+    expansions = 0;
+}
+
+/** Method: plan
+ * Usage: planner.plan(cost)
+ * -----------------------------------------------------
+ * Returns the shortest path from start to goal as a list of node ids, start first and goal last,
+ * or an empty path if goal cannot be reached (or if the walk back from goal does not reach
+ * start). The first call does the same work as A*, later calls only repair the search after
+ * edge cost changes.
+ * @param cost - double type, set to the cost of the path returned (if path exists).
+ * @return Vector<int> type, node ids along the shortest path.
+ */
+Vector<int> IncrementalPlanner::plan(double& cost) {
+    expansions = 0;
+    computeShortestPath();
+    Vector<int> path;
+    if (g[goal] == INFINITE_COST) {
+        return path;
+    }
+    cost = g[goal];
+    // walk back from the goal, each time to the predecessor the node's cost came from
+    int node = goal;
+    path.add(node);
+    while (node != start && path.size() <= index.nodeCount()) {
+        int bestPredecessor = -1;
+        double bestCost = INFINITE_COST;
+        for (int slot = index.firstIncoming(node); slot < index.firstIncoming(node + 1); slot++) {
+            int edge = index.incomingEdge(slot);
+            double candidate = g[index.edgeSource(edge)] + index.edgeCost(edge);
+            if (candidate < bestCost) {
+                bestCost = candidate;
+                bestPredecessor = index.edgeSource(edge);
+            }
+        }
+        if (bestPredecessor == -1) {
+            // no incoming edge leads back towards start: the costs are not consistent
+            return Vector<int>();
+        }
+        node = bestPredecessor;
+        path.add(node);
+    }
+    if (node != start) {
+        return Vector<int>();
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+/** Method: updateEdgeCost
+ * Usage: planner.updateEdgeCost(edge, cost)
+ * -----------------------------------------------------
+ * Changes the cost of edge in the index and marks the node the edge leads to for repair. The
+ * search itself is repaired lazily, on the next call to plan().
+ * @param edge - int type, id of the edge in the index.
+ * @param cost - double type, new cost of the edge.
+ */
+void IncrementalPlanner::updateEdgeCost(int edge, double cost) {
+    index.setEdgeCost(edge, cost);
+    updateNode(index.edgeTarget(edge));
+}
+
+/** Method: getExpansions
+ * Usage: planner.getExpansions()
+ * -----------------------------------------------------
+ * @return int type, number of nodes taken out of the queue during the last call to plan().
+ */
+int IncrementalPlanner::getExpansions() const {
+    return expansions;
+}
+
+/** Method: calculateKey
+ * Usage: calculateKey(node)
+ * -----------------------------------------------------
+ * Returns the queue priority of node: the A* priority of its best cost estimate, with ties
+ * broken by the estimate itself.
+ */
+IncrementalPlanner::PlannerKey IncrementalPlanner::calculateKey(int node) const {
+    double best = min(g[node], rhs[node]);
+    return {best + index.heuristic(node, goal), best};
+}
+
+/** Method: updateNode
+ * Usage: updateNode(node)
+ * -----------------------------------------------------
+ * Recomputes rhs of node from its predecessors and queues node if it became inconsistent.
+ */
+void IncrementalPlanner::updateNode(int node) {
+    if (node != start) {
+        double best = INFINITE_COST;
+        for (int slot = index.firstIncoming(node); slot < index.firstIncoming(node + 1); slot++) {
+            int edge = index.incomingEdge(slot);
+            best = min(best, g[index.edgeSource(edge)] + index.edgeCost(edge));
+        }
+        rhs[node] = best;
+    }
+    if (g[node] != rhs[node]) {
+        openQueue.push({calculateKey(node), node});
+    }
+}
+
+/** Method: topKey
+ * Usage: topKey(key)
+ * -----------------------------------------------------
+ * Drops outdated entries from the top of the queue (nodes that became consistent or whose key
+ * changed since they were queued) and stores the key of the first valid entry in key.
+ * Returns false if the queue has no valid entry left.
+ */
+bool IncrementalPlanner::topKey(PlannerKey& key) {
+    while (!openQueue.empty()) {
+        const QueueEntry& top = openQueue.top();
+        PlannerKey current = calculateKey(top.node);
+        if (g[top.node] != rhs[top.node] && !(top.key < current) && !(current < top.key)) {
+            key = top.key;
+            return true;
+        }
+        openQueue.pop();
+    }
+    return false;
+}
+
+/** Method: computeShortestPath
+ * Usage: computeShortestPath()
+ * -----------------------------------------------------
+ * Expands inconsistent nodes in priority order until the goal is consistent and its key is not
+ * larger than any queued key. An over-consistent node (g > rhs) found a cheaper path: its g is
+ * lowered and its successors are updated. An under-consistent node (g < rhs) lost its path: its
+ * g is reset to infinity and it is updated together with its successors.
+ */
+void IncrementalPlanner::computeShortestPath() {
+    PlannerKey key;
+    while (topKey(key) && (key < calculateKey(goal) || g[goal] != rhs[goal])) {
+        int node = openQueue.top().node;
+        openQueue.pop();
+        expansions++;
+        if (g[node] > rhs[node]) {
+            g[node] = rhs[node];
+        } else {
+            g[node] = INFINITE_COST;
+            updateNode(node);
+        }
+        for (int edge = index.firstEdge(node); edge < index.firstEdge(node + 1); edge++) {
+            updateNode(index.edgeTarget(edge));
+        }
+    }
+}
+
+/* Key and queue entry comparisons */
+bool IncrementalPlanner::PlannerKey::operator<(const PlannerKey& other) const {
+    return first < other.first || (first == other.first && second < other.second);
+}
+
+bool IncrementalPlanner::QueueEntry::operator>(const QueueEntry& other) const {
+    return other.key < key;
+}
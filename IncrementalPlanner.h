@@ -0,0 +1,55 @@
+/*
+ * File: IncrementalPlanner.h
+ * --------------------------
+ * This file declares the IncrementalPlanner class, an implementation of Lifelong Planning A*
+ * (LPA*) over a RoadGraphIndex. The planner answers repeated shortest path queries between a
+ * fixed start and goal. It keeps its search state between queries, so when edge costs change
+ * only the part of the search affected by the change is repaired, instead of re-running A*
+ * from scratch.
+ */
+
+#ifndef _incrementalplanner_h
+#define _incrementalplanner_h
+#include <queue>
+#include <vector>
+#include "RoadGraphIndex.h"
+#include "vector.h"
+using namespace std;
+
+class IncrementalPlanner {
+public:
+    IncrementalPlanner(RoadGraphIndex& index, int start, int goal);
+    Vector<int> plan(double& cost);
+    void updateEdgeCost(int edge, double cost);
+    int getExpansions() const;
+
+private:
+    /* Priority of a node in the LPA* queue, compared lexicographically */
+    struct PlannerKey {
+        double first;
+        double second;
+        bool operator<(const PlannerKey& other) const;
+    };
+    /* Queue entry. Entries are never removed from the middle of the queue: an entry whose key
+     * no longer matches the node's key is skipped when it reaches the top. */
+    struct QueueEntry {
+        PlannerKey key;
+        int node;
+        bool operator>(const QueueEntry& other) const;
+    };
+
+    // instance variables
+    RoadGraphIndex& index;
+    int start;
+    int goal;
+    vector<double> g;     // cost of the best path found so far
+    vector<double> rhs;   // one-step lookahead cost, based on the g values of predecessors
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> openQueue;
+    int expansions;
+    PlannerKey calculateKey(int node) const;
+    void updateNode(int node);
+    bool topKey(PlannerKey& key);
+    void computeShortestPath();
+};
+
+#endif // _incrementalplanner_h
@@ -0,0 +1,367 @@
+/*
+ * File: LetterHistogramIndex.cpp
+ * ------------------------------
+ * This file implements the LetterHistogramIndex class, which includes the following methods
+ * - LetterHistogramIndex constructor, which lists the words of a CompactLexicon with their letter
+ * masks and counts.
+ * - methods to find the words of a board by checking every word of the dictionary.
+ * - methods to choose between the dictionary scan and the board search for a board size, and to
+ * find the words of a board the faster way.
+ * The scan reads the mask of every word starting with a letter of the board, compares the counts
+ * of the words whose mask passes, then checks that every pair of consecutive letters of the word
+ * is held by two neighboring cells, or by one tile, somewhere on the board (a 26x26 table computed
+ * per board), and only looks for a path for the words that pass all three checks.
+ * Both ways give the same words, so timing them to choose one only changes how fast boards are
+ * solved, never the results.
+ */
+
+#include "LetterHistogramIndex.h"
+#include <algorithm>
+#include <chrono>
+
+/* Boards of every size solved both ways to choose the faster way for that size */
+static const int CALIBRATION_BOARDS = 8;
+
+/* Function prototypes */
+static void boardCounts(const BoggleBoard& board, uint8_t counts[HISTOGRAM_SLOTS], uint32_t& mask);
+static void markPair(vector<bool>& adjacentPairs, char first, char second);
+
+/** Method: LetterHistogramIndex
+ * Usage: LetterHistogramIndex histograms(trie, minLength)
+ * -----------------------------------------------------
+ * Lists every word of trie with at least minLength letters, in alphabetical order, and computes
+ * its letter mask and counts. The trie is kept to time the board search in prefersScan.
+ * @param trie - shared_ptr<const CompactLexicon> type, words of the dictionary.
+ * @param minLength - int type, smallest number of letters of a word.
+ */
+LetterHistogramIndex::LetterHistogramIndex(shared_ptr<const CompactLexicon> trie, int minLength) {
+    this->trie = trie;
+    minWordLength = minLength;
+    numDecided = 0;
+    wordOffsets.push_back(0);
+    // depth-first walk of the trie in letter order, with an explicit stack of (node, next letter)
+    vector<pair<int, int>> stack;
+    string word;
+    stack.push_back(make_pair(trie->root(), 0));
+    while (!stack.empty()) {
+        int node = stack.back().first;
+        int letterIndex = stack.back().second;
+        if (letterIndex == 0 && trie->isWord(node) && (int) word.length() >= minLength) {
+            letters.insert(letters.end(), word.begin(), word.end());
+            wordOffsets.push_back(letters.size());
+        }
+        uint32_t children = trie->childMask(node) >> letterIndex;
+        if (children == 0) {
+            stack.pop_back();
+            if (!word.empty()) {
+                word.pop_back();
+            }
+            continue;
+        }
+        letterIndex += __builtin_ctz(children);
+        stack.back().second = letterIndex + 1;
+        word += (char) ('A' + letterIndex);
+        stack.push_back(make_pair(trie->child(node, 'A' + letterIndex), 0));
+    }
+
+    int numWords = wordCount();
+    letterMasks.assign(numWords, 0);
+    histograms.assign((size_t) numWords * HISTOGRAM_SLOTS, 0);
+    fill(firstWithLetter, firstWithLetter + 27, numWords);
+    for (int i = numWords - 1; i >= 0; i--) {
+        uint8_t* counts = &histograms[(size_t) i * HISTOGRAM_SLOTS];
+        for (int position = wordOffsets[i]; position < wordOffsets[i + 1]; position++) {
+            int letterIndex = letters[position] - 'A';
+            letterMasks[i] |= 1u << letterIndex;
+            if (counts[letterIndex] < 255) {
+                counts[letterIndex]++;
+            }
+        }
+        firstWithLetter[letters[wordOffsets[i]] - 'A'] = i;
+    }
+    for (int l = 25; l >= 0; l--) {
+        firstWithLetter[l] = min(firstWithLetter[l], firstWithLetter[l + 1]);
+    }
+}
+
+/** Method: wordCount
+ * Usage: histograms.wordCount()
+ * -----------------------------------------------------
+ * @return int type, number of words of the index (words of the dictionary with at least minLength letters).
+ */
+int LetterHistogramIndex::wordCount() const {
+    return wordOffsets.size() - 1;
+}
+
+/** Method: minLength
+ * Usage: histograms.minLength()
+ * -----------------------------------------------------
+ * @return int type, smallest number of letters of the words of the index.
+ */
+int LetterHistogramIndex::minLength() const {
+    return minWordLength;
+}
+
+/** Method: dictionary
+ * Usage: histograms.dictionary()
+ * -----------------------------------------------------
+ * @return shared_ptr<const CompactLexicon> type, trie of the words of the index.
+ */
+shared_ptr<const CompactLexicon> LetterHistogramIndex::dictionary() const {
+    return trie;
+}
+
+/** Method: findWords
+ * Usage: histograms.findWords(board, words, pathCells, pathEnds)
+ * -----------------------------------------------------
+ * Appends to words every word of the index that can be formed on board, in alphabetical order,
+ * to pathCells the cells of one path forming each, one cell per tile, and to pathEnds the size of
+ * pathCells after every path (the same results as BoggleBoard::findWords, in another order).
+ * @param board - BoggleBoard type, board searched.
+ * @param words - vector<string> type, words found are appended to it.
+ * @param pathCells - vector<int> type, cells of the words found are appended to it.
+ * @param pathEnds - vector<int> type, end of the path of every word found in pathCells is appended to it.
+ */
+void LetterHistogramIndex::findWords(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                                     vector<int>& pathEnds) const {
+    WordSearchStats stats = {0, 0};
+    scanWords(board, words, pathCells, pathEnds, stats);
+}
+
+/** Method: findWords
+ * Usage: histograms.findWords(board, words, pathCells, pathEnds, stats)
+ * -----------------------------------------------------
+ * Same as findWords(board, words, pathCells, pathEnds), also returning the number of candidates looked for
+ * on the board (stats.pathsExtended) and of words of the dictionary checked (stats.trieProbes).
+ * @param stats - WordSearchStats type, set to the counters of the scan.
+ */
+void LetterHistogramIndex::findWords(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                                     vector<int>& pathEnds, WordSearchStats& stats) const {
+    stats = {0, 0};
+    scanWords(board, words, pathCells, pathEnds, stats);
+}
+
+/** Method: findWordsFastest
+ * Usage: histograms.findWordsFastest(board, words, pathCells, pathEnds)
+ * -----------------------------------------------------
+ * Same as findWords(board, words, pathCells, pathEnds), with the dictionary scan or the board search,
+ * whichever prefersScan says is faster for the size of board. The words of the first
+ * CALIBRATION_BOARDS boards of every size are the ones found while timing both ways, so those boards
+ * are not solved a third time. Can be called from several threads.
+ * @param board - BoggleBoard type, board searched.
+ * @param words - vector<string> type, words found are appended to it.
+ * @param pathCells - vector<int> type, cells of the words found are appended to it.
+ * @param pathEnds - vector<int> type, end of the path of every word found in pathCells is appended to it.
+ */
+void LetterHistogramIndex::findWordsFastest(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                                            vector<int>& pathEnds) const {
+    int decision = decidedStrategy(board);
+    if (decision == -1) {
+        calibrate(board, words, pathCells, pathEnds);
+    } else if (decision == 1) {
+        findWords(board, words, pathCells, pathEnds);
+    } else {
+        board.findWords(*trie, minWordLength, words, pathCells, pathEnds);
+    }
+}
+
+/** Method: prefersScan
+ * Usage: if (histograms.prefersScan(board)) ...
+ * -----------------------------------------------------
+ * Returns true if the dictionary scan is expected to find the words of board faster than the
+ * board search. The first CALIBRATION_BOARDS boards of every size are solved both ways and timed
+ * (the answer for them is the faster way so far); the choice is then published for that size and
+ * read without locking. Can be called from several threads.
+ * @param board - BoggleBoard type, board about to be solved.
+ * @return bool type, true if the dictionary scan should be used.
+ */
+bool LetterHistogramIndex::prefersScan(const BoggleBoard& board) const {
+    int decision = decidedStrategy(board);
+    if (decision != -1) {
+        return decision == 1;
+    }
+    vector<string> words;
+    vector<int> pathCells;
+    vector<int> pathEnds;
+    return calibrate(board, words, pathCells, pathEnds);
+}
+
+/** Method: decidedStrategy
+ * Usage: int decision = decidedStrategy(board)
+ * -----------------------------------------------------
+ * Reads the published choice for the size of board without locking.
+ * @return int type, 1 for the dictionary scan, 0 for the board search, -1 if the size is still calibrating.
+ */
+int LetterHistogramIndex::decidedStrategy(const BoggleBoard& board) const {
+    pair<int, int> size = make_pair(board.numRows(), board.numCols());
+    int count = numDecided.load(memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (decidedSizes[i] == size) {
+            return decidedScan[i] ? 1 : 0;
+        }
+    }
+    return -1;
+}
+
+/** Method: calibrate
+ * Usage: bool scan = calibrate(board, words, pathCells, pathEnds)
+ * -----------------------------------------------------
+ * Finds the words of board like findWords and returns the choice for its size. While fewer than
+ * CALIBRATION_BOARDS boards of that size were started, board is timed both ways outside of the lock
+ * and the times are added to the totals under it; the last of them publishes the choice.
+ */
+bool LetterHistogramIndex::calibrate(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                                     vector<int>& pathEnds) const {
+    pair<int, int> size = make_pair(board.numRows(), board.numCols());
+    bool timeBoard;
+    bool scan;
+    {
+        lock_guard<mutex> guard(timingLock);
+        StrategyTiming& timing = timings[size];
+        timeBoard = timing.boardsStarted < CALIBRATION_BOARDS;
+        if (timeBoard) {
+            timing.boardsStarted++;
+        }
+        scan = timing.scanSeconds < timing.searchSeconds;
+    }
+    if (!timeBoard) {
+        // the other boards of the calibration are still being timed
+        if (scan) {
+            findWords(board, words, pathCells, pathEnds);
+        } else {
+            board.findWords(*trie, minWordLength, words, pathCells, pathEnds);
+        }
+        return scan;
+    }
+    StrategyTiming boardTiming = {0, 0, 0, 0};
+    timeStrategies(board, words, pathCells, pathEnds, boardTiming);
+    lock_guard<mutex> guard(timingLock);
+    StrategyTiming& timing = timings[size];
+    timing.boardsTimed++;
+    timing.searchSeconds += boardTiming.searchSeconds;
+    timing.scanSeconds += boardTiming.scanSeconds;
+    scan = timing.scanSeconds < timing.searchSeconds;
+    int count = numDecided.load(memory_order_relaxed);
+    if (timing.boardsTimed == CALIBRATION_BOARDS && count < MAX_DECIDED_SIZES) {
+        decidedSizes[count] = size;
+        decidedScan[count] = scan;
+        numDecided.store(count + 1, memory_order_release);
+    }
+    return scan;
+}
+
+/** Method: scanWords
+ * Usage: scanWords(board, words, pathCells, stats)
+ * -----------------------------------------------------
+ * Dictionary scan of findWords: checks the mask, then the counts, of every word starting with a
+ * letter of the board, and looks for a path for the words that pass both.
+ */
+void LetterHistogramIndex::scanWords(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                                     vector<int>& pathEnds, WordSearchStats& stats) const {
+    uint8_t counts[HISTOGRAM_SLOTS];
+    uint32_t boardMask;
+    boardCounts(board, counts, boardMask);
+    // adjacentPairs[a * 26 + b] is true if 'A' + b can follow 'A' + a in a word: in the same tile,
+    // or the last letter of a tile and the first letter of a neighboring tile
+    vector<bool> adjacentPairs(26 * 26, false);
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        string tile = board.tile(cell);
+        for (int i = 1; i < (int) tile.length(); i++) {
+            markPair(adjacentPairs, tile[i - 1], tile[i]);
+        }
+        for (const int* neighbor = board.neighborsBegin(cell); neighbor != board.neighborsEnd(cell); neighbor++) {
+            markPair(adjacentPairs, tile.back(), board.letter(*neighbor));
+        }
+    }
+    vector<int> path;
+    string word;
+    for (int l = 0; l < 26; l++) {
+        if (!(boardMask & (1u << l))) {
+            continue;
+        }
+        for (int i = firstWithLetter[l]; i < firstWithLetter[l + 1]; i++) {
+            stats.trieProbes++;
+            if ((letterMasks[i] & ~boardMask) != 0 || wordOffsets[i + 1] - wordOffsets[i] > board.letterCount()) {
+                continue;
+            }
+            const uint8_t* wordCounts = &histograms[(size_t) i * HISTOGRAM_SLOTS];
+            bool enoughLetters = true;
+            for (int slot = 0; slot < HISTOGRAM_SLOTS; slot++) {
+                enoughLetters &= wordCounts[slot] <= counts[slot];
+            }
+            if (!enoughLetters) {
+                continue;
+            }
+            bool pairsOnBoard = true;
+            for (int position = wordOffsets[i] + 1; position < wordOffsets[i + 1] && pairsOnBoard; position++) {
+                pairsOnBoard = adjacentPairs[(letters[position - 1] - 'A') * 26 + letters[position] - 'A'];
+            }
+            if (!pairsOnBoard) {
+                continue;
+            }
+            stats.pathsExtended++;
+            word.assign(letters.begin() + wordOffsets[i], letters.begin() + wordOffsets[i + 1]);
+            if (board.findPath(word, path)) {
+                words.push_back(word);
+                pathCells.insert(pathCells.end(), path.begin(), path.end());
+                pathEnds.push_back(pathCells.size());
+            }
+        }
+    }
+}
+
+/** Method: timeStrategies
+ * Usage: timeStrategies(board, words, pathCells, pathEnds, timing)
+ * -----------------------------------------------------
+ * Solves board with the board search and with the dictionary scan and adds the time each took to
+ * timing. The words found by the scan are appended to words, pathCells and pathEnds as by findWords.
+ */
+void LetterHistogramIndex::timeStrategies(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                                          vector<int>& pathEnds, StrategyTiming& timing) const {
+    vector<string> searchWords;
+    vector<int> searchCells;
+    vector<int> searchEnds;
+    auto startTime = chrono::steady_clock::now();
+    board.findWords(*trie, minWordLength, searchWords, searchCells, searchEnds);
+    auto middleTime = chrono::steady_clock::now();
+    findWords(board, words, pathCells, pathEnds);
+    auto endTime = chrono::steady_clock::now();
+    timing.boardsTimed++;
+    timing.searchSeconds += chrono::duration<double>(middleTime - startTime).count();
+    timing.scanSeconds += chrono::duration<double>(endTime - middleTime).count();
+}
+
+/* Function: boardCounts()
+ * Usage: boardCounts(board, counts, mask)
+ * -----------------------------------------------------------------------------
+ * Sets counts to the number of times every letter appears in the tiles of board (255 for 255 or
+ * more) and mask to the letters of the board.
+ */
+static void boardCounts(const BoggleBoard& board, uint8_t counts[HISTOGRAM_SLOTS], uint32_t& mask) {
+    fill(counts, counts + HISTOGRAM_SLOTS, 0);
+    mask = 0;
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        for (char letter : board.tile(cell)) {
+            unsigned int letterIndex = (unsigned char) letter - 'A';
+            if (letterIndex < 26) {
+                mask |= 1u << letterIndex;
+                if (counts[letterIndex] < 255) {
+                    counts[letterIndex]++;
+                }
+            }
+        }
+    }
+}
+
+/* Function: markPair()
+ * Usage: markPair(adjacentPairs, first, second)
+ * -----------------------------------------------------------------------------
+ * Records in adjacentPairs that second can follow first in a word of the board.
+ */
+static void markPair(vector<bool>& adjacentPairs, char first, char second) {
+    unsigned int firstIndex = (unsigned char) first - 'A';
+    unsigned int secondIndex = (unsigned char) second - 'A';
+    if (firstIndex < 26 && secondIndex < 26) {
+        adjacentPairs[firstIndex * 26 + secondIndex] = true;
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * File: LetterHistogramIndex.h
+ * ----------------------------
+ * This file declares the LetterHistogramIndex class, the dictionary-anchored way of finding the
+ * words of a Boggle board: instead of searching the board for paths that spell words, every word
+ * of the dictionary is checked against the letters of the board, and only the words the board has
+ * enough letters for (the candidates) are looked for on the board with BoggleBoard::findPath.
+ * The letter counts of every word are computed once, when the index is built, as 32 one-byte
+ * counts (26 letters and padding) that are compared to the counts of the board with a loop the
+ * compiler turns into a few vector instructions; a 26-bit mask of the letters of the word rejects
+ * most words before that. Words are grouped by first letter so the words starting with a letter
+ * that is not on the board are skipped without being read.
+ * Checking the dictionary is only faster than the board search for small dictionaries: with a
+ * large dictionary the scan reads more words than the search makes trie probes on small boards, and
+ * on large boards almost every word passes the letter checks and needs a path search. findWordsFastest
+ * chooses per board size, by timing both ways on the first boards of that size it solves, so the
+ * choice follows the letters the boards are actually made of (dice of the game, random letters, ...).
+ * Once the first boards of a size are timed the choice is published and read without locking.
+ */
+
+#ifndef _letterhistogramindex_h
+#define _letterhistogramindex_h
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BoggleBoard.h"
+#include "CompactLexicon.h"
+using namespace std;
+
+/* Number of one-byte letter counts stored per word: 26 letters, padded to a multiple of 16 */
+const int HISTOGRAM_SLOTS = 32;
+
+/* Largest number of board sizes whose choice of strategy is published to be read without locking */
+const int MAX_DECIDED_SIZES = 16;
+
+/* Time taken by the board search and the dictionary scan on the boards of one size timed so far */
+struct StrategyTiming {
+    int boardsStarted;
+    int boardsTimed;
+    double searchSeconds;
+    double scanSeconds;
+};
+
+class LetterHistogramIndex {
+public:
+    LetterHistogramIndex(shared_ptr<const CompactLexicon> trie, int minLength);
+    int wordCount() const;
+    int minLength() const;
+    shared_ptr<const CompactLexicon> dictionary() const;
+    void findWords(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                   vector<int>& pathEnds) const;
+    void findWords(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                   vector<int>& pathEnds, WordSearchStats& stats) const;
+    void findWordsFastest(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                          vector<int>& pathEnds) const;
+    bool prefersScan(const BoggleBoard& board) const;
+
+private:
+    // instance variables
+    shared_ptr<const CompactLexicon> trie;
+    int minWordLength;
+    vector<char> letters;           // letters of all the words, in alphabetical order of the words
+    vector<int> wordOffsets;        // word i is letters[wordOffsets[i] .. wordOffsets[i + 1])
+    vector<uint32_t> letterMasks;   // bit l is set if word i contains 'A' + l
+    vector<uint8_t> histograms;     // HISTOGRAM_SLOTS counts per word (255 for 255 or more)
+    int firstWithLetter[27];        // words starting with 'A' + l are firstWithLetter[l] .. firstWithLetter[l + 1] - 1
+    mutable map<pair<int, int>, StrategyTiming> timings;    // timings of the calibration for every board size
+    mutable mutex timingLock;
+    mutable pair<int, int> decidedSizes[MAX_DECIDED_SIZES]; // board sizes whose calibration is over
+    mutable bool decidedScan[MAX_DECIDED_SIZES];            // choice for decidedSizes[i], written before numDecided
+    mutable atomic<int> numDecided;
+    void scanWords(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                   vector<int>& pathEnds, WordSearchStats& stats) const;
+    int decidedStrategy(const BoggleBoard& board) const;
+    bool calibrate(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                   vector<int>& pathEnds) const;
+    void timeStrategies(const BoggleBoard& board, vector<string>& words, vector<int>& pathCells,
+                        vector<int>& pathEnds, StrategyTiming& timing) const;
+};
+
+#endif // _letterhistogramindex_h
@@ -0,0 +1,54 @@
+/*
+ * File: MakeDawg.cpp
+ * ------------------
+ * This file implements the build step of the word games' compact dictionary: it reads a word list
+ * (one word per line, or any file a Lexicon can read), builds its minimized DAWG (CompactLexicon)
+ * and saves it to a binary file that Boggle and the word ladder memory-map instead of parsing the
+ * word list every time they start.
+ * Usage: MakeDawg [words file] [dawg file]. File names that are not given on the command line are
+ * asked for in the console.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "CompactLexicon.h"
+#include "filelib.h"
+#include "lexicon.h"
+#include "simpio.h"
+using namespace std;
+
+/* Text to display in console */
+const string PROMPT_WORDS_FILE = "Word list file name?";
+const string PROMPT_DAWG_FILE = "Compact dictionary file to write (Enter for dictionary.dawg): ";
+const string DEFAULT_DAWG_FILE = "dictionary.dawg";
+
+int main(int argc, char** argv) {
+    string wordsFile = argc > 1 ? argv[1] : promptUserForFile(PROMPT_WORDS_FILE);
+    string dawgFile = argc > 2 ? argv[2] : getLine(PROMPT_DAWG_FILE);
+    if (dawgFile == "") {
+        dawgFile = DEFAULT_DAWG_FILE;
+    }
+    try {
+        auto startTime = chrono::steady_clock::now();
+        Lexicon words(wordsFile);
+        CompactLexicon dawg(words);
+        dawg.save(dawgFile);
+        double buildMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+
+        startTime = chrono::steady_clock::now();
+        CompactLexicon loaded(dawgFile);
+        double loadMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+        cout << dawgFile << ": " << dawg.size() << " words, " << dawg.nodeCount() << " nodes, "
+             << dawg.edgeCount() << " edges (" << (dawg.nodeCount() + dawg.edgeCount()) * 8 / 1024
+             << " KB), built in " << buildMillis << " ms, loaded in " << loadMillis << " ms" << endl;
+        if (loaded.size() != dawg.size()) {
+            cout << "Saved file does not match the word list." << endl;
+            return 1;
+        }
+    } catch (const string& problem) {
+        cout << problem << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * File: NgramBenchmark.cpp
+ * ------------------------
+ * This file implements functions that time the N-gram model and print the results to the console:
+ * - building the model of a text (interning, context numbering, successor counts and alias tables).
+ * - generating random text the way the Random Writer does: drawing a successor of the current
+ * window, moving the window one word forward and looking up its context, in words per second.
+ * - generating the same text with a NgramGenerator (ring buffer window, rolling hash), alone and
+ * written to a string stream, in words per second.
+ * - drawing successors alone, without moving the window, in draws per second.
+ * - building the model straight from the text file with 1, 2, 4 ... threads, against reading the
+ * words with >> and building the model from them, with the speedup over one thread.
+ * - saving the model to a model file and memory-mapping it back, then generating from the mapped
+ * model.
+ * The random number generator is seeded before every timing, so the same seed always generates the
+ * same text.
+ */
+
+#include "NgramBenchmark.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "NgramGenerator.h"
+#include "random.h"
+
+/* Function prototypes */
+static long countSuccessors(const NgramModel& model);
+
+/* Function: benchmarkNgramModel()
+ * Usage: benchmarkNgramModel(words, n, numWords, seed)
+ * -----------------------------------------------------------------------------
+ * Builds the N-gram model of the text made of words, prints the time it took and the size of the
+ * model, then times the generation of numWords words with benchmarkGeneration.
+ * @param: words type vector<string> - words of the text, in order.
+ * @param: n type int - number of words of an N-gram.
+ * @param: numWords type int - number of words generated.
+ * @param: seed type int - seed of the random number generator.
+ */
+void benchmarkNgramModel(const vector<string>& words, int n, int numWords, int seed) {
+    auto startTime = chrono::steady_clock::now();
+    NgramModel model(words, n);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    long numSuccessors = countSuccessors(model);
+    cout << fixed << setprecision(3);
+    cout << "N = " << n << ", " << words.size() << " words, " << model.vocabularySize() << " distinct, "
+         << model.contextCount() << " contexts, " << numSuccessors << " successors" << endl;
+    cout << "  build:      " << seconds << " s, " << (seconds > 0 ? words.size() / seconds : 0) << " words/s" << endl;
+    benchmarkGeneration(model, numWords, seed);
+}
+
+/* Function: benchmarkGeneration()
+ * Usage: benchmarkGeneration(model, numWords, seed)
+ * -----------------------------------------------------------------------------
+ * Generates numWords words from model starting at its first context, moving the window of
+ * order() - 1 word ids after every word, and prints the words generated per second; then generates
+ * them again with a NgramGenerator, and prints its words per second and whether it generated the
+ * same text, and once more writing the text to a string stream; then draws numWords successors of
+ * contexts taken in turn, and prints the draws per second. The lengths of the words generated are
+ * added up and printed so the work cannot be skipped.
+ * @param: model type NgramModel - model generating the words.
+ * @param: numWords type int - number of words generated, and of successors drawn.
+ * @param: seed type int - seed of the random number generator.
+ */
+void benchmarkGeneration(const NgramModel& model, int numWords, int seed) {
+    setRandomSeed(seed);
+    vector<int> window(model.contextWords(0), model.contextWords(0) + model.order() - 1);
+    int context = 0;
+    long totalLength = 0;
+    auto startTime = chrono::steady_clock::now();
+    for (int i = 0; i < numWords; i++) {
+        int next = model.randomSuccessor(context);
+        totalLength += strlen(model.word(next));
+        window.erase(window.begin());
+        window.push_back(next);
+        context = model.findContext(window.data());
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << fixed << setprecision(1);
+    cout << "  generation: " << (seconds > 0 ? numWords / seconds : 0) << " words/s, "
+         << (double) totalLength / max(numWords, 1) << " letters per word" << endl;
+
+    setRandomSeed(seed);
+    NgramGenerator generator(model, 0);
+    long ringLength = 0;
+    startTime = chrono::steady_clock::now();
+    for (int i = 0; i < numWords; i++) {
+        ringLength += strlen(model.word(generator.nextWord()));
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << "  ring:       " << (seconds > 0 ? numWords / seconds : 0) << " words/s, "
+         << (ringLength == totalLength && generator.context() == context ? "same text" : "DIFFERENT TEXT") << endl;
+
+    setRandomSeed(seed);
+    NgramGenerator writer(model, 0);
+    ostringstream text;
+    startTime = chrono::steady_clock::now();
+    writer.writeWords(text, numWords);
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << "  ring text:  " << (seconds > 0 ? numWords / seconds : 0) << " words/s, "
+         << text.str().length() << " characters" << endl;
+
+    setRandomSeed(seed);
+    long idTotal = 0;
+    startTime = chrono::steady_clock::now();
+    for (int i = 0; i < numWords; i++) {
+        idTotal += model.randomSuccessor(i % model.contextCount());
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << "  sampling:   " << (seconds > 0 ? numWords / seconds : 0) << " draws/s, mean id "
+         << (double) idTotal / max(numWords, 1) << endl;
+}
+
+/* Function: benchmarkParallelBuild()
+ * Usage: benchmarkParallelBuild(textFile, n, maxThreads)
+ * -----------------------------------------------------------------------------
+ * Times reading the words of textFile with >> and building their N-gram model, then building the
+ * model from the file with 1, 2, 4 ... threads up to maxThreads (and maxThreads itself), and prints
+ * the seconds taken, the speedup over one thread and whether the model has the same numbers of
+ * words, contexts and successors as the one built from the words.
+ * @param: textFile type string - name of the text file.
+ * @param: n type int - number of words of an N-gram.
+ * @param: maxThreads type int - largest number of threads (0 for one per hardware thread).
+ */
+void benchmarkParallelBuild(const string& textFile, int n, int maxThreads) {
+    if (maxThreads <= 0) {
+        maxThreads = max((int) thread::hardware_concurrency(), 1);
+    }
+    auto startTime = chrono::steady_clock::now();
+    ifstream input(textFile.c_str());
+    vector<string> words;
+    string word;
+    while (input >> word) {
+        words.push_back(word);
+    }
+    NgramModel reference(words, n);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << fixed << setprecision(3);
+    cout << "N = " << n << ", build from " << textFile << endl;
+    cout << "  words:      " << seconds << " s (read with >>, then built)" << endl;
+    vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2) {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(maxThreads);
+    double oneThread = 0;
+    for (int numThreads : threadCounts) {
+        startTime = chrono::steady_clock::now();
+        NgramModel model(textFile, n, numThreads);
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        if (numThreads == 1) {
+            oneThread = seconds;
+        }
+        bool sameModel = model.vocabularySize() == reference.vocabularySize()
+                && model.contextCount() == reference.contextCount()
+                && countSuccessors(model) == countSuccessors(reference);
+        cout << "  " << setw(2) << numThreads << " threads: " << seconds << " s, speedup "
+             << setprecision(2) << (seconds > 0 ? oneThread / seconds : 0) << setprecision(3)
+             << (sameModel ? "" : ", DIFFERENT MODEL") << endl;
+    }
+}
+
+/* Function: benchmarkModelFile()
+ * Usage: benchmarkModelFile(model, modelFile, numWords, seed)
+ * -----------------------------------------------------------------------------
+ * Saves model to modelFile and loads it back, printing the time each took and the size of the
+ * file, checks that the loaded model generates the same numWords words as model for the same seed,
+ * then times the generation from the loaded model with benchmarkGeneration.
+ * @param: model type NgramModel - model saved.
+ * @param: modelFile type string - name of the model file written.
+ * @param: numWords type int - number of words generated.
+ * @param: seed type int - seed of the random number generator.
+ */
+void benchmarkModelFile(const NgramModel& model, const string& modelFile, int numWords, int seed) {
+    auto startTime = chrono::steady_clock::now();
+    model.saveModel(modelFile);
+    double saveSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    startTime = chrono::steady_clock::now();
+    NgramModel loaded(modelFile);
+    double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    ifstream file(modelFile.c_str(), ios::binary | ios::ate);
+    cout << fixed << setprecision(3);
+    cout << "Model file " << modelFile << ", " << file.tellg() / 1048576.0 << " MB" << endl;
+    cout << "  save:       " << saveSeconds << " s" << endl;
+    cout << "  load:       " << loadSeconds * 1000 << " ms" << endl;
+
+    setRandomSeed(seed);
+    NgramGenerator builtGenerator(model, 0);
+    vector<int> builtWords;
+    for (int i = 0; i < numWords; i++) {
+        builtWords.push_back(builtGenerator.nextWord());
+    }
+    setRandomSeed(seed);
+    NgramGenerator loadedGenerator(loaded, 0);
+    bool sameText = true;
+    for (int i = 0; i < numWords && sameText; i++) {
+        int next = loadedGenerator.nextWord();
+        sameText = strcmp(loaded.word(next), model.word(builtWords[i])) == 0;
+    }
+    cout << "  loaded model: " << (sameText ? "same text" : "DIFFERENT TEXT") << endl;
+    benchmarkGeneration(loaded, numWords, seed);
+}
+
+/* Function: countSuccessors()
+ * Usage: long numSuccessors = countSuccessors(model)
+ * -----------------------------------------------------------------------------
+ * Returns the number of (context, successor) pairs of model.
+ */
+static long countSuccessors(const NgramModel& model) {
+    long numSuccessors = 0;
+    for (int c = 0; c < model.contextCount(); c++) {
+        numSuccessors += model.successorCount(c);
+    }
+    return numSuccessors;
+}
@@ -0,0 +1,22 @@
+/*
+ * File: NgramBenchmark.h
+ * ----------------------
+ * This file declares functions that time the building of the N-gram model of a text (from its
+ * words, or from the text file with 1 to many threads), saving and loading it as a model file,
+ * and the generation of random text from it, and print the results to the console. BenchmarkNgrams.cpp
+ * runs them from the command line.
+ */
+
+#ifndef _ngrambenchmark_h
+#define _ngrambenchmark_h
+#include <string>
+#include <vector>
+#include "NgramModel.h"
+using namespace std;
+
+void benchmarkNgramModel(const vector<string>& words, int n, int numWords, int seed);
+void benchmarkGeneration(const NgramModel& model, int numWords, int seed);
+void benchmarkParallelBuild(const string& textFile, int n, int maxThreads);
+void benchmarkModelFile(const NgramModel& model, const string& modelFile, int numWords, int seed);
+
+#endif // _ngrambenchmark_h
@@ -0,0 +1,65 @@
+/*
+ * File: NgramGenerator.cpp
+ * ------------------------
+ * This file implements the NgramGenerator class, which includes the following methods
+ * - NgramGenerator constructor, which starts the window at a context of the model.
+ * - methods to generate the next word, or many words written to a stream.
+ */
+
+#include "NgramGenerator.h"
+
+/** Method: NgramGenerator
+ * Usage: NgramGenerator generator(model, context)
+ * -----------------------------------------------------
+ * Creates a generator whose window holds the words of context, so the first word generated is one
+ * of its successors.
+ * @param model - NgramModel type, model the words are drawn from.
+ * @param context - int type, number of the starting context in model.
+ */
+NgramGenerator::NgramGenerator(const NgramModel& model, int context)
+    : model(model), window(model.contextWords(context), model.contextWords(context) + model.order() - 1) {
+    head = 0;
+    hash = model.contextHash(window.data());
+    currentContext = context;
+}
+
+/** Method: context
+ * Usage: generator.context()
+ * -----------------------------------------------------
+ * @return int type, number of the context of the window (the last N - 1 words generated).
+ */
+int NgramGenerator::context() const {
+    return currentContext;
+}
+
+/** Method: nextWord
+ * Usage: int id = generator.nextWord()
+ * -----------------------------------------------------
+ * Draws a successor of the window at random (see NgramModel::randomSuccessor) and moves the
+ * window forward: the id replaces the oldest id of the ring buffer, the hash is rolled and the
+ * context of the new window is looked up with it. Every window has successors, as the model wraps
+ * around the end of its text.
+ * @return int type, id of the word generated.
+ */
+int NgramGenerator::nextWord() {
+    int next = model.randomSuccessor(currentContext);
+    hash = model.rollHash(hash, window[head], next);
+    window[head] = next;
+    head = head + 1 == (int) window.size() ? 0 : head + 1;
+    currentContext = model.findContext(window.data(), head, hash);
+    return next;
+}
+
+/** Method: writeWords
+ * Usage: generator.writeWords(out, numWords)
+ * -----------------------------------------------------
+ * Generates numWords words and writes each to out preceded by a space, without building a string
+ * of the text, so the time taken is proportional to the length of the text.
+ * @param out - ostream type, stream the words are written to.
+ * @param numWords - int type, number of words generated.
+ */
+void NgramGenerator::writeWords(ostream& out, int numWords) {
+    for (int i = 0; i < numWords; i++) {
+        out << ' ' << model.word(nextWord());
+    }
+}
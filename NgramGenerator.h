@@ -0,0 +1,35 @@
+/*
+ * File: NgramGenerator.h
+ * ----------------------
+ * This file declares the NgramGenerator class, which generates random text from a NgramModel one
+ * word at a time. The window of the last N - 1 words is a ring buffer of word ids: moving it forward
+ * overwrites its oldest id instead of shifting the others, and its hash is rolled with the ids
+ * dropped and added, so a word costs one successor draw and one hash table lookup whatever N is.
+ * A generator reads its model and never changes it; the model must outlive it.
+ */
+
+#ifndef _ngramgenerator_h
+#define _ngramgenerator_h
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "NgramModel.h"
+using namespace std;
+
+class NgramGenerator {
+public:
+    NgramGenerator(const NgramModel& model, int context);
+    int context() const;
+    int nextWord();
+    void writeWords(ostream& out, int numWords);
+
+private:
+    // instance variables
+    const NgramModel& model;
+    vector<int> window;     // ids of the last N - 1 words, the oldest at position head
+    int head;
+    uint64_t hash;          // contextHash of the window
+    int currentContext;
+};
+
+#endif // _ngramgenerator_h
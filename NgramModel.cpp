@@ -0,0 +1,1179 @@
+/*
+ * File: NgramModel.cpp
+ * --------------------
+ * This file implements the NgramModel class, which includes the following methods
+ * - NgramModel constructor, which interns the words of a text, numbers its contexts and stores the
+ * successors of every context.
+ * - NgramModel constructor which does the same from a text file with several threads.
+ * - NgramModel constructor which memory-maps a model file written by saveModel.
+ * - method to write the model to a model file.
+ * - methods to look up words and contexts by id.
+ * - methods to read the successors of a context and draw one at random.
+ * - method to draw a context that starts a sentence.
+ * The model is built in two passes over the text: the first gives every position the number of its
+ * context (adding new contexts to the hash table, with the hash of the window rolled from one
+ * position to the next), the second places the successor of every
+ * position in the range of its context (a counting sort by context), after which the successors of
+ * every context are sorted, the repeated ones merged into counts, and the alias table of the
+ * context is computed from the counts (Vose's method, in integers so the probabilities are exact).
+ * The threaded constructor runs every pass on ranges of positions, shards or contexts that
+ * belong to one thread, with a join between passes; the few steps that are left to one thread
+ * (merging the vocabularies, prefix sums) only take time proportional to the vocabulary, the
+ * number of threads or the number of contexts.
+ * A model built in memory keeps its arrays in vectors (owned) and a model loaded from a model file
+ * in the mapped file; either way the methods read them through the same array pointers. Model
+ * files are written in the byte order of the machine that saves them, and loading a model file
+ * with another byte order is refused.
+ */
+
+#include "NgramModel.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "random.h"
+
+/* Text for string exceptions */
+const string EXCEPTION_NGRAM_ORDER = "N must be 2 or greater";
+const string EXCEPTION_NGRAM_EMPTY = "Text has no words";
+const string EXCEPTION_NGRAM_OPEN = "Text file could not be opened";
+const string EXCEPTION_NGRAM_TOO_LONG = "Text has too many words for a N-gram model";
+const string EXCEPTION_MODEL_OPEN = "N-gram model file could not be opened";
+const string EXCEPTION_MODEL_FORMAT = "File is not a N-gram model file or is truncated";
+const string EXCEPTION_MODEL_VERSION = "N-gram model file version is not supported";
+const string EXCEPTION_MODEL_WRITE = "N-gram model file could not be written";
+
+/* Model file identification */
+static const char MODEL_MAGIC[8] = {'N', 'G', 'R', 'A', 'M', 'M', 'D', 'L'};
+static const uint32_t MODEL_BYTE_ORDER = 0x01020304;
+
+/* Largest number of slots of a hash table of a model file, so that every slot number is an int */
+static const int64_t MAX_MODEL_SLOTS = (int64_t) 1 << 30;
+
+/* Number of slots of the context hash table when the model is created (a power of 2) */
+static const int INITIAL_CONTEXT_SLOTS = 1024;
+
+/* Base of the polynomial hash of contexts, and odd multiplier spreading a hash over the slots */
+static const uint64_t HASH_BASE = 0x100000001B3ull;
+static const uint64_t SLOT_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+/* Offset basis of the FNV-1a hash of words (its prime is HASH_BASE) */
+static const uint64_t WORD_HASH_BASIS = 0xCBF29CE484222325ull;
+
+/* Function prototypes */
+static void runThreads(int numThreads, const function<void(int)>& body);
+static int rangeStart(int size, int part, int numParts);
+
+/* Words of the piece of a text file read by one thread */
+struct TextPiece {
+    vector<string> words;       // distinct words of the piece, in order of first appearance
+    vector<int> ids;            // number in words of every word of the piece
+    vector<int> globalIds;      // id in the model of every word of words
+};
+
+/* Contexts of one shard, in order of first appearance */
+struct ContextShard {
+    vector<int> firstPositions; // position in the text of the first occurrence of every context
+    vector<int> counts;         // number of occurrences of every context
+    vector<int> contexts;       // number in the model of every context
+};
+
+/** Method: NgramModel
+ * Usage: NgramModel model(words, n)
+ * -----------------------------------------------------
+ * Builds the N-gram model of the text made of words: every window of n - 1 words, starting at
+ * every position of the text and wrapping around its end, is a context, followed by the word after
+ * it. Throws a string exception if n is smaller than 2 or words is empty, or if words has more
+ * words than positions, counts and offsets can number (INT_MAX - n).
+ * @param words - vector<string> type, words of the text, in order.
+ * @param n - int type, number of words of an N-gram (context and successor).
+ */
+NgramModel::NgramModel(const vector<string>& words, int n) {
+    if (n < 2) {
+        throw EXCEPTION_NGRAM_ORDER;
+    }
+    if (words.empty()) {
+        throw EXCEPTION_NGRAM_EMPTY;
+    }
+    if (words.size() > (size_t) INT_MAX - n) {
+        throw EXCEPTION_NGRAM_TOO_LONG;
+    }
+    mappedImage = NULL;
+    mappedSize = 0;
+    setOrder(n);
+    int textSize = words.size();
+    vector<int> textIds;
+    textIds.reserve(textSize + n - 1);
+    unordered_map<string, int> wordIds;
+    for (const string& word : words) {
+        auto found = wordIds.find(word);
+        if (found == wordIds.end()) {
+            found = wordIds.emplace(word, owned.vocabulary.size()).first;
+            owned.vocabulary.push_back(word);
+        }
+        textIds.push_back(found->second);
+    }
+    for (int i = 0; i < n - 1; i++) {
+        textIds.push_back(textIds[i % textSize]);
+    }
+
+    owned.contextSlots.assign(INITIAL_CONTEXT_SLOTS, -1);
+    slotShift = 64 - __builtin_ctz(INITIAL_CONTEXT_SLOTS);
+    probeMask = INITIAL_CONTEXT_SLOTS - 1;
+    attachArrays();
+    vector<int> positionContexts(textSize);
+    uint64_t hash = contextHash(&textIds[0]);
+    for (int i = 0; i < textSize; i++) {
+        positionContexts[i] = addContext(&textIds[i], hash);
+        hash = rollHash(hash, textIds[i], textIds[i + n - 1]);
+    }
+    numContexts = owned.contextIds.size() / (n - 1);
+    owned.successorOffsets.assign(numContexts + 1, 0);
+    for (int i = 0; i < textSize; i++) {
+        owned.successorOffsets[positionContexts[i] + 1]++;
+    }
+    for (int c = 0; c < numContexts; c++) {
+        owned.successorOffsets[c + 1] += owned.successorOffsets[c];
+    }
+    vector<int> nextFree(owned.successorOffsets.begin(), owned.successorOffsets.end() - 1);
+    vector<int> allSuccessors(textSize);
+    for (int i = 0; i < textSize; i++) {
+        allSuccessors[nextFree[positionContexts[i]]++] = textIds[i + n - 1];
+    }
+    owned.contextTotals.resize(numContexts);
+    for (int c = 0; c < numContexts; c++) {
+        owned.contextTotals[c] = owned.successorOffsets[c + 1] - owned.successorOffsets[c];
+    }
+    mergeSuccessors(allSuccessors, 1);
+    finishModel();
+}
+
+/** Method: NgramModel
+ * Usage: NgramModel model(textFile, n, numThreads)
+ * -----------------------------------------------------
+ * Builds the N-gram model of the words of a text file (separated by white space, as read by >>)
+ * with numThreads threads. The model is the same as NgramModel(words, n) with the words of the
+ * file, whatever the number of threads. Throws a string exception if n is smaller than 2, the file
+ * cannot be opened, has no words or more than INT_MAX - n words.
+ * @param textFile - string type, name of the text file.
+ * @param n - int type, number of words of an N-gram (context and successor).
+ * @param numThreads - int type, number of threads used (0 for one per hardware thread).
+ */
+NgramModel::NgramModel(const string& textFile, int n, int numThreads) {
+    if (n < 2) {
+        throw EXCEPTION_NGRAM_ORDER;
+    }
+    if (numThreads <= 0) {
+        numThreads = max((int) thread::hardware_concurrency(), 1);
+    }
+    mappedImage = NULL;
+    mappedSize = 0;
+    int fd = open(textFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw EXCEPTION_NGRAM_OPEN;
+    }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0) {
+        close(fd);
+        throw EXCEPTION_NGRAM_OPEN;
+    }
+    vector<int> textIds;
+    if (fileInfo.st_size > 0) {
+        void* text = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (text == MAP_FAILED) {
+            throw EXCEPTION_NGRAM_OPEN;
+        }
+        readWords((const char*) text, fileInfo.st_size, numThreads, textIds);
+        munmap(text, fileInfo.st_size);
+    } else {
+        close(fd);
+    }
+    if (textIds.empty()) {
+        throw EXCEPTION_NGRAM_EMPTY;
+    }
+    if (textIds.size() > (size_t) INT_MAX - n) {
+        throw EXCEPTION_NGRAM_TOO_LONG;
+    }
+    setOrder(n);
+    int textSize = textIds.size();
+    for (int i = 0; i < n - 1; i++) {
+        textIds.push_back(textIds[i % textSize]);
+    }
+    vector<int> allSuccessors;
+    countContexts(textIds, numThreads, allSuccessors);
+    mergeSuccessors(allSuccessors, numThreads);
+    finishModel();
+}
+
+/** Method: NgramModel
+ * Usage: NgramModel model(modelFile)
+ * -----------------------------------------------------
+ * Loads a model from a model file written by saveModel. The file is memory-mapped, not read
+ * into vectors or parsed: loading only reads every array once, to check that the offsets, ids and
+ * slots it holds stay in their arrays, so a damaged file is refused instead of making the model
+ * read outside of the mapping.
+ * Throws a string exception if the file cannot be opened, is not a model file, is truncated or
+ * inconsistent, or was written with another format version or byte order.
+ * @param modelFile - string type, name of the model file.
+ */
+NgramModel::NgramModel(const string& modelFile) {
+    mappedImage = NULL;
+    mappedSize = 0;
+    int fd = open(modelFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw EXCEPTION_MODEL_OPEN;
+    }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < (off_t) sizeof(ModelHeader)) {
+        close(fd);
+        throw EXCEPTION_MODEL_FORMAT;
+    }
+    void* image = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        throw EXCEPTION_MODEL_OPEN;
+    }
+    const ModelHeader* header = (const ModelHeader*) image;
+    string problem;
+    if (memcmp(header->magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0 || header->byteOrder != MODEL_BYTE_ORDER) {
+        problem = EXCEPTION_MODEL_FORMAT;
+    } else if (header->version != NGRAM_MODEL_VERSION) {
+        problem = EXCEPTION_MODEL_VERSION;
+    } else if (header->n < 2 || header->vocabularySize < 1 || header->vocabularySize > INT_MAX - 1 ||
+               header->contextCount < 1 || header->contextCount > INT_MAX / (header->n - 1) ||
+               header->successorCount < 1 || header->successorCount > INT_MAX ||
+               header->startCount < 0 || header->startCount > header->contextCount ||
+               header->characterCount < 0 || header->characterCount > fileInfo.st_size ||
+               header->slotCount < 2 || header->slotCount > MAX_MODEL_SLOTS ||
+               (header->slotCount & (header->slotCount - 1)) != 0 ||
+               header->wordSlotCount < 2 || header->wordSlotCount > MAX_MODEL_SLOTS ||
+               (header->wordSlotCount & (header->wordSlotCount - 1)) != 0 ||
+               header->probeMask < 0 || header->probeMask >= header->slotCount ||
+               (header->probeMask & (header->probeMask + 1)) != 0 ||
+               header->imageSize != (uint64_t) fileInfo.st_size || header->imageSize != imageSizeFor(*header)) {
+        problem = EXCEPTION_MODEL_FORMAT;
+    }
+    if (problem == "") {
+        attachImage((char*) image);
+        if (!validArrays(*header)) {
+            problem = EXCEPTION_MODEL_FORMAT;
+        }
+    }
+    if (problem != "") {
+        munmap(image, fileInfo.st_size);
+        throw problem;
+    }
+    mappedImage = image;
+    mappedSize = fileInfo.st_size;
+}
+
+/** Method: ~NgramModel
+ * -----------------------------------------------------
+ * Unmaps the model file, if the model was loaded from one.
+ */
+NgramModel::~NgramModel() {
+    if (mappedImage != NULL) {
+        munmap(mappedImage, mappedSize);
+    }
+}
+
+/** Method: saveModel
+ * Usage: model.saveModel(modelFile)
+ * -----------------------------------------------------
+ * Writes the model (words, contexts and their hash table, successors, alias tables and contexts
+ * starting a sentence) to a model file that can be loaded with the model file constructor.
+ * Throws a string exception if the file cannot be written.
+ * @param modelFile - string type, name of the file written.
+ */
+void NgramModel::saveModel(const string& modelFile) const {
+    ModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    header.version = NGRAM_MODEL_VERSION;
+    header.byteOrder = MODEL_BYTE_ORDER;
+    header.n = n;
+    header.probeMask = probeMask;
+    header.vocabularySize = numWords;
+    header.contextCount = numContexts;
+    header.successorCount = numSuccessorIds;
+    header.slotCount = (int64_t) 1 << (64 - slotShift);
+    header.wordSlotCount = (int64_t) 1 << (64 - wordSlotShift);
+    header.startCount = numStarts;
+    header.characterCount = wordOffsets[numWords];
+    header.imageSize = imageSizeFor(header);
+    ofstream out(modelFile.c_str(), ios::binary | ios::trunc);
+    out.write((const char*) &header, sizeof(header));
+    out.write((const char*) wordOffsets, sizeof(int64_t) * (numWords + 1));
+    out.write((const char*) contextIds, sizeof(int) * header.contextCount * (n - 1));
+    out.write((const char*) contextSlots, sizeof(int) * header.slotCount);
+    out.write((const char*) successorOffsets, sizeof(int) * (numContexts + 1));
+    out.write((const char*) successorIds, sizeof(int) * numSuccessorIds);
+    out.write((const char*) successorCounts, sizeof(int) * numSuccessorIds);
+    out.write((const char*) contextTotals, sizeof(int) * numContexts);
+    out.write((const char*) aliasThresholds, sizeof(int) * numSuccessorIds);
+    out.write((const char*) aliasIndexes, sizeof(int) * numSuccessorIds);
+    out.write((const char*) wordSlots, sizeof(int) * header.wordSlotCount);
+    out.write((const char*) startContexts, sizeof(int) * numStarts);
+    out.write((const char*) startOccurrences, sizeof(int) * numStarts);
+    out.write(wordCharacters, header.characterCount);
+    if (out) {
+        out.write("\0\0\0\0\0\0\0", header.imageSize - (size_t) out.tellp());
+    }
+    if (!out) {
+        throw EXCEPTION_MODEL_WRITE;
+    }
+}
+
+/** Method: order
+ * Usage: model.order()
+ * -----------------------------------------------------
+ * @return int type, N, the number of words of an N-gram (a context has N - 1).
+ */
+int NgramModel::order() const {
+    return n;
+}
+
+/** Method: vocabularySize
+ * Usage: model.vocabularySize()
+ * -----------------------------------------------------
+ * @return int type, number of distinct words of the text (ids go from 0 to vocabularySize() - 1).
+ */
+int NgramModel::vocabularySize() const {
+    return numWords;
+}
+
+/** Method: word
+ * Usage: model.word(id)
+ * -----------------------------------------------------
+ * @param id - int type, id of a word.
+ * @return const char* type, the word, a C string that lives as long as the model.
+ */
+const char* NgramModel::word(int id) const {
+    return wordCharacters + wordOffsets[id];
+}
+
+/** Method: wordId
+ * Usage: model.wordId(word)
+ * -----------------------------------------------------
+ * @param word - string type, word looked up (as it appears in the text).
+ * @return int type, id of word, -1 if it is not in the text.
+ */
+int NgramModel::wordId(const string& word) const {
+    return wordSlots[findWordSlot(word.data(), word.length())];
+}
+
+/** Method: contextCount
+ * Usage: model.contextCount()
+ * -----------------------------------------------------
+ * @return int type, number of distinct contexts of the text.
+ */
+int NgramModel::contextCount() const {
+    return numContexts;
+}
+
+/** Method: contextOccurrences
+ * Usage: model.contextOccurrences(context)
+ * -----------------------------------------------------
+ * @return int type, number of times context appears in the text (the total of the occurrences of
+ * its successors).
+ */
+int NgramModel::contextOccurrences(int context) const {
+    return contextTotals[context];
+}
+
+/** Method: findContext
+ * Usage: int context = model.findContext(ids)
+ * -----------------------------------------------------
+ * @param ids - const int* type, ids of the order() - 1 words of a context, in order.
+ * @return int type, number of the context, -1 if these words never follow each other in the text.
+ */
+int NgramModel::findContext(const int* ids) const {
+    return contextSlots[findSlot(ids, 0, contextHash(ids))];
+}
+
+/** Method: findContext
+ * Usage: int context = model.findContext(ring, head, hash)
+ * -----------------------------------------------------
+ * Same as findContext(ids) for the ids of a ring buffer of order() - 1 ids, whose first id is at
+ * position head (the ids are ring[head] .. ring[order() - 2], then ring[0] .. ring[head - 1]), and
+ * whose hash was already computed, by contextHash or rollHash.
+ * @param ring - const int* type, ring buffer of the ids of a context.
+ * @param head - int type, position of the first id in ring.
+ * @param hash - uint64_t type, contextHash of the ids in order.
+ * @return int type, number of the context, -1 if these words never follow each other in the text.
+ */
+int NgramModel::findContext(const int* ring, int head, uint64_t hash) const {
+    return contextSlots[findSlot(ring, head, hash)];
+}
+
+/** Method: contextHash
+ * Usage: uint64_t hash = model.contextHash(ids)
+ * -----------------------------------------------------
+ * Returns the hash of the order() - 1 ids of a context: the polynomial
+ * (ids[0] + 1) * B^(N - 2) + (ids[1] + 1) * B^(N - 3) + ... + (ids[N - 2] + 1), modulo 2^64, where B is
+ * HASH_BASE. Moving a window one word forward changes it with rollHash, in constant time.
+ * @param ids - const int* type, ids of the words of the context, in order.
+ * @return uint64_t type, hash of the context.
+ */
+uint64_t NgramModel::contextHash(const int* ids) const {
+    uint64_t hash = 0;
+    for (int i = 0; i < n - 1; i++) {
+        hash = hash * HASH_BASE + (uint32_t) ids[i] + 1;
+    }
+    return hash;
+}
+
+/** Method: rollHash
+ * Usage: hash = model.rollHash(hash, dropped, added)
+ * -----------------------------------------------------
+ * Returns the contextHash of a window moved one word forward: its first id, dropped, is removed and
+ * added is appended, without reading the other ids.
+ * @param hash - uint64_t type, contextHash of the window.
+ * @param dropped - int type, first id of the window.
+ * @param added - int type, id appended to the window.
+ * @return uint64_t type, hash of the new window.
+ */
+uint64_t NgramModel::rollHash(uint64_t hash, int dropped, int added) const {
+    return (hash - ((uint64_t) (uint32_t) dropped + 1) * highPower) * HASH_BASE + (uint32_t) added + 1;
+}
+
+/** Method: contextWords
+ * Usage: const int* ids = model.contextWords(context)
+ * -----------------------------------------------------
+ * @return const int* type, ids of the order() - 1 words of context, in order.
+ */
+const int* NgramModel::contextWords(int context) const {
+    return contextIds + (size_t) context * (n - 1);
+}
+
+/** Method: successorCount
+ * Usage: model.successorCount(context)
+ * -----------------------------------------------------
+ * @return int type, number of distinct words that follow context in the text (at least 1).
+ */
+int NgramModel::successorCount(int context) const {
+    return successorOffsets[context + 1] - successorOffsets[context];
+}
+
+/** Method: successor
+ * Usage: model.successor(context, index)
+ * -----------------------------------------------------
+ * @param index - int type, number of a successor of context, between 0 and successorCount(context) - 1.
+ * @return int type, id of the successor (successors are in increasing id order).
+ */
+int NgramModel::successor(int context, int index) const {
+    return successorIds[successorOffsets[context] + index];
+}
+
+/** Method: occurrences
+ * Usage: model.occurrences(context, index)
+ * -----------------------------------------------------
+ * @return int type, number of times the successor of number index follows context in the text.
+ */
+int NgramModel::occurrences(int context, int index) const {
+    return successorCounts[successorOffsets[context] + index];
+}
+
+/** Method: randomSuccessor
+ * Usage: int next = model.randomSuccessor(context)
+ * -----------------------------------------------------
+ * Draws a successor of context at random, each with probability proportional to the number of
+ * times it follows context in the text (as drawing one of the occurrences of context), in constant
+ * time with the alias table of context: a slot of the table is drawn, then a number below the
+ * total count of context picks the successor of the slot or its alias. A context with one
+ * successor needs no draw.
+ * @return int type, id of the successor drawn.
+ */
+int NgramModel::randomSuccessor(int context) const {
+    int begin = successorOffsets[context];
+    int numSuccessors = successorOffsets[context + 1] - begin;
+    if (numSuccessors == 1) {
+        return successorIds[begin];
+    }
+    int slot = begin + randomInteger(0, numSuccessors - 1);
+    if (randomInteger(0, contextTotals[context] - 1) < aliasThresholds[slot]) {
+        return successorIds[slot];
+    }
+    return successorIds[begin + aliasIndexes[slot]];
+}
+
+/** Method: sentenceStartCount
+ * Usage: model.sentenceStartCount()
+ * -----------------------------------------------------
+ * @return int type, number of contexts that start a sentence (whose first word starts with an
+ * uppercase letter).
+ */
+int NgramModel::sentenceStartCount() const {
+    return numStarts;
+}
+
+/** Method: randomSentenceStart
+ * Usage: int context = model.randomSentenceStart()
+ * -----------------------------------------------------
+ * Draws a context that starts a sentence at random, each as often as it appears in the text (as
+ * drawing one of the positions of the text that start a sentence), with a binary search in the
+ * running totals of their occurrences.
+ * @return int type, number of the context drawn, -1 if no context starts a sentence.
+ */
+int NgramModel::randomSentenceStart() const {
+    if (numStarts == 0) {
+        return -1;
+    }
+    int draw = randomInteger(0, startOccurrences[numStarts - 1] - 1);
+    return startContexts[upper_bound(startOccurrences, startOccurrences + numStarts, draw) - startOccurrences];
+}
+
+/** Method: setOrder
+ * Usage: setOrder(n)
+ * -----------------------------------------------------
+ * Sets N and the weight of the first id of a context in its hash.
+ */
+void NgramModel::setOrder(int n) {
+    this->n = n;
+    highPower = 1;
+    for (int i = 0; i < n - 2; i++) {
+        highPower *= HASH_BASE;
+    }
+}
+
+/** Method: findSlot
+ * Usage: int slot = findSlot(ring, head, hash)
+ * -----------------------------------------------------
+ * Returns the slot of the hash table holding the context made of the ids of ring starting at head
+ * (see findContext), or the empty slot where it would be added: linear probing from the slot given
+ * by the high bits of hash times SLOT_MULTIPLIER (the low bits of the polynomial hash only depend
+ * on the low bits of the ids), wrapping around at the end of the shard of the slot.
+ */
+int NgramModel::findSlot(const int* ring, int head, uint64_t hash) const {
+    int slot = (hash * SLOT_MULTIPLIER) >> slotShift;
+    int length = n - 1;
+    while (contextSlots[slot] != -1) {
+        const int* stored = contextWords(contextSlots[slot]);
+        if (equal(ring + head, ring + length, stored) && equal(ring, ring + head, stored + length - head)) {
+            break;
+        }
+        slot = (slot & ~probeMask) | ((slot + 1) & probeMask);
+    }
+    return slot;
+}
+
+/** Method: findWordSlot
+ * Usage: int slot = findWordSlot(word, length)
+ * -----------------------------------------------------
+ * Returns the slot of the word hash table holding the id of the word of length characters at word,
+ * or the empty slot where it would be added: linear probing from the slot given by the high bits
+ * of its FNV-1a hash times SLOT_MULTIPLIER.
+ */
+int NgramModel::findWordSlot(const char* word, size_t length) const {
+    uint64_t hash = WORD_HASH_BASIS;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char) word[i]) * HASH_BASE;
+    }
+    int mask = ((int64_t) 1 << (64 - wordSlotShift)) - 1;
+    int slot = (hash * SLOT_MULTIPLIER) >> wordSlotShift;
+    while (wordSlots[slot] != -1) {
+        int id = wordSlots[slot];
+        if ((size_t) (wordOffsets[id + 1] - wordOffsets[id] - 1) == length &&
+                memcmp(wordCharacters + wordOffsets[id], word, length) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/** Method: addContext
+ * Usage: int context = addContext(ids, hash)
+ * -----------------------------------------------------
+ * Returns the number of the context made of ids, whose contextHash is hash, adding it to the
+ * contexts if it is new. The hash table is doubled when it is half full.
+ */
+int NgramModel::addContext(const int* ids, uint64_t hash) {
+    int slot = findSlot(ids, 0, hash);
+    if (owned.contextSlots[slot] != -1) {
+        return owned.contextSlots[slot];
+    }
+    int context = owned.contextIds.size() / (n - 1);
+    owned.contextIds.insert(owned.contextIds.end(), ids, ids + n - 1);
+    owned.contextSlots[slot] = context;
+    attachArrays();
+    if (2 * (context + 1) > (int) owned.contextSlots.size()) {
+        growSlots();
+    }
+    return context;
+}
+
+/** Method: growSlots
+ * Usage: growSlots()
+ * -----------------------------------------------------
+ * Doubles the number of slots of the hash table and adds every context again.
+ */
+void NgramModel::growSlots() {
+    owned.contextSlots.assign(owned.contextSlots.size() * 2, -1);
+    attachArrays();
+    slotShift--;
+    probeMask = owned.contextSlots.size() - 1;
+    int numStored = owned.contextIds.size() / (n - 1);
+    for (int c = 0; c < numStored; c++) {
+        owned.contextSlots[findSlot(contextWords(c), 0, contextHash(contextWords(c)))] = c;
+    }
+}
+
+/** Method: readWords
+ * Usage: readWords(text, size, numThreads, textIds)
+ * -----------------------------------------------------
+ * Interns the words of text (separated by white space) and sets textIds to their ids, in order.
+ * The text is cut into numThreads pieces just after a white space character, so no word is cut,
+ * and every thread numbers the distinct words of its piece; the words of the pieces are then
+ * given ids in order of the pieces, which is their order of first appearance in the text, and
+ * every thread translates the words of its piece into ids.
+ */
+void NgramModel::readWords(const char* text, size_t size, int numThreads, vector<int>& textIds) {
+    vector<size_t> pieceStarts(numThreads + 1, size);
+    for (int t = 0; t < numThreads; t++) {
+        size_t start = size / numThreads * t;
+        while (start > 0 && start < size && !isspace((unsigned char) text[start - 1])) {
+            start++;
+        }
+        pieceStarts[t] = start;
+    }
+    vector<TextPiece> pieces(numThreads);
+    runThreads(numThreads, [&](int t) {
+        TextPiece& piece = pieces[t];
+        unordered_map<string, int> pieceIds;
+        string word;
+        size_t i = pieceStarts[t];
+        size_t end = pieceStarts[t + 1];
+        while (true) {
+            while (i < end && isspace((unsigned char) text[i])) {
+                i++;
+            }
+            if (i == end) {
+                return;
+            }
+            size_t begin = i;
+            while (i < end && !isspace((unsigned char) text[i])) {
+                i++;
+            }
+            word.assign(text + begin, i - begin);
+            auto found = pieceIds.find(word);
+            if (found == pieceIds.end()) {
+                found = pieceIds.emplace(word, piece.words.size()).first;
+                piece.words.push_back(word);
+            }
+            piece.ids.push_back(found->second);
+        }
+    });
+
+    vector<size_t> pieceOffsets(numThreads + 1, 0);
+    unordered_map<string, int> wordIds;
+    for (int t = 0; t < numThreads; t++) {
+        TextPiece& piece = pieces[t];
+        piece.globalIds.resize(piece.words.size());
+        for (size_t w = 0; w < piece.words.size(); w++) {
+            auto found = wordIds.find(piece.words[w]);
+            if (found == wordIds.end()) {
+                found = wordIds.emplace(piece.words[w], owned.vocabulary.size()).first;
+                owned.vocabulary.push_back(piece.words[w]);
+            }
+            piece.globalIds[w] = found->second;
+        }
+        pieceOffsets[t + 1] = pieceOffsets[t] + piece.ids.size();
+    }
+    textIds.resize(pieceOffsets[numThreads]);
+    runThreads(numThreads, [&](int t) {
+        const TextPiece& piece = pieces[t];
+        for (size_t i = 0; i < piece.ids.size(); i++) {
+            textIds[pieceOffsets[t] + i] = piece.globalIds[piece.ids[i]];
+        }
+    });
+}
+
+/** Method: countContexts
+ * Usage: countContexts(textIds, numThreads, allSuccessors)
+ * -----------------------------------------------------
+ * Numbers the contexts of the text (textIds, followed by its first n - 1 ids) in order of first
+ * appearance, fills contextIds, contextTotals and the hash table, and sets allSuccessors to the
+ * successor of every position grouped by context (the context c ones from successorOffsets[c]).
+ * The contexts are split in a power of 2 of shards, at least numThreads, by the high bits of their
+ * hash:
+ * - every thread hashes a range of positions (rolling the hash) and lists them by shard.
+ * - every thread numbers the contexts of its shards, in a hash table of its own, going through
+ * their positions in order, and marks the first position of every context.
+ * - a prefix sum over the marks gives the number of every context in the whole text.
+ * - every thread copies the contexts of its shards and adds them to their shard of the hash table,
+ * then places the successors of their positions.
+ */
+void NgramModel::countContexts(const vector<int>& textIds, int numThreads, vector<int>& allSuccessors) {
+    int textSize = textIds.size() - (n - 1);
+    int shardBits = 0;
+    while ((1 << shardBits) < numThreads) {
+        shardBits++;
+    }
+    int numShards = 1 << shardBits;
+    vector<uint64_t> mixedHashes(textSize);
+    vector<vector<vector<int>>> shardPositions(numThreads, vector<vector<int>>(numShards));
+    runThreads(numThreads, [&](int t) {
+        int end = rangeStart(textSize, t + 1, numThreads);
+        int p = rangeStart(textSize, t, numThreads);
+        uint64_t hash = p < end ? contextHash(&textIds[p]) : 0;
+        for (; p < end; p++) {
+            uint64_t mixed = hash * SLOT_MULTIPLIER;
+            mixedHashes[p] = mixed;
+            shardPositions[t][shardBits == 0 ? 0 : mixed >> (64 - shardBits)].push_back(p);
+            hash = rollHash(hash, textIds[p], textIds[p + n - 1]);
+        }
+    });
+
+    // number the contexts of every shard, and mark their first positions
+    vector<ContextShard> shards(numShards);
+    vector<int> positionContexts(textSize);
+    vector<int> firstNumbers(textSize, 0);
+    runThreads(numThreads, [&](int t) {
+        for (int s = t; s < numShards; s += numThreads) {
+            ContextShard& shard = shards[s];
+            int tableBits = __builtin_ctz(INITIAL_CONTEXT_SLOTS);
+            vector<int> table(INITIAL_CONTEXT_SLOTS, -1);
+            for (int from = 0; from < numThreads; from++) {
+                for (int p : shardPositions[from][s]) {
+                    int mask = table.size() - 1;
+                    int slot = (mixedHashes[p] << shardBits) >> (64 - tableBits);
+                    while (table[slot] != -1 && !equal(&textIds[p], &textIds[p] + n - 1,
+                                                       &textIds[shard.firstPositions[table[slot]]])) {
+                        slot = (slot + 1) & mask;
+                    }
+                    if (table[slot] == -1) {
+                        table[slot] = shard.firstPositions.size();
+                        shard.firstPositions.push_back(p);
+                        shard.counts.push_back(0);
+                        firstNumbers[p] = 1;
+                    }
+                    positionContexts[p] = table[slot];
+                    shard.counts[table[slot]]++;
+                    if (2 * shard.firstPositions.size() > table.size()) {
+                        tableBits++;
+                        table.assign(table.size() * 2, -1);
+                        for (int local = 0; local < (int) shard.firstPositions.size(); local++) {
+                            int moved = (mixedHashes[shard.firstPositions[local]] << shardBits) >> (64 - tableBits);
+                            while (table[moved] != -1) {
+                                moved = (moved + 1) & (table.size() - 1);
+                            }
+                            table[moved] = local;
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // number the contexts in order of first appearance: prefix sum of the marks
+    vector<int> rangeFirsts(numThreads + 1, 0);
+    runThreads(numThreads, [&](int t) {
+        int end = rangeStart(textSize, t + 1, numThreads);
+        for (int p = rangeStart(textSize, t, numThreads); p < end; p++) {
+            rangeFirsts[t + 1] += firstNumbers[p];
+        }
+    });
+    for (int t = 0; t < numThreads; t++) {
+        rangeFirsts[t + 1] += rangeFirsts[t];
+    }
+    runThreads(numThreads, [&](int t) {
+        int next = rangeFirsts[t];
+        int end = rangeStart(textSize, t + 1, numThreads);
+        for (int p = rangeStart(textSize, t, numThreads); p < end; p++) {
+            if (firstNumbers[p] != 0) {
+                firstNumbers[p] = next++;
+            }
+        }
+    });
+    numContexts = rangeFirsts[numThreads];
+
+    // copy the contexts and fill the shards of the hash table (each twice the size of the largest shard)
+    size_t largestShard = 0;
+    for (const ContextShard& shard : shards) {
+        largestShard = max(largestShard, shard.firstPositions.size());
+    }
+    int shardSlots = max(INITIAL_CONTEXT_SLOTS >> shardBits, 1);
+    while (shardSlots < 2 * (int) largestShard) {
+        shardSlots *= 2;
+    }
+    owned.contextSlots.assign((size_t) shardSlots * numShards, -1);
+    slotShift = 64 - __builtin_ctz(owned.contextSlots.size());
+    probeMask = shardSlots - 1;
+    owned.contextIds.resize((size_t) numContexts * (n - 1));
+    owned.contextTotals.resize(numContexts);
+    attachArrays();
+    runThreads(numThreads, [&](int t) {
+        for (int s = t; s < numShards; s += numThreads) {
+            ContextShard& shard = shards[s];
+            shard.contexts.resize(shard.firstPositions.size());
+            for (size_t local = 0; local < shard.firstPositions.size(); local++) {
+                int first = shard.firstPositions[local];
+                int context = firstNumbers[first];
+                shard.contexts[local] = context;
+                copy(&textIds[first], &textIds[first] + n - 1, owned.contextIds.begin() + (size_t) context * (n - 1));
+                owned.contextTotals[context] = shard.counts[local];
+                owned.contextSlots[findSlot(&textIds[first], 0, contextHash(&textIds[first]))] = context;
+            }
+        }
+    });
+
+    // place the successor of every position in the range of its context
+    owned.successorOffsets.assign(numContexts + 1, 0);
+    for (int c = 0; c < numContexts; c++) {
+        owned.successorOffsets[c + 1] = owned.successorOffsets[c] + owned.contextTotals[c];
+    }
+    vector<int> nextFree(owned.successorOffsets.begin(), owned.successorOffsets.end() - 1);
+    allSuccessors.resize(textSize);
+    runThreads(numThreads, [&](int t) {
+        for (int s = t; s < numShards; s += numThreads) {
+            const ContextShard& shard = shards[s];
+            for (int from = 0; from < numThreads; from++) {
+                for (int p : shardPositions[from][s]) {
+                    allSuccessors[nextFree[shard.contexts[positionContexts[p]]]++] = textIds[p + n - 1];
+                }
+            }
+        }
+    });
+}
+
+/** Method: mergeSuccessors
+ * Usage: mergeSuccessors(allSuccessors, numThreads)
+ * -----------------------------------------------------
+ * Sorts the successors of every context (allSuccessors from successorOffsets[c], contextTotals[c]
+ * of them), merges the repeated ones into counts, stores them in successorIds and successorCounts
+ * and computes the alias table of every context. The contexts are split into numThreads ranges
+ * of about as many successors, sorted and merged in place by their thread; after a prefix sum of
+ * the numbers of distinct successors every thread copies its range and computes its alias tables.
+ */
+void NgramModel::mergeSuccessors(vector<int>& allSuccessors, int numThreads) {
+    int textSize = allSuccessors.size();
+    vector<int> rangeContexts(numThreads + 1, numContexts);
+    for (int t = 0; t < numThreads; t++) {
+        rangeContexts[t] = lower_bound(owned.successorOffsets.begin(), owned.successorOffsets.end() - 1,
+                                       rangeStart(textSize, t, numThreads)) - owned.successorOffsets.begin();
+    }
+    vector<int> allCounts(textSize);
+    vector<int> numDistinct(numContexts);
+    runThreads(numThreads, [&](int t) {
+        for (int c = rangeContexts[t]; c < rangeContexts[t + 1]; c++) {
+            int begin = owned.successorOffsets[c];
+            int end = owned.successorOffsets[c + 1];
+            sort(allSuccessors.begin() + begin, allSuccessors.begin() + end);
+            int last = begin - 1;
+            for (int i = begin; i < end; i++) {
+                if (last < begin || allSuccessors[i] != allSuccessors[last]) {
+                    last++;
+                    allSuccessors[last] = allSuccessors[i];
+                    allCounts[last] = 0;
+                }
+                allCounts[last]++;
+            }
+            numDistinct[c] = last + 1 - begin;
+        }
+    });
+
+    vector<int> sortedOffsets(owned.successorOffsets);
+    for (int c = 0; c < numContexts; c++) {
+        owned.successorOffsets[c + 1] = owned.successorOffsets[c] + numDistinct[c];
+    }
+    owned.successorIds.resize(owned.successorOffsets[numContexts]);
+    owned.successorCounts.resize(owned.successorOffsets[numContexts]);
+    owned.aliasThresholds.resize(owned.successorOffsets[numContexts]);
+    owned.aliasIndexes.resize(owned.successorOffsets[numContexts]);
+    runThreads(numThreads, [&](int t) {
+        vector<int64_t> weights;
+        vector<int> small;
+        vector<int> large;
+        for (int c = rangeContexts[t]; c < rangeContexts[t + 1]; c++) {
+            copy(allSuccessors.begin() + sortedOffsets[c], allSuccessors.begin() + sortedOffsets[c] + numDistinct[c],
+                 owned.successorIds.begin() + owned.successorOffsets[c]);
+            copy(allCounts.begin() + sortedOffsets[c], allCounts.begin() + sortedOffsets[c] + numDistinct[c],
+                 owned.successorCounts.begin() + owned.successorOffsets[c]);
+            buildAliasTable(c, weights, small, large);
+        }
+    });
+}
+
+/** Method: buildAliasTable
+ * Usage: buildAliasTable(context, weights, small, large)
+ * -----------------------------------------------------
+ * Computes the alias table of context from the counts of its successors. With k successors and a
+ * total count T, successor i has weight count * k, and every slot must end up holding a weight of
+ * exactly T: the slots whose weight is below T (small) are filled up to T by a slot whose weight is
+ * at least T (large), which becomes their alias and loses what it gave. Successor i is then drawn
+ * with probability count / T exactly. weights, small and large are work space reused between contexts.
+ */
+void NgramModel::buildAliasTable(int context, vector<int64_t>& weights, vector<int>& small, vector<int>& large) {
+    int begin = owned.successorOffsets[context];
+    int numSuccessors = owned.successorOffsets[context + 1] - begin;
+    int64_t total = owned.contextTotals[context];
+    weights.resize(numSuccessors);
+    small.clear();
+    large.clear();
+    for (int i = 0; i < numSuccessors; i++) {
+        weights[i] = (int64_t) owned.successorCounts[begin + i] * numSuccessors;
+        if (weights[i] < total) {
+            small.push_back(i);
+        } else {
+            large.push_back(i);
+        }
+    }
+    while (!small.empty() && !large.empty()) {
+        int below = small.back();
+        small.pop_back();
+        int above = large.back();
+        owned.aliasThresholds[begin + below] = weights[below];
+        owned.aliasIndexes[begin + below] = above;
+        weights[above] -= total - weights[below];
+        if (weights[above] < total) {
+            large.pop_back();
+            small.push_back(above);
+        }
+    }
+    // the slots left have a weight of exactly T (the weights add up to k * T)
+    for (int i : large) {
+        owned.aliasThresholds[begin + i] = total;
+        owned.aliasIndexes[begin + i] = i;
+    }
+    for (int i : small) {
+        owned.aliasThresholds[begin + i] = total;
+        owned.aliasIndexes[begin + i] = i;
+    }
+}
+
+/** Method: finishModel
+ * Usage: finishModel()
+ * -----------------------------------------------------
+ * Last step of building a model, once its successors are merged: lays out the words as C strings
+ * one after the other with their offsets and builds the hash table of their ids (twice as many
+ * slots as words), finds the contexts that start a sentence, and points the array pointers at
+ * the arrays.
+ */
+void NgramModel::finishModel() {
+    numWords = owned.vocabulary.size();
+    numContexts = owned.contextTotals.size();
+    numSuccessorIds = owned.successorIds.size();
+    owned.wordOffsets.resize(numWords + 1);
+    for (int id = 0; id < numWords; id++) {
+        owned.wordOffsets[id] = owned.wordCharacters.size();
+        const string& word = owned.vocabulary[id];
+        owned.wordCharacters.insert(owned.wordCharacters.end(), word.begin(), word.end());
+        owned.wordCharacters.push_back('\0');
+    }
+    owned.wordOffsets[numWords] = owned.wordCharacters.size();
+    vector<string>().swap(owned.vocabulary);
+    int wordSlotBits = 1;
+    while ((1 << wordSlotBits) < 2 * numWords) {
+        wordSlotBits++;
+    }
+    owned.wordSlots.assign(1 << wordSlotBits, -1);
+    wordSlotShift = 64 - wordSlotBits;
+    attachArrays();
+    for (int id = 0; id < numWords; id++) {
+        owned.wordSlots[findWordSlot(word(id), wordOffsets[id + 1] - wordOffsets[id] - 1)] = id;
+    }
+
+    int total = 0;
+    for (int c = 0; c < numContexts; c++) {
+        char first = word(contextWords(c)[0])[0];
+        if (isalpha((unsigned char) first) && first == toupper(first)) {
+            total += owned.contextTotals[c];
+            owned.startContexts.push_back(c);
+            owned.startOccurrences.push_back(total);
+        }
+    }
+    numStarts = owned.startContexts.size();
+    attachArrays();
+}
+
+/** Method: attachArrays
+ * Usage: attachArrays()
+ * -----------------------------------------------------
+ * Points the array pointers at the vectors of owned, after they were resized.
+ */
+void NgramModel::attachArrays() {
+    wordOffsets = owned.wordOffsets.data();
+    wordCharacters = owned.wordCharacters.data();
+    wordSlots = owned.wordSlots.data();
+    contextIds = owned.contextIds.data();
+    contextSlots = owned.contextSlots.data();
+    successorOffsets = owned.successorOffsets.data();
+    successorIds = owned.successorIds.data();
+    successorCounts = owned.successorCounts.data();
+    contextTotals = owned.contextTotals.data();
+    aliasThresholds = owned.aliasThresholds.data();
+    aliasIndexes = owned.aliasIndexes.data();
+    startContexts = owned.startContexts.data();
+    startOccurrences = owned.startOccurrences.data();
+}
+
+/** Method: attachImage
+ * Usage: attachImage(image)
+ * -----------------------------------------------------
+ * Points the array pointers at their sections of the image of a model file, using the counts in
+ * its header.
+ */
+void NgramModel::attachImage(char* image) {
+    const ModelHeader* header = (const ModelHeader*) image;
+    setOrder(header->n);
+    probeMask = header->probeMask;
+    slotShift = 64 - __builtin_ctzll(header->slotCount);
+    wordSlotShift = 64 - __builtin_ctzll(header->wordSlotCount);
+    numWords = header->vocabularySize;
+    numContexts = header->contextCount;
+    numSuccessorIds = header->successorCount;
+    numStarts = header->startCount;
+    char* section = image + sizeof(ModelHeader);
+    wordOffsets = (const int64_t*) section;
+    section += sizeof(int64_t) * (numWords + 1);
+    contextIds = (const int*) section;
+    section += sizeof(int) * (size_t) numContexts * (n - 1);
+    contextSlots = (const int*) section;
+    section += sizeof(int) * header->slotCount;
+    successorOffsets = (const int*) section;
+    section += sizeof(int) * (numContexts + 1);
+    successorIds = (const int*) section;
+    section += sizeof(int) * numSuccessorIds;
+    successorCounts = (const int*) section;
+    section += sizeof(int) * numSuccessorIds;
+    contextTotals = (const int*) section;
+    section += sizeof(int) * numContexts;
+    aliasThresholds = (const int*) section;
+    section += sizeof(int) * numSuccessorIds;
+    aliasIndexes = (const int*) section;
+    section += sizeof(int) * numSuccessorIds;
+    wordSlots = (const int*) section;
+    section += sizeof(int) * header->wordSlotCount;
+    startContexts = (const int*) section;
+    section += sizeof(int) * numStarts;
+    startOccurrences = (const int*) section;
+    section += sizeof(int) * numStarts;
+    wordCharacters = (const char*) section;
+}
+
+/** Method: validArrays
+ * Usage: if (validArrays(header)) ...
+ * -----------------------------------------------------
+ * Checks the arrays of a model attached to the image of a model file with header: word offsets
+ * increase from 0 to the number of characters and every word ends with a NUL character, ids and context numbers
+ * (in contexts, hash tables, successors, alias tables and sentence starts) are in range, every
+ * context has successors and occurrences, and running totals of sentence starts increase. Hash
+ * tables must have an empty slot in every shard, so that probing stops.
+ * @return bool type, true if the arrays are consistent.
+ */
+bool NgramModel::validArrays(const ModelHeader& header) const {
+    if (wordOffsets[0] != 0 || wordOffsets[numWords] != header.characterCount) {
+        return false;
+    }
+    for (int id = 0; id < numWords; id++) {
+        if (wordOffsets[id + 1] <= wordOffsets[id] || wordOffsets[id + 1] > header.characterCount) {
+            return false;
+        }
+        if (wordCharacters[wordOffsets[id + 1] - 1] != '\0') {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < (size_t) numContexts * (n - 1); i++) {
+        if (contextIds[i] < 0 || contextIds[i] >= numWords) {
+            return false;
+        }
+    }
+    int numSlots = 1 << (64 - slotShift);
+    for (int shard = 0; shard < numSlots; shard += probeMask + 1) {
+        bool emptySlot = false;
+        for (int slot = shard; slot <= shard + probeMask; slot++) {
+            if (contextSlots[slot] < -1 || contextSlots[slot] >= numContexts) {
+                return false;
+            }
+            emptySlot = emptySlot || contextSlots[slot] == -1;
+        }
+        if (!emptySlot) {
+            return false;
+        }
+    }
+    if (successorOffsets[0] != 0 || successorOffsets[numContexts] != numSuccessorIds) {
+        return false;
+    }
+    for (int c = 0; c < numContexts; c++) {
+        int begin = successorOffsets[c];
+        int numSuccessors = successorOffsets[c + 1] - begin;
+        if (numSuccessors < 1 || successorOffsets[c + 1] > numSuccessorIds || contextTotals[c] < 1) {
+            return false;
+        }
+        for (int slot = begin; slot < begin + numSuccessors; slot++) {
+            if (successorIds[slot] < 0 || successorIds[slot] >= numWords || successorCounts[slot] < 1 ||
+                    aliasIndexes[slot] < 0 || aliasIndexes[slot] >= numSuccessors) {
+                return false;
+            }
+        }
+    }
+    int numWordSlots = 1 << (64 - wordSlotShift);
+    bool emptyWordSlot = false;
+    for (int slot = 0; slot < numWordSlots; slot++) {
+        if (wordSlots[slot] < -1 || wordSlots[slot] >= numWords) {
+            return false;
+        }
+        emptyWordSlot = emptyWordSlot || wordSlots[slot] == -1;
+    }
+    if (!emptyWordSlot) {
+        return false;
+    }
+    for (int s = 0; s < numStarts; s++) {
+        if (startContexts[s] < 0 || startContexts[s] >= numContexts ||
+                startOccurrences[s] <= (s == 0 ? 0 : startOccurrences[s - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Method: imageSizeFor
+ * Usage: imageSizeFor(header)
+ * -----------------------------------------------------
+ * @return size_t type, number of bytes of the image of a model with the counts of header, rounded
+ * up to a multiple of 8 bytes.
+ */
+size_t NgramModel::imageSizeFor(const ModelHeader& header) {
+    size_t size = sizeof(ModelHeader) + sizeof(int64_t) * (header.vocabularySize + 1) +
+                  sizeof(int) * (header.contextCount * (header.n - 1) + header.slotCount + 2 * header.contextCount + 1 +
+                                 4 * header.successorCount + header.wordSlotCount + 2 * header.startCount) +
+                  header.characterCount;
+    return (size + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+}
+
+/* Function: runThreads()
+ * Usage: runThreads(numThreads, body)
+ * -----------------------------------------------------------------------------
+ * Runs body(0) .. body(numThreads - 1) each in its own thread, body(0) in the calling thread, and
+ * returns when all of them are done.
+ */
+static void runThreads(int numThreads, const function<void(int)>& body) {
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) {
+        workers.push_back(thread(body, t));
+    }
+    body(0);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/* Function: rangeStart()
+ * Usage: int begin = rangeStart(size, part, numParts)
+ * -----------------------------------------------------------------------------
+ * Returns the first index of range number part when indexes 0 .. size - 1 are cut into numParts
+ * ranges of (almost) the same size; rangeStart(size, numParts, numParts) is size.
+ */
+static int rangeStart(int size, int part, int numParts) {
+    return (int64_t) size * part / numParts;
+}
@@ -0,0 +1,155 @@
+/*
+ * File: NgramModel.h
+ * ------------------
+ * This file declares the NgramModel class, the N-gram model of a text used by the Random Writer:
+ * for every window of N - 1 consecutive words of the text (a context), the words that follow it and
+ * how many times each does. The text is read as if its end were followed by its beginning, so every
+ * context has at least one successor.
+ * Words are interned: every distinct word gets a number (its id, in order of first appearance) and
+ * the model only stores ids. A context is N - 1 ids stored next to each other, found with an
+ * open-addressing hash table of context numbers, with a polynomial hash that can be rolled: moving
+ * a window of ids one word forward updates its hash in constant time; the successors of all the
+ * contexts are stored in one array, those of context c at successorOffsets[c] ..
+ * successorOffsets[c + 1] - 1, each successor once with its count. Building the model takes time
+ * proportional to the length of the text and a few integers per word, instead of a vector of
+ * strings per window.
+ * Every context also has an alias table over its successors (Walker's alias method): each successor
+ * slot holds a threshold and a second successor, so drawing a successor with probability
+ * proportional to its count takes one draw of a slot and one draw against its threshold, whatever
+ * the number of successors, without copying anything.
+ * A model can also be built straight from a text file with several threads: the file is
+ * memory-mapped and cut at spaces into one piece per thread, each thread interns the words of its
+ * piece, then the contexts are counted in shards (a context belongs to the shard given by the high
+ * bits of its hash, and each shard is one region of the hash table, so threads never share a
+ * slot), and the successors of the contexts are merged in ranges of contexts. Words and contexts
+ * are numbered in order of first appearance whatever the number of threads, so the model is the
+ * same as the one built from the words of the file.
+ * A built model can be saved to a binary model file with saveModel and memory-mapped back with the
+ * model file constructor, without reading the text again or parsing anything, in time independent
+ * of the size of the text: all the arrays of the model, including the words (one string of
+ * characters and their offsets) and a hash table of word ids, are sections of the file, and the
+ * pages of the file are only loaded from disk when they are used. The contexts that start a
+ * sentence are also stored, so the Random Writer can draw its starting window right away.
+ * A NgramModel is never changed after it is built.
+ */
+
+#ifndef _ngrammodel_h
+#define _ngrammodel_h
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+/* Version of the model file format written by saveModel */
+const uint32_t NGRAM_MODEL_VERSION = 1;
+
+class NgramModel {
+public:
+    NgramModel(const vector<string>& words, int n);
+    NgramModel(const string& textFile, int n, int numThreads);
+    NgramModel(const string& modelFile);
+    ~NgramModel();
+    void saveModel(const string& modelFile) const;
+    int order() const;
+    int vocabularySize() const;
+    const char* word(int id) const;
+    int wordId(const string& word) const;
+    int contextCount() const;
+    int contextOccurrences(int context) const;
+    int findContext(const int* ids) const;
+    int findContext(const int* ring, int head, uint64_t hash) const;
+    uint64_t contextHash(const int* ids) const;
+    uint64_t rollHash(uint64_t hash, int dropped, int added) const;
+    const int* contextWords(int context) const;
+    int successorCount(int context) const;
+    int successor(int context, int index) const;
+    int occurrences(int context, int index) const;
+    int randomSuccessor(int context) const;
+    int sentenceStartCount() const;
+    int randomSentenceStart() const;
+
+private:
+    /* First bytes of a model file. The arrays follow it, 8-byte ones first so that every array is
+     * naturally aligned: word offsets, context ids, context slots, successor offsets, successor
+     * ids, successor counts, context totals, alias thresholds, alias indexes, word slots, sentence
+     * start contexts, sentence start occurrences, word characters. */
+    struct ModelHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        int32_t n;
+        int32_t probeMask;
+        int64_t vocabularySize;
+        int64_t contextCount;
+        int64_t successorCount;
+        int64_t slotCount;
+        int64_t wordSlotCount;
+        int64_t startCount;
+        int64_t characterCount;
+        uint64_t imageSize;
+    };
+
+    /* Arrays of a model built in memory, which the array pointers point to */
+    struct ModelArrays {
+        vector<string> vocabulary;              // word of every id, while the model is built
+        vector<int64_t> wordOffsets;
+        vector<char> wordCharacters;
+        vector<int> wordSlots;
+        vector<int> contextIds;
+        vector<int> contextSlots;
+        vector<int> successorOffsets;
+        vector<int> successorIds;
+        vector<int> successorCounts;
+        vector<int> contextTotals;
+        vector<int> aliasThresholds;
+        vector<int> aliasIndexes;
+        vector<int> startContexts;
+        vector<int> startOccurrences;
+    };
+
+    // instance variables
+    int n;
+    uint64_t highPower;                         // HASH_BASE to the power n - 2, weight of the first id in a hash
+    int slotShift;                              // 64 - log2 of the number of slots
+    int probeMask;                              // slots of a shard - 1 (probing wraps around in a shard)
+    int wordSlotShift;                          // 64 - log2 of the number of word slots
+    int numWords;
+    int numContexts;
+    int numSuccessorIds;
+    int numStarts;
+    const int64_t* wordOffsets;                 // word i is the C string at wordCharacters + wordOffsets[i]
+    const char* wordCharacters;
+    const int* wordSlots;                       // hash table of word ids, -1 for an empty slot
+    const int* contextIds;                      // ids of context c are contextIds[c * (n - 1) .. (c + 1) * (n - 1))
+    const int* contextSlots;                    // hash table of context numbers, -1 for an empty slot
+    const int* successorOffsets;                // successors of context c are successorIds[successorOffsets[c] ..
+    const int* successorIds;                    // successorOffsets[c + 1]), in increasing id order
+    const int* successorCounts;                 // times every successor follows its context
+    const int* contextTotals;                   // times every context appears in the text
+    const int* aliasThresholds;                 // slot i of a context keeps its successor if a draw
+    const int* aliasIndexes;                    // below contextTotals is below aliasThresholds[i], else
+                                                // takes successor aliasIndexes[i] of the context
+    const int* startContexts;                   // contexts whose first word starts with an uppercase letter
+    const int* startOccurrences;                // occurrences of startContexts[0 .. i], for every i
+    ModelArrays owned;                          // arrays of a model built in memory
+    void* mappedImage;                          // image of a model loaded from a model file
+    size_t mappedSize;
+    NgramModel(const NgramModel& other);
+    NgramModel& operator=(const NgramModel& other);
+    void setOrder(int n);
+    int findSlot(const int* ring, int head, uint64_t hash) const;
+    int findWordSlot(const char* word, size_t length) const;
+    int addContext(const int* ids, uint64_t hash);
+    void growSlots();
+    void readWords(const char* text, size_t size, int numThreads, vector<int>& textIds);
+    void countContexts(const vector<int>& textIds, int numThreads, vector<int>& allSuccessors);
+    void mergeSuccessors(vector<int>& allSuccessors, int numThreads);
+    void buildAliasTable(int context, vector<int64_t>& weights, vector<int>& small, vector<int>& large);
+    void finishModel();
+    void attachArrays();
+    void attachImage(char* image);
+    bool validArrays(const ModelHeader& header) const;
+    static size_t imageSizeFor(const ModelHeader& header);
+};
+
+#endif // _ngrammodel_h
@@ -15,9 +15,27 @@
  * This file contains the following extension functionality: path found is printed in the console as a list
  * of edges with cost for BFS, Dijkstra or A* algorithms ONLY (console printing is not supported for Alt path algorithm).
  * Please refer to submission #5 in paperless for core functionality.
+ * Dijkstra's algorithm and A* are also implemented over a RoadGraphIndex (indexedDijkstrasorAstar),
+ * which searches node ids and flat arrays and can run on a graph memory-mapped from a snapshot file.
+ * Every search fills a SearchStats with its counters (nodes settled, edges relaxed, queue pushes
+ * and pops, largest frontier, duplicate pops, wall time); dijkstrasAlgorithm, aStar and
+ * alternativeRoute record them in searchStatsRegistry() for export.
+ * shortestDistances runs Dijkstra's algorithm over a RoadGraphIndex without a destination, until
+ * every node reachable from the source is settled, and returns the cost of the path to every node.
+ * Isochrone queries (reachableWithin) return every node reachable from a start node within one or
+ * several cost budgets, with a single Dijkstra search stopped at the largest budget.
  *
  */
 #include "Trailblazer.h"
+#include "PathfindingAlgos.h"
+#include "RoutingStats.h"
+#include "map.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
 #include "queue.h"
 #include "RoadGraph.h"
 #include "pqueue.h"
@@ -25,14 +43,19 @@
 using namespace std;
  
 static const double SUFFICIENT_DIFFERENCE = 0.2;
+
+/* Text for string exceptions */
+const string EXCEPTION_BAD_NODE_ID = "Node id is not in the index";
 /* Function prototypes */
-Path dijkstrasorAstar(const RoadGraph& graph, RoadNode* start, RoadNode* end, bool withheuristic, RoadEdge* toignore, double &priority);
+Path dijkstrasorAstar(const RoadGraph& graph, RoadNode* start, RoadNode* end, bool withheuristic, RoadEdge* toignore, double &priority,
+                      SearchStats &stats);
 bool nodeInAltPath(RoadNode* node, Path altpath);
 double calculatePercentageDifference (Path bestPath, Path candidatePath);
 void markPointVisited(RoadNode *node, Set<RoadNode*> &visitedPoints);
 void exploreNeighbor(const Set<RoadNode*> &visitedPoints, RoadNode* node, RoadEdge* toignore, bool withheurisic,
                      PriorityQueue<Path> &queueofPaths, RoadNode* lastnode, const RoadGraph &graph, Path temp,
-                     double currentPriority, RoadNode* end);
+                     double currentPriority, RoadNode* end, SearchStats &stats);
+static double elapsedMillis(chrono::steady_clock::time_point since);
 void  printPathInfo(Path temp);
  
 /* Function: breadthFirstSearch()
@@ -148,7 +171,7 @@ void markPointVisited(RoadNode *node, Set<RoadNode*> &visitedPoints) {
 }
  
 /* Function: dijkstrasorAstar()
- * Usage: dijstrasorAstar(graph, start, end, withheuristic, toignore, priority)
+ * Usage: dijstrasorAstar(graph, start, end, withheuristic, toignore, priority, stats)
  * -----------------------------------------------------------------------------
  * Searches the given graph for the shortest path from the given start vertex to the given end vertex. If a
  * path is found, it is returned as a list of vertexes along that path, with the starting vertex
@@ -175,11 +198,13 @@ void markPointVisited(RoadNode *node, Set<RoadNode*> &visitedPoints) {
  * if false, Dijkstra's algorithm will be used to search for a path.
  * @param: toignore, type RoadEdge* - edge to ignore while calculating an alternative route
  * @param: priority - type double - priority of the path being returned by this function (if path exists).
+ * @param: stats - type SearchStats - counters of the search, incremented by this function (a path
+ * dequeued for a node that was already visited counts as a duplicate pop).
  * @return: pathFound, type Path. Lists the edges (RoadNode*) between the start and end vertex for
  * the path found if a path was found, empty if not path was found.
  */
 Path dijkstrasorAstar(const RoadGraph& graph, RoadNode* start, RoadNode* end, bool withheuristic,
-                      RoadEdge* toignore, double &priority) {
+                      RoadEdge* toignore, double &priority, SearchStats &stats) {
     Path pathFound;
     if (start == end) {
         pathFound.add(start);
@@ -192,12 +217,20 @@ Path dijkstrasorAstar(const RoadGraph& graph, RoadNode* start, RoadNode* end, bo
         Path startPath;
         startPath.add(start);
         queueofPaths.enqueue(startPath, 0);
+        stats.heapPushes++;
+        stats.maxFrontier = max(stats.maxFrontier, 1L);
         Set<RoadNode*> visitedPoints;
         markPointVisited(start, visitedPoints);
         while (!queueofPaths.isEmpty()) {
             double currentPriority = queueofPaths.peekPriority();
             Path temp = queueofPaths.dequeue();
             RoadNode* lastnode = temp[temp.size() - 1];
+            stats.heapPops++;
+            if (lastnode != start && visitedPoints.contains(lastnode)) {
+                stats.duplicatePops++;
+            } else {
+                stats.nodesSettled++;
+            }
             markPointVisited(lastnode, visitedPoints);
             if (lastnode == end) {
                 priority = currentPriority;
@@ -209,8 +242,9 @@ Path dijkstrasorAstar(const RoadGraph& graph, RoadNode* start, RoadNode* end, bo
             Set<RoadNode *> neighbors = graph.neighborsOf(lastnode);
             for (RoadNode* node: neighbors) {
                 exploreNeighbor(visitedPoints, node, toignore, withheuristic, queueofPaths, lastnode, graph,
-                                temp, currentPriority, end);
+                                temp, currentPriority, end, stats);
             }
+            stats.maxFrontier = max(stats.maxFrontier, (long) queueofPaths.size());
         }
     }
     if (toignore == NULL) {
@@ -221,7 +255,7 @@ Path dijkstrasorAstar(const RoadGraph& graph, RoadNode* start, RoadNode* end, bo
  
  
 /* Function: exploreNeighbor()
- * Usage: exploreNeighbor(visitedPoints, node, toignore, withheuristic, queueofPaths, lastnode, graph, temp, currentPriority, end);
+ * Usage: exploreNeighbor(visitedPoints, node, toignore, withheuristic, queueofPaths, lastnode, graph, temp, currentPriority, end, stats);
  * ----------------------------------------------------------------------------
  * Examines node (lastnode neighbor) being passed as parameter, creates a new path with it if unvisited,
  * and enqueues the new path with the corresponding priority. Priority calculation is determined by parameter
@@ -243,11 +277,13 @@ Path dijkstrasorAstar(const RoadGraph& graph, RoadNode* start, RoadNode* end, bo
  * @param: temp, type Path, path being used as starting point to create a new path that includes node
  * (if node not visited).
  * @param: end, type RoadNode*, destination node for our path in calling function.
+ * @param: stats, type SearchStats, counters of the search in the calling function (edges relaxed
+ * and queue pushes are incremented when the new path is enqueued).
  * Note: this decomposition was suggested by Chris.
  */
 void exploreNeighbor(const Set<RoadNode*> &visitedPoints, RoadNode* node, RoadEdge* toignore, bool withheuristic,
                      PriorityQueue<Path> &queueofPaths, RoadNode* lastnode, const RoadGraph &graph, Path temp,
-                     double currentPriority, RoadNode* end) {
+                     double currentPriority, RoadNode* end, SearchStats &stats) {
         if (!visitedPoints.contains(node)) {
             Path newPath = temp;
             newPath.add(node);
@@ -264,6 +300,8 @@ void exploreNeighbor(const Set<RoadNode*> &visitedPoints, RoadNode* node, RoadEd
                     newpriority = currentPriority - toRemove + edge->cost() + newEstimate;
                 }
                 queueofPaths.enqueue(newPath, newpriority);
+                stats.edgesRelaxed++;
+                stats.heapPushes++;
            }
         }
 }
@@ -285,12 +323,31 @@ void exploreNeighbor(const Set<RoadNode*> &visitedPoints, RoadNode* node, RoadEd
  * the path found if a path was found, empty if not path was found.
  */
 Path dijkstrasAlgorithm(const RoadGraph& graph, RoadNode* start, RoadNode* end) {
+    SearchStats stats;
+    return dijkstrasAlgorithm(graph, start, end, stats);
+}
+
+/* Function: dijkstrasAlgorithm()
+ * Usage: dijkstrasAlgorithm(graph, start, end, stats)
+ * -----------------------------------------------------------------------------
+ * Same as dijkstrasAlgorithm(graph, start, end), and also returns the counters of the search in
+ * stats. The counters are recorded in searchStatsRegistry() under "dijkstra".
+ * @param: stats type SearchStats - set to the counters of the search.
+ * @return: Path type, lists the edges (RoadNode*) between the start and end vertex for
+ * the path found if a path was found, empty if not path was found.
+ */
+Path dijkstrasAlgorithm(const RoadGraph& graph, RoadNode* start, RoadNode* end, SearchStats &stats) {
     /* Priority and edge to ignore are not needed for Dijkstra's algorithm but they are needed
      * for the helper function that dijkstrasAlgorithm, aStar and alternative route use.
      */
     double priority;
     RoadEdge* toignore = NULL;
-    return dijkstrasorAstar(graph, start, end, false, toignore, priority);
+    stats = SearchStats();
+    auto startTime = chrono::steady_clock::now();
+    Path pathFound = dijkstrasorAstar(graph, start, end, false, toignore, priority, stats);
+    stats.wallTimeMs = elapsedMillis(startTime);
+    searchStatsRegistry().record("dijkstra", stats);
+    return pathFound;
 }
  
  
@@ -315,12 +372,31 @@ Path dijkstrasAlgorithm(const RoadGraph& graph, RoadNode* start, RoadNode* end)
  * the path found if a path was found, empty if not path was found.
  */
 Path aStar(const RoadGraph& graph, RoadNode* start, RoadNode* end) {
+    SearchStats stats;
+    return aStar(graph, start, end, stats);
+}
+
+/* Function: aStar()
+ * Usage: aStar(graph, start, end, stats)
+ * -----------------------------------------------------------------------------
+ * Same as aStar(graph, start, end), and also returns the counters of the search in stats.
+ * The counters are recorded in searchStatsRegistry() under "astar".
+ * @param: stats type SearchStats - set to the counters of the search.
+ * @return: Path type, lists the edges (RoadNode*) between the start and end vertex for
+ * the path found if a path was found, empty if not path was found.
+ */
+Path aStar(const RoadGraph& graph, RoadNode* start, RoadNode* end, SearchStats &stats) {
     /* Priority and edge to ignore are not needed for aStar algorithm but they are needed
      * for the helper function that dijkstrasAlgorithm, aStar and alternative route use.
      */
     double priority;
     RoadEdge* toignore = NULL;
-    return dijkstrasorAstar(graph, start, end, true, toignore, priority);
+    stats = SearchStats();
+    auto startTime = chrono::steady_clock::now();
+    Path pathFound = dijkstrasorAstar(graph, start, end, true, toignore, priority, stats);
+    stats.wallTimeMs = elapsedMillis(startTime);
+    searchStatsRegistry().record("astar", stats);
+    return pathFound;
 }
  
 /* Function: alternativeRoute()
@@ -344,8 +420,14 @@ Path aStar(const RoadGraph& graph, RoadNode* start, RoadNode* end) {
  * the path found if a path was found, empty if not path was found.
  */
 Path alternativeRoute(const RoadGraph& graph, RoadNode* start, RoadNode* end) {
+    double priority;
+    // counters of the best path search and of all the candidate searches, recorded together under
+    // "alternative" only (the best path search is not an "astar" query of its own)
+    SearchStats stats;
+    auto startTime = chrono::steady_clock::now();
     // find best path using a*
-    Path bestPath = aStar(graph, start, end);
+    RoadEdge* toignore = NULL;
+    Path bestPath = dijkstrasorAstar(graph, start, end, true, toignore, priority, stats);
     //cout << bestPath.size() << " this is my best path size " << endl;
     PriorityQueue<Path> alternativeBestPaths;
     Set<RoadEdge*> setofEdges;
@@ -353,10 +435,9 @@ Path alternativeRoute(const RoadGraph& graph, RoadNode* start, RoadNode* end) {
     for (int i = 0; i < bestPath.size() - 1; i++) {
         setofEdges.add(graph.edgeBetween(bestPath[i], bestPath[i + 1]));
     }
-    double priority;
     // find candidate alternative routes to best path by ignoring each of the edges in best path
     for (RoadEdge* edge: setofEdges) {
-        Path altPath = dijkstrasorAstar(graph, start, end, true, edge, priority);
+        Path altPath = dijkstrasorAstar(graph, start, end, true, edge, priority, stats);
         if (altPath.size() > 0) {
             // calculate the difference between bestPath and candidate alternative route found
             double difference = calculatePercentageDifference(bestPath, altPath);
@@ -366,6 +447,8 @@ Path alternativeRoute(const RoadGraph& graph, RoadNode* start, RoadNode* end) {
             }
         }
     }
+    stats.wallTimeMs = elapsedMillis(startTime);
+    searchStatsRegistry().record("alternative", stats);
     if (alternativeBestPaths.size() > 0) {
         // returns the lowest cost aternate route that is sufficiently different from the original best path
         printPathInfo(alternativeBestPaths.dequeue());
@@ -416,5 +499,293 @@ bool nodeInAltPath(RoadNode* node, Path altpath) {
      }
      return false;
  }
- 
- 
\ No newline at end of file
+
+/* Function: indexedDijkstrasorAstar()
+ * Usage: indexedDijkstrasorAstar(index, start, end, withheuristic, toignore, priority, stats)
+ * -----------------------------------------------------------------------------
+ * Same search as dijkstrasorAstar, over a RoadGraphIndex: returns the ids of the nodes along the
+ * shortest path from start to end (start first, end last), a one-element path if start and end
+ * are the same, or an empty path if end cannot be reached. If withheuristic is true A* is used,
+ * otherwise Dijkstra's algorithm. The edge with id toignore (if not -1) is ignored.
+ * Instead of queueing whole paths, the search keeps the best known cost and the predecessor of
+ * every node in arrays indexed by node id, queues (priority, node) pairs, and rebuilds the path
+ * from the predecessors once end is reached. A node can be queued several times when a cheaper
+ * path to it is found; entries for nodes that were already visited are skipped.
+ * Nodes are not colored and no path info is printed (the index may not have RoadNode* pointers).
+ * Throws a string exception if start or end is not the id of a node of index (to search every
+ * node, use shortestDistances).
+ * @param: index type RoadGraphIndex - graph where we'll be searching the path.
+ * @param: start type int, id of the starting vertex.
+ * @param: end type int, id of the ending vertex.
+ * @param: withheuristic type bool. If true A* is used, if false Dijkstra's algorithm.
+ * @param: toignore type int - id of the edge to ignore, -1 to use every edge.
+ * @param: priority type double - set to the cost of the path returned (if path exists).
+ * @param: stats type SearchStats - counters of the search, incremented by this function.
+ * @return: Vector<int> type, ids of the nodes along the path found, empty if no path was found.
+ */
+Vector<int> indexedDijkstrasorAstar(const RoadGraphIndex& index, int start, int end, bool withheuristic,
+                                    int toignore, double &priority, SearchStats &stats) {
+    if (start < 0 || start >= index.nodeCount() || end < 0 || end >= index.nodeCount()) {
+        throw EXCEPTION_BAD_NODE_ID;
+    }
+    Vector<int> pathFound;
+    if (start == end) {
+        priority = 0;
+        pathFound.add(start);
+        return pathFound;
+    }
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queueofNodes;
+    vector<double> bestCost(index.nodeCount(), numeric_limits<double>::infinity());
+    vector<int> previous(index.nodeCount(), -1);
+    vector<bool> visitedPoints(index.nodeCount(), false);
+    bestCost[start] = 0;
+    queueofNodes.push(QueueEntry(withheuristic ? index.heuristic(start, end) : 0, start));
+    stats.heapPushes++;
+    stats.maxFrontier = max(stats.maxFrontier, 1L);
+    while (!queueofNodes.empty()) {
+        int lastnode = queueofNodes.top().second;
+        queueofNodes.pop();
+        stats.heapPops++;
+        if (visitedPoints[lastnode]) {
+            stats.duplicatePops++;
+            continue;
+        }
+        visitedPoints[lastnode] = true;
+        stats.nodesSettled++;
+        if (lastnode == end) {
+            priority = bestCost[end];
+            for (int node = end; node != -1; node = previous[node]) {
+                pathFound.add(node);
+            }
+            reverse(pathFound.begin(), pathFound.end());
+            return pathFound;
+        }
+        for (int edge = index.firstEdge(lastnode); edge < index.firstEdge(lastnode + 1); edge++) {
+            int node = index.edgeTarget(edge);
+            double newCost = bestCost[lastnode] + index.edgeCost(edge);
+            if (edge != toignore && !visitedPoints[node] && newCost < bestCost[node]) {
+                bestCost[node] = newCost;
+                previous[node] = lastnode;
+                double newpriority = withheuristic ? newCost + index.heuristic(node, end) : newCost;
+                queueofNodes.push(QueueEntry(newpriority, node));
+                stats.edgesRelaxed++;
+                stats.heapPushes++;
+            }
+        }
+        stats.maxFrontier = max(stats.maxFrontier, (long) queueofNodes.size());
+    }
+    return pathFound;
+}
+
+/* Function: dijkstrasAlgorithm()
+ * Usage: dijkstrasAlgorithm(index, start, end)
+ * -----------------------------------------------------------------------------
+ * Searches the given index for the shortest path from the given start node id to the given end
+ * node id with Dijkstra's algorithm. Relies on indexedDijkstrasorAstar.
+ * @return: Vector<int> type, ids of the nodes along the path found, empty if no path was found.
+ */
+Vector<int> dijkstrasAlgorithm(const RoadGraphIndex& index, int start, int end) {
+    SearchStats stats;
+    return dijkstrasAlgorithm(index, start, end, stats);
+}
+
+/* Function: dijkstrasAlgorithm()
+ * Usage: dijkstrasAlgorithm(index, start, end, stats)
+ * -----------------------------------------------------------------------------
+ * Same as dijkstrasAlgorithm(index, start, end), and also returns the counters of the search in
+ * stats. The counters are recorded in searchStatsRegistry() under "indexed-dijkstra".
+ * @return: Vector<int> type, ids of the nodes along the path found, empty if no path was found.
+ */
+Vector<int> dijkstrasAlgorithm(const RoadGraphIndex& index, int start, int end, SearchStats &stats) {
+    double priority;
+    stats = SearchStats();
+    auto startTime = chrono::steady_clock::now();
+    Vector<int> pathFound = indexedDijkstrasorAstar(index, start, end, false, -1, priority, stats);
+    stats.wallTimeMs = elapsedMillis(startTime);
+    searchStatsRegistry().record("indexed-dijkstra", stats);
+    return pathFound;
+}
+
+/* Function: aStar()
+ * Usage: aStar(index, start, end)
+ * -----------------------------------------------------------------------------
+ * Searches the given index for the shortest path from the given start node id to the given end
+ * node id with A*, using the same super highway heuristic as aStar over a RoadGraph.
+ * Relies on indexedDijkstrasorAstar.
+ * @return: Vector<int> type, ids of the nodes along the path found, empty if no path was found.
+ */
+Vector<int> aStar(const RoadGraphIndex& index, int start, int end) {
+    SearchStats stats;
+    return aStar(index, start, end, stats);
+}
+
+/* Function: aStar()
+ * Usage: aStar(index, start, end, stats)
+ * -----------------------------------------------------------------------------
+ * Same as aStar(index, start, end), and also returns the counters of the search in stats.
+ * The counters are recorded in searchStatsRegistry() under "indexed-astar".
+ * @return: Vector<int> type, ids of the nodes along the path found, empty if no path was found.
+ */
+Vector<int> aStar(const RoadGraphIndex& index, int start, int end, SearchStats &stats) {
+    double priority;
+    stats = SearchStats();
+    auto startTime = chrono::steady_clock::now();
+    Vector<int> pathFound = indexedDijkstrasorAstar(index, start, end, true, -1, priority, stats);
+    stats.wallTimeMs = elapsedMillis(startTime);
+    searchStatsRegistry().record("indexed-astar", stats);
+    return pathFound;
+}
+
+/* Function: shortestDistances()
+ * Usage: shortestDistances(index, source)
+ * -----------------------------------------------------------------------------
+ * Returns the cost of the shortest path from source to every node of index, indexed by node id
+ * (infinity for the nodes that cannot be reached), computed with Dijkstra's algorithm run until
+ * every node reachable from source is settled.
+ * Throws a string exception if source is not the id of a node of index.
+ * @param: index type RoadGraphIndex - graph searched.
+ * @param: source type int - id of the node the paths start from.
+ * @return: vector<double> type, cost of the shortest path to every node.
+ */
+vector<double> shortestDistances(const RoadGraphIndex& index, int source) {
+    SearchStats stats;
+    return shortestDistances(index, source, stats);
+}
+
+/* Function: shortestDistances()
+ * Usage: shortestDistances(index, source, stats)
+ * -----------------------------------------------------------------------------
+ * Same as shortestDistances(index, source), and also adds the counters of the search to stats.
+ * @param: stats type SearchStats - counters of the search, incremented by this function.
+ * @return: vector<double> type, cost of the shortest path to every node.
+ */
+vector<double> shortestDistances(const RoadGraphIndex& index, int source, SearchStats &stats) {
+    if (source < 0 || source >= index.nodeCount()) {
+        throw EXCEPTION_BAD_NODE_ID;
+    }
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queueofNodes;
+    vector<double> bestCost(index.nodeCount(), numeric_limits<double>::infinity());
+    vector<bool> visitedPoints(index.nodeCount(), false);
+    bestCost[source] = 0;
+    queueofNodes.push(QueueEntry(0, source));
+    stats.heapPushes++;
+    stats.maxFrontier = max(stats.maxFrontier, 1L);
+    while (!queueofNodes.empty()) {
+        int lastnode = queueofNodes.top().second;
+        queueofNodes.pop();
+        stats.heapPops++;
+        if (visitedPoints[lastnode]) {
+            stats.duplicatePops++;
+            continue;
+        }
+        visitedPoints[lastnode] = true;
+        stats.nodesSettled++;
+        for (int edge = index.firstEdge(lastnode); edge < index.firstEdge(lastnode + 1); edge++) {
+            int node = index.edgeTarget(edge);
+            double newCost = bestCost[lastnode] + index.edgeCost(edge);
+            if (!visitedPoints[node] && newCost < bestCost[node]) {
+                bestCost[node] = newCost;
+                queueofNodes.push(QueueEntry(newCost, node));
+                stats.edgesRelaxed++;
+                stats.heapPushes++;
+            }
+        }
+        stats.maxFrontier = max(stats.maxFrontier, (long) queueofNodes.size());
+    }
+    return bestCost;
+}
+
+/* Function: reachableWithin()
+ * Usage: reachableWithin(graph, start, budget)
+ * -----------------------------------------------------------------------------
+ * Returns the isochrone of start for one budget: every node that can be reached from start with
+ * a path costing at most budget, and the frontier edges, which leave a reachable node towards a
+ * node that cannot be reached within budget. Relies on the multiple budget version.
+ * @param: graph type RoadGraph - graph searched.
+ * @param: start type RoadNode* - node the paths start from.
+ * @param: budget type double - largest path cost allowed.
+ * @return: Isochrone type, reachable nodes and frontier edges.
+ */
+Isochrone reachableWithin(const RoadGraph& graph, RoadNode* start, double budget) {
+    Vector<double> budgets;
+    budgets.add(budget);
+    return reachableWithin(graph, start, budgets)[0];
+}
+
+/* Function: reachableWithin()
+ * Usage: reachableWithin(graph, start, budgets)
+ * -----------------------------------------------------------------------------
+ * Returns one isochrone of start per budget, in the order of budgets, with a single search.
+ * Uses Dijkstra's algorithm from start, queueing nodes (not paths) and stopping as soon as the
+ * cheapest queued cost is larger than the largest budget, so nodes beyond the largest budget are
+ * never expanded. Each node is settled once, with its final cost, and belongs to every isochrone
+ * whose budget is at least that cost: the isochrones of the smaller budgets are read from the
+ * same search instead of searching again. Settled nodes are colored green and nodes queued but
+ * not settled yellow, like the other searches of this file.
+ * Assumptions: graph passed in is not corrupt. Budgets are not negative.
+ * @param: graph type RoadGraph - graph searched.
+ * @param: start type RoadNode* - node the paths start from.
+ * @param: budgets type Vector<double> - largest path cost allowed by each isochrone.
+ * @return: Vector<Isochrone> type, isochrone of every budget (same order as budgets).
+ */
+Vector<Isochrone> reachableWithin(const RoadGraph& graph, RoadNode* start, const Vector<double>& budgets) {
+    Vector<Isochrone> isochrones;
+    double maxBudget = -1;
+    for (double budget : budgets) {
+        Isochrone isochrone;
+        isochrone.budget = budget;
+        isochrones.add(isochrone);
+        maxBudget = max(maxBudget, budget);
+    }
+    if (budgets.isEmpty()) {
+        return isochrones;
+    }
+    // Dijkstra's algorithm over nodes, cut at the largest budget
+    Map<RoadNode*, double> bestCost;
+    Set<RoadNode*> visitedPoints;
+    Vector<RoadNode*> settledOrder;
+    PriorityQueue<RoadNode*> queueofNodes;
+    bestCost[start] = 0;
+    queueofNodes.enqueue(start, 0);
+    while (!queueofNodes.isEmpty() && queueofNodes.peekPriority() <= maxBudget) {
+        RoadNode* lastnode = queueofNodes.dequeue();
+        if (visitedPoints.contains(lastnode)) {
+            continue;
+        }
+        markPointVisited(lastnode, visitedPoints);
+        settledOrder.add(lastnode);
+        for (RoadNode* node : graph.neighborsOf(lastnode)) {
+            double newCost = bestCost[lastnode] + graph.edgeBetween(lastnode, node)->cost();
+            if (!visitedPoints.contains(node) && (!bestCost.containsKey(node) || newCost < bestCost[node])) {
+                bestCost[node] = newCost;
+                node->setColor(Color::YELLOW);
+                queueofNodes.enqueue(node, newCost);
+            }
+        }
+    }
+    // split the settled nodes and their outgoing edges between the isochrones
+    for (RoadNode* node : settledOrder) {
+        double nodeCost = bestCost[node];
+        Set<RoadNode*> neighbors = graph.neighborsOf(node);
+        for (Isochrone& isochrone : isochrones) {
+            if (nodeCost > isochrone.budget) {
+                continue;
+            }
+            isochrone.reachable.add(node);
+            for (RoadNode* neighbor : neighbors) {
+                // neighbor is outside the isochrone if it was not settled or settled above the budget
+                if (!visitedPoints.contains(neighbor) || bestCost[neighbor] > isochrone.budget) {
+                    isochrone.frontierEdges.add(graph.edgeBetween(node, neighbor));
+                }
+            }
+        }
+    }
+    return isochrones;
+}
+
+/* Returns the number of milliseconds elapsed since the given time point */
+static double elapsedMillis(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
@@ -0,0 +1,41 @@
+/*
+ * File: PathfindingAlgos.h
+ * ------------------------
+ * This file declares the path finding functions of PathfindingAlgos.cpp that are not part of
+ * Trailblazer.h: versions of Dijkstra's algorithm and A* that search a RoadGraphIndex (built
+ * from a RoadGraph or memory-mapped from a snapshot file) using node ids instead of RoadNode*,
+ * versions of the searches that return their counters in a SearchStats, the costs of the
+ * shortest paths from one node to every node, and isochrone queries.
+ */
+
+#ifndef _pathfindingalgos_h
+#define _pathfindingalgos_h
+#include <vector>
+#include "RoadGraphIndex.h"
+#include "RoutingStats.h"
+#include "Trailblazer.h"
+#include "set.h"
+#include "vector.h"
+using namespace std;
+
+/* Nodes reachable from a start node within a cost budget (result of reachableWithin) */
+struct Isochrone {
+    double budget;
+    Set<RoadNode*> reachable;          // nodes whose cheapest path from the start costs at most budget
+    Vector<RoadEdge*> frontierEdges;   // edges from a reachable node to a node outside the isochrone
+};
+
+Path dijkstrasAlgorithm(const RoadGraph& graph, RoadNode* start, RoadNode* end, SearchStats &stats);
+Path aStar(const RoadGraph& graph, RoadNode* start, RoadNode* end, SearchStats &stats);
+Vector<int> indexedDijkstrasorAstar(const RoadGraphIndex& index, int start, int end, bool withheuristic,
+                                    int toignore, double &priority, SearchStats &stats);
+Vector<int> dijkstrasAlgorithm(const RoadGraphIndex& index, int start, int end);
+Vector<int> dijkstrasAlgorithm(const RoadGraphIndex& index, int start, int end, SearchStats &stats);
+Vector<int> aStar(const RoadGraphIndex& index, int start, int end);
+Vector<int> aStar(const RoadGraphIndex& index, int start, int end, SearchStats &stats);
+vector<double> shortestDistances(const RoadGraphIndex& index, int source);
+vector<double> shortestDistances(const RoadGraphIndex& index, int source, SearchStats &stats);
+Isochrone reachableWithin(const RoadGraph& graph, RoadNode* start, double budget);
+Vector<Isochrone> reachableWithin(const RoadGraph& graph, RoadNode* start, const Vector<double>& budgets);
+
+#endif // _pathfindingalgos_h
@@ -7,7 +7,7 @@
  * 4 in CS 106B. Specifically this file implements all user interaction via the console
  * and console updates to reflect current state of the game for one game of Boggle between a human
  * player and the computer. One game of boggle consists in:
- * - setting up a GRID_SIZE x GRID_SIZE grid of uppercase letters. Letters can be randomly selected
+ * - setting up a 4x4 (or 5x5 "Big Boggle") grid of uppercase letters. Letters can be randomly selected
  * or specified by the user.
  * - Human player turn: game prompts human player for words and stores unique 4+ letter English words
  * provided that exist in Lexicon used and that can be formed by chains of neighboring cells in the grid
@@ -29,6 +29,7 @@
  
 #include "lexicon.h"
 #include "console.h"
+#include "filelib.h"
 #include "simpio.h"
 #include "Boggle.h"
 #include "bogglegui.h"
@@ -36,7 +37,7 @@
  
 /* Function prototypes */
 void playOneGame(const Lexicon& dictionary);
-string getGridChoice();
+string getGridChoice(int &boardSize);
 void initialBoardSetup(Boggle &b);
 void updateConsole(const Boggle &b, string message);
 void humanTurn(Boggle &b);
@@ -46,6 +47,7 @@ bool validBoard(string customBoard);
  
 /* Text to display in console and GUI */
 const string RANDOM_BOARD_Q = "Do you want to generate a random board?";
+const string BIG_BOGGLE_Q = "Do you want to play Big Boggle (5x5)?";
 const string YES_NO_QUESTION_ERROR = "Please type a word that begins with \'y\' or \'n\'";
 const string TYPE_WORD_PROMPT = "Type a word (or Enter to stop):";
 const string INVALID_WORD = "You must enter an unfound 4+ letter word from the dictionary.";
@@ -55,19 +57,19 @@ const string PLAY_AGAIN_Q = "Play again (Y/N)?";
 const string YOUR_TURN = "It's your turn!";
 const string NOT_IN_BOARD = "That word cannot be found on this board.";
 const string FOUND_NEW_WORD = "You found a new word! ";
-const string MANUAL_GRID_REQUEST = "Type the 16 letters to appear on the board:";
-const string MANUAL_GRID_ERROR = "That is not a valid 16-letter string. Try again.";
+const string MANUAL_GRID_REQUEST = "Type the 16 letters (25 for Big Boggle) to appear on the board:";
+const string MANUAL_GRID_ERROR = "That is not a valid 16-letter or 25-letter string. Try again.";
 const string COMPUTER_TURN = "It's my turn!";
 const string COMPUTER_WORDS ="My words (";
 const string COMPUTER_SCORE = "My score: ";
 const string COMPUTER_WON_TAUNT = "Ha ha ha, I destroyed you. Better luck next time, puny human!";
 const string HUMAN_WON_TAUNT = "Mwahaha! I won. Your backtracking was no match for my love of dictionaries.";
  
-/*Grid dimensions*/
-const int GRID_SIZE = 4;
- 
 /*Animation delay (ms)*/
 const int ANIMATION_DELAY = 100;
+
+/* Compact dictionary loaded instead of building one from the Lexicon, if it exists (see MakeDawg.cpp) */
+const string DAWG_FILE = "dictionary.dawg";
  
 /** Function: playOneGame
  * Usage: playOneGame(dictionary)
@@ -75,13 +77,24 @@ const int ANIMATION_DELAY = 100;
  * Plays one game of Boggle using the Lexicon passed as reference to check for word validity.
  * Specifically this function gets grid choice from player, initializes GUI and console, lets
  * human player play one turn, lets computer play one turn and declares a winner.
+ * The compact dictionary searched by the game is made once and kept for the following games:
+ * it is memory-mapped from DAWG_FILE if that file exists, built from dictionary otherwise.
  * @param dictionary - Lexicon type. Lexicon used to check if the words provided by user
  * or found during the search are valid English words.
  */
 void playOneGame(const Lexicon& dictionary) {
-    BoggleGUI::initialize(GRID_SIZE,GRID_SIZE);
-    string customBoard = getGridChoice();
-    Boggle b(dictionary, customBoard);
+    int boardSize = BOGGLE_SIZE;
+    string customBoard = getGridChoice(boardSize);
+    BoggleGUI::initialize(boardSize, boardSize);
+    static shared_ptr<const CompactLexicon> trie;
+    if (!trie) {
+        if (fileExists(DAWG_FILE)) {
+            trie = make_shared<const CompactLexicon>(DAWG_FILE);
+        } else {
+            trie = make_shared<const CompactLexicon>(dictionary);
+        }
+    }
+    Boggle b(trie, customBoard, boardSize);
     updateConsole(b, YOUR_TURN);
     initialBoardSetup(b);
     BoggleGUI::setAnimationDelay(ANIMATION_DELAY);
@@ -92,23 +105,30 @@ void playOneGame(const Lexicon& dictionary) {
 }
  
 /** Function: getGridChoice
- * Usage: getGridChoice(dictionary)
+ * Usage: getGridChoice(boardSize)
  * -----------------------------------------------------
  * Gets grid choice from user, returns an empty string if user wants a random grid
- * or returns a 16-letter string, if the user does not want a random grid.
+ * or returns a 16-letter or 25-letter string, if the user does not want a random grid.
  * Specifically this function asks the user via console if a random grid is desired for game,
- * and continues to do so until user provides a correct answer.
+ * and continues to do so until user provides a correct answer. If so, it asks whether the random grid
+ * should be a 5x5 Big Boggle grid.
  * If user does not want a random grid, function then prompts user via the console for a 16-letter
- * string and continues to do so until a 16-letter string is provided.
+ * or 25-letter string and continues to do so until a valid string is provided.
+ * @param boardSize (int): set to the number of rows and columns of the grid chosen.
  * @return customBoard (string): captures user choice for grid. This can be empty (user desires
- * random grid) or can be a 16-letter string (to use for our game grid).
+ * random grid) or can be a 16-letter or 25-letter string (to use for our game grid).
  * Note: string is returned as entered by user when not empty. Any capitalization changes needed for
  * game are handled by Boggle object constructor.
  */
-string getGridChoice() {
+string getGridChoice(int &boardSize) {
     string customBoard ="";
+    boardSize = BOGGLE_SIZE;
     bool wantRandomBoard = getYesOrNo(RANDOM_BOARD_Q, YES_NO_QUESTION_ERROR);
-    if (!wantRandomBoard) {
+    if (wantRandomBoard) {
+        if (getYesOrNo(BIG_BOGGLE_Q, YES_NO_QUESTION_ERROR)) {
+            boardSize = BIG_BOGGLE_SIZE;
+        }
+    } else {
         bool valid = false;
         while (!valid) {
             customBoard = getLine(MANUAL_GRID_REQUEST);
@@ -117,6 +137,7 @@ string getGridChoice() {
                 cout << MANUAL_GRID_ERROR << endl;
             }
         }
+        boardSize = customBoard.size() == BIG_BOGGLE_SIZE * BIG_BOGGLE_SIZE ? BIG_BOGGLE_SIZE : BOGGLE_SIZE;
     }
     return customBoard;
 }
@@ -130,8 +151,8 @@ string getGridChoice() {
  * @param: b, Boggle object whose board contents are used to populate the game grid in the GUI.
  */
 void initialBoardSetup(Boggle &b) {
-    for (int r = 0; r < GRID_SIZE; r++) {
-        for (int c = 0; c < GRID_SIZE; c++) {
+    for (int r = 0; r < b.getBoardSize(); r++) {
+        for (int c = 0; c < b.getBoardSize(); c++) {
             BoggleGUI::labelCube(r, c, b.getLetter(r, c), false);
         }
     }
@@ -252,11 +273,11 @@ void declareWinner(const Boggle &b) {
 /** Function: validBoard
  * Usage: validBoard(b)
  * -----------------------------------------------------
- * Checks the string passed as parameter is a 16-letter string. Returns true
- * if it is, returns false if it is not.
+ * Checks the string passed as parameter is a 16-letter string (4x4 board) or a 25-letter string
+ * (5x5 Big Boggle board). Returns true if it is, returns false if it is not.
  * @param: customBoard (string) - word for which we check validity.
- * @return: boolean - true if the string passed as parameter to this function is a 16-letter string,
- * false if not.
+ * @return: boolean - true if the string passed as parameter to this function is a 16-letter or
+ * 25-letter string, false if not.
  */
 bool validBoard(string customBoard) {
     for (int i = 0; i < (int) customBoard.size(); i++) {
@@ -264,7 +285,7 @@ bool validBoard(string customBoard) {
             return false;
         }
     }
-    if (customBoard.size() != GRID_SIZE * GRID_SIZE ) {
+    if (customBoard.size() != BOGGLE_SIZE * BOGGLE_SIZE && customBoard.size() != BIG_BOGGLE_SIZE * BIG_BOGGLE_SIZE) {
         return false;
     }
     return true;
@@ -0,0 +1,558 @@
+/*
+ * File: RoadGraphIndex.cpp
+ * ------------------------
+ * This file implements the RoadGraphIndex class, which includes the following methods
+ * - RoadGraphIndex constructor, which numbers every node reachable from a set of seed nodes and
+ * copies their edges, costs and locations into flat arrays.
+ * - RoadGraphIndex constructor which memory-maps a snapshot file written by saveSnapshot.
+ * - method to write the index to a snapshot file.
+ * - methods returning locality-preserving node orders (Hilbert curve, reverse Cuthill-McKee) and
+ * a method renumbering the nodes in a given order.
+ * - methods to translate between ids and RoadNode* / RoadEdge* pointers.
+ * - method to change the cost of an edge.
+ * - methods returning straight-line distances and the A* heuristic between two nodes.
+ * Snapshot files are mapped privately: setEdgeCost on a loaded index changes the process' copy
+ * of the page only, never the file. Snapshots are written in the byte order of the machine that
+ * saves them, and loading a snapshot with another byte order is refused.
+ */
+
+#include "RoadGraphIndex.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "queue.h"
+
+/* Text for string exceptions */
+const string EXCEPTION_BAD_EDGE_COST = "Edge costs must not be negative";
+const string EXCEPTION_SNAPSHOT_OPEN = "Road graph snapshot could not be opened";
+const string EXCEPTION_SNAPSHOT_FORMAT = "File is not a road graph snapshot or is truncated";
+const string EXCEPTION_SNAPSHOT_VERSION = "Road graph snapshot version is not supported";
+const string EXCEPTION_SNAPSHOT_WRITE = "Road graph snapshot could not be written";
+const string EXCEPTION_BAD_ORDER = "Node order must contain every node id exactly once";
+
+/* Snapshot file identification */
+static const char SNAPSHOT_MAGIC[8] = {'R', 'O', 'A', 'D', 'G', 'R', 'P', 'H'};
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/* Node locations are scaled to a HILBERT_SIDE x HILBERT_SIDE grid to compute Hilbert curve positions */
+static const uint32_t HILBERT_SIDE = 1 << 16;
+
+/* Function prototypes */
+static uint64_t hilbertPosition(uint32_t x, uint32_t y);
+
+/** Method: RoadGraphIndex
+ * Usage: RoadGraphIndex index(graph, seeds)
+ * -----------------------------------------------------
+ * Builds the index of every node reachable from the seed nodes passed as parameter. Nodes are
+ * numbered in breadth first search order from the seeds, so nodes that are close in the graph
+ * get close ids. For an undirected graph a single seed per connected component is enough.
+ * @param: graph type RoadGraph - graph being indexed.
+ * @param: seeds type Vector<RoadNode*> - nodes the breadth first search starts from.
+ */
+RoadGraphIndex::RoadGraphIndex(const RoadGraph& graph, const Vector<RoadNode*>& seeds) {
+    mappedImage = NULL;
+    mappedSize = 0;
+    Queue<RoadNode*> toVisit;
+    for (RoadNode* seed : seeds) {
+        if (nodeIds.find(seed) == nodeIds.end()) {
+            nodeIds[seed] = nodes.size();
+            nodes.push_back(seed);
+            toVisit.enqueue(seed);
+        }
+    }
+    vector<double> nodeCoordinates;
+    vector<double> costs;
+    vector<int> offsets;
+    vector<int> sources;
+    vector<int> targets;
+    offsets.push_back(0);
+    while (!toVisit.isEmpty()) {
+        RoadNode* node = toVisit.dequeue();
+        int nodeId = nodeIds[node];
+        for (RoadNode* neighbor : graph.neighborsOf(node)) {
+            if (nodeIds.find(neighbor) == nodeIds.end()) {
+                nodeIds[neighbor] = nodes.size();
+                nodes.push_back(neighbor);
+                toVisit.enqueue(neighbor);
+            }
+            RoadEdge* edge = graph.edgeBetween(node, neighbor);
+            edgeIds[edge] = edges.size();
+            edges.push_back(edge);
+            sources.push_back(nodeId);
+            targets.push_back(nodeIds[neighbor]);
+            costs.push_back(edge->cost());
+        }
+        offsets.push_back(edges.size());
+        nodeCoordinates.push_back(node->location().getX());
+        nodeCoordinates.push_back(node->location().getY());
+    }
+    maxSpeed = graph.maxRoadSpeed();
+    buildImage(nodeCoordinates, costs, offsets, sources, targets);
+}
+
+/** Method: RoadGraphIndex
+ * Usage: RoadGraphIndex index(snapshotFile)
+ * -----------------------------------------------------
+ * Loads an index from a snapshot file written by saveSnapshot. The file is memory-mapped, not
+ * read into arrays of the process. The arrays are read once to check that offsets, node ids and
+ * edge ids stay in their arrays, so a damaged file is refused instead of making searches read
+ * outside of the mapping.
+ * Throws a string exception if the file cannot be opened, is not a snapshot, is truncated or
+ * inconsistent, or was written with another format version or byte order.
+ * @param: snapshotFile type string - name of the snapshot file.
+ */
+RoadGraphIndex::RoadGraphIndex(const string& snapshotFile) {
+    mappedImage = NULL;
+    mappedSize = 0;
+    int fd = open(snapshotFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw EXCEPTION_SNAPSHOT_OPEN;
+    }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < (off_t) sizeof(SnapshotHeader)) {
+        close(fd);
+        throw EXCEPTION_SNAPSHOT_FORMAT;
+    }
+    void* image = mmap(NULL, fileInfo.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        throw EXCEPTION_SNAPSHOT_OPEN;
+    }
+    const SnapshotHeader* header = (const SnapshotHeader*) image;
+    string problem;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+            header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+        problem = EXCEPTION_SNAPSHOT_FORMAT;
+    } else if (header->version != ROAD_GRAPH_SNAPSHOT_VERSION) {
+        problem = EXCEPTION_SNAPSHOT_VERSION;
+    } else if (header->nodeCount < 0 || header->nodeCount > INT_MAX - 1 || header->edgeCount < 0 ||
+               header->edgeCount > INT_MAX || !(header->maxRoadSpeed > 0) ||
+               header->imageSize != (uint64_t) fileInfo.st_size ||
+               header->imageSize != imageSizeFor(header->nodeCount, header->edgeCount)) {
+        problem = EXCEPTION_SNAPSHOT_FORMAT;
+    }
+    if (problem == "") {
+        attachImage((char*) image);
+        if (!validImage()) {
+            problem = EXCEPTION_SNAPSHOT_FORMAT;
+        }
+    }
+    if (problem != "") {
+        munmap(image, fileInfo.st_size);
+        throw problem;
+    }
+    mappedImage = image;
+    mappedSize = fileInfo.st_size;
+}
+
+/** Method: ~RoadGraphIndex
+ * -----------------------------------------------------
+ * Unmaps the snapshot file, if the index was loaded from one.
+ */
+RoadGraphIndex::~RoadGraphIndex() {
+    if (mappedImage != NULL) {
+        munmap(mappedImage, mappedSize);
+    }
+}
+
+/** Method: saveSnapshot
+ * Usage: index.saveSnapshot(snapshotFile)
+ * -----------------------------------------------------
+ * Writes the index (node locations, adjacency, current edge costs and maximum road speed) to a
+ * snapshot file that can be loaded with the snapshot constructor. RoadNode* and RoadEdge*
+ * pointers are not saved. Throws a string exception if the file cannot be written.
+ * @param: snapshotFile type string - name of the file written.
+ */
+void RoadGraphIndex::saveSnapshot(const string& snapshotFile) const {
+    ofstream out(snapshotFile.c_str(), ios::binary | ios::trunc);
+    out.write(imageData(), imageSizeFor(numNodes, numEdges));
+    if (!out) {
+        throw EXCEPTION_SNAPSHOT_WRITE;
+    }
+}
+
+/** Method: hilbertOrder
+ * Usage: index.renumber(index.hilbertOrder())
+ * -----------------------------------------------------
+ * Returns the node ids sorted by their position along a Hilbert curve covering the bounding box
+ * of the node locations. The Hilbert curve visits every cell of a square one neighboring cell
+ * at a time, so nodes close on the map end up close in the order.
+ * @return: vector<int> type, order[k] is the id of the node that should get id k.
+ */
+vector<int> RoadGraphIndex::hilbertOrder() const {
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for (int n = 0; n < numNodes; n++) {
+        if (n == 0 || nodeX(n) < minX) minX = nodeX(n);
+        if (n == 0 || nodeX(n) > maxX) maxX = nodeX(n);
+        if (n == 0 || nodeY(n) < minY) minY = nodeY(n);
+        if (n == 0 || nodeY(n) > maxY) maxY = nodeY(n);
+    }
+    double scale = (HILBERT_SIDE - 1) / max(max(maxX - minX, maxY - minY), 1e-12);
+    vector<pair<uint64_t, int>> positions(numNodes);
+    for (int n = 0; n < numNodes; n++) {
+        uint32_t x = (uint32_t) ((nodeX(n) - minX) * scale);
+        uint32_t y = (uint32_t) ((nodeY(n) - minY) * scale);
+        positions[n] = make_pair(hilbertPosition(x, y), n);
+    }
+    sort(positions.begin(), positions.end());
+    vector<int> order(numNodes);
+    for (int k = 0; k < numNodes; k++) {
+        order[k] = positions[k].second;
+    }
+    return order;
+}
+
+/** Method: reverseCuthillMcKeeOrder
+ * Usage: index.renumber(index.reverseCuthillMcKeeOrder())
+ * -----------------------------------------------------
+ * Returns the node ids in reverse Cuthill-McKee order: a breadth first search started from a
+ * node of smallest degree in each connected component, visiting neighbors by increasing degree,
+ * reversed at the end. It keeps the ids of the two ends of every edge close (small bandwidth)
+ * without using node locations. Edges are followed in both directions.
+ * @return: vector<int> type, order[k] is the id of the node that should get id k.
+ */
+vector<int> RoadGraphIndex::reverseCuthillMcKeeOrder() const {
+    vector<int> degree(numNodes);
+    for (int n = 0; n < numNodes; n++) {
+        degree[n] = (edgeOffsets[n + 1] - edgeOffsets[n]) + (incomingOffsets[n + 1] - incomingOffsets[n]);
+    }
+    vector<int> byDegree(numNodes);
+    for (int n = 0; n < numNodes; n++) {
+        byDegree[n] = n;
+    }
+    stable_sort(byDegree.begin(), byDegree.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+    vector<int> order;
+    order.reserve(numNodes);
+    vector<bool> visited(numNodes, false);
+    vector<int> neighbors;
+    for (int seed : byDegree) {
+        if (visited[seed]) {
+            continue;
+        }
+        visited[seed] = true;
+        order.push_back(seed);
+        // order doubles as the breadth first search queue
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            int node = order[head];
+            neighbors.clear();
+            for (int e = edgeOffsets[node]; e < edgeOffsets[node + 1]; e++) {
+                neighbors.push_back(edgeTargets[e]);
+            }
+            for (int slot = incomingOffsets[node]; slot < incomingOffsets[node + 1]; slot++) {
+                neighbors.push_back(edgeSources[incomingEdges[slot]]);
+            }
+            stable_sort(neighbors.begin(), neighbors.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+            for (int neighbor : neighbors) {
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    order.push_back(neighbor);
+                }
+            }
+        }
+    }
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+/** Method: renumber
+ * Usage: index.renumber(order)
+ * -----------------------------------------------------
+ * Gives node order[k] the id k, for every k, and rewrites node locations, outgoing and incoming
+ * edges and edge costs in the new order (edges are numbered by source node, so edge ids change
+ * too). Searches then keep their per-node arrays (costs, predecessors) in the same order. If the
+ * index was loaded from a snapshot, the renumbered index lives in memory and the file is unmapped.
+ * Throws a string exception if order is not a permutation of the node ids.
+ * @param: order type vector<int> - order[k] is the id of the node that gets id k.
+ */
+void RoadGraphIndex::renumber(const vector<int>& order) {
+    if ((int) order.size() != numNodes) {
+        throw EXCEPTION_BAD_ORDER;
+    }
+    vector<int> newIdOf(numNodes, -1);
+    for (int k = 0; k < numNodes; k++) {
+        if (order[k] < 0 || order[k] >= numNodes || newIdOf[order[k]] != -1) {
+            throw EXCEPTION_BAD_ORDER;
+        }
+        newIdOf[order[k]] = k;
+    }
+    vector<double> nodeCoordinates;
+    vector<double> costs;
+    vector<int> offsets;
+    vector<int> sources;
+    vector<int> targets;
+    vector<RoadNode*> newNodes;
+    vector<RoadEdge*> newEdges;
+    offsets.push_back(0);
+    for (int k = 0; k < numNodes; k++) {
+        int oldId = order[k];
+        nodeCoordinates.push_back(nodeX(oldId));
+        nodeCoordinates.push_back(nodeY(oldId));
+        for (int e = edgeOffsets[oldId]; e < edgeOffsets[oldId + 1]; e++) {
+            sources.push_back(k);
+            targets.push_back(newIdOf[edgeTargets[e]]);
+            costs.push_back(edgeCosts[e]);
+            if (!edges.empty()) {
+                newEdges.push_back(edges[e]);
+            }
+        }
+        offsets.push_back(targets.size());
+        if (!nodes.empty()) {
+            newNodes.push_back(nodes[oldId]);
+        }
+    }
+    if (mappedImage != NULL) {
+        munmap(mappedImage, mappedSize);
+        mappedImage = NULL;
+        mappedSize = 0;
+    }
+    buildImage(nodeCoordinates, costs, offsets, sources, targets);
+    nodes.swap(newNodes);
+    edges.swap(newEdges);
+    for (int n = 0; n < (int) nodes.size(); n++) {
+        nodeIds[nodes[n]] = n;
+    }
+    for (int e = 0; e < (int) edges.size(); e++) {
+        edgeIds[edges[e]] = e;
+    }
+}
+
+/** Method: buildImage
+ * Usage: buildImage(nodeCoordinates, costs, offsets, sources, targets)
+ * -----------------------------------------------------
+ * Lays out the header and the arrays passed as parameter in ownedImage, computes the incoming
+ * edge arrays with a counting sort of the edges by target node, and attaches the image.
+ */
+void RoadGraphIndex::buildImage(const vector<double>& nodeCoordinates, const vector<double>& costs,
+                                const vector<int>& offsets, const vector<int>& sources, const vector<int>& targets) {
+    int64_t imageNodes = offsets.size() - 1;
+    int64_t imageEdges = targets.size();
+    size_t size = imageSizeFor(imageNodes, imageEdges);
+    ownedImage.assign(size / sizeof(uint64_t), 0);
+    char* image = (char*) ownedImage.data();
+    SnapshotHeader* header = (SnapshotHeader*) image;
+    memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header->version = ROAD_GRAPH_SNAPSHOT_VERSION;
+    header->byteOrder = SNAPSHOT_BYTE_ORDER;
+    header->nodeCount = imageNodes;
+    header->edgeCount = imageEdges;
+    header->maxRoadSpeed = maxSpeed;
+    header->imageSize = size;
+    attachImage(image);
+
+    memcpy((double*) coordinates, nodeCoordinates.data(), nodeCoordinates.size() * sizeof(double));
+    memcpy(edgeCosts, costs.data(), costs.size() * sizeof(double));
+    memcpy((int*) edgeOffsets, offsets.data(), offsets.size() * sizeof(int));
+    memcpy((int*) edgeSources, sources.data(), sources.size() * sizeof(int));
+    memcpy((int*) edgeTargets, targets.data(), targets.size() * sizeof(int));
+    int* incomingCounts = (int*) incomingOffsets;
+    for (int target : targets) {
+        incomingCounts[target + 1]++;
+    }
+    for (int n = 0; n < numNodes; n++) {
+        incomingCounts[n + 1] += incomingCounts[n];
+    }
+    vector<int> nextSlot(incomingOffsets, incomingOffsets + numNodes);
+    for (int e = 0; e < numEdges; e++) {
+        ((int*) incomingEdges)[nextSlot[targets[e]]++] = e;
+    }
+}
+
+/** Method: attachImage
+ * Usage: attachImage(image)
+ * -----------------------------------------------------
+ * Points the array members at their sections of image, using the counts in its header.
+ */
+void RoadGraphIndex::attachImage(char* image) {
+    const SnapshotHeader* header = (const SnapshotHeader*) image;
+    numNodes = header->nodeCount;
+    numEdges = header->edgeCount;
+    maxSpeed = header->maxRoadSpeed;
+    char* section = image + sizeof(SnapshotHeader);
+    coordinates = (const double*) section;
+    section += 2 * sizeof(double) * numNodes;
+    edgeCosts = (double*) section;
+    section += sizeof(double) * numEdges;
+    edgeOffsets = (const int*) section;
+    section += sizeof(int) * (numNodes + 1);
+    incomingOffsets = (const int*) section;
+    section += sizeof(int) * (numNodes + 1);
+    edgeSources = (const int*) section;
+    section += sizeof(int) * numEdges;
+    edgeTargets = (const int*) section;
+    section += sizeof(int) * numEdges;
+    incomingEdges = (const int*) section;
+}
+
+/** Method: validImage
+ * Usage: if (validImage()) ...
+ * -----------------------------------------------------
+ * Checks the arrays of an index attached to the image of a snapshot: outgoing and incoming offsets
+ * go from 0 to the number of edges without decreasing, the outgoing edges of every node start at
+ * that node, incoming edges are edge ids ending at that node, every edge ends at a node, and edge
+ * costs are not negative.
+ * @return: bool type, true if the arrays are consistent.
+ */
+bool RoadGraphIndex::validImage() const {
+    if (edgeOffsets[0] != 0 || edgeOffsets[numNodes] != numEdges || incomingOffsets[0] != 0 ||
+            incomingOffsets[numNodes] != numEdges) {
+        return false;
+    }
+    for (int n = 0; n < numNodes; n++) {
+        if (edgeOffsets[n + 1] < edgeOffsets[n] || edgeOffsets[n + 1] > numEdges ||
+                incomingOffsets[n + 1] < incomingOffsets[n] || incomingOffsets[n + 1] > numEdges) {
+            return false;
+        }
+        for (int e = edgeOffsets[n]; e < edgeOffsets[n + 1]; e++) {
+            if (edgeSources[e] != n || edgeTargets[e] < 0 || edgeTargets[e] >= numNodes || !(edgeCosts[e] >= 0)) {
+                return false;
+            }
+        }
+        for (int i = incomingOffsets[n]; i < incomingOffsets[n + 1]; i++) {
+            if (incomingEdges[i] < 0 || incomingEdges[i] >= numEdges || edgeTargets[incomingEdges[i]] != n) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/** Method: imageData
+ * Usage: imageData()
+ * -----------------------------------------------------
+ * @return: const char* type, first byte of the image (owned or mapped).
+ */
+const char* RoadGraphIndex::imageData() const {
+    return mappedImage != NULL ? (const char*) mappedImage : (const char*) ownedImage.data();
+}
+
+/** Method: imageSizeFor
+ * Usage: imageSizeFor(numNodes, numEdges)
+ * -----------------------------------------------------
+ * @return: size_t type, number of bytes of the image of a graph with the given number of nodes
+ * and edges, rounded up to a multiple of 8 bytes.
+ */
+size_t RoadGraphIndex::imageSizeFor(int64_t numNodes, int64_t numEdges) {
+    size_t size = sizeof(SnapshotHeader) + sizeof(double) * (2 * numNodes + numEdges) +
+                  sizeof(int) * (2 * (numNodes + 1) + 3 * numEdges);
+    return (size + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+}
+
+/** Method: idOf
+ * Usage: index.idOf(node)
+ * -----------------------------------------------------
+ * @return: int type, id of node in the index, -1 if node was not reachable from the seeds.
+ */
+int RoadGraphIndex::idOf(RoadNode* node) const {
+    auto found = nodeIds.find(node);
+    return found == nodeIds.end() ? -1 : found->second;
+}
+
+/** Method: edgeIdOf
+ * Usage: index.edgeIdOf(edge)
+ * -----------------------------------------------------
+ * @return: int type, id of edge in the index, -1 if edge is not in the index.
+ */
+int RoadGraphIndex::edgeIdOf(RoadEdge* edge) const {
+    auto found = edgeIds.find(edge);
+    return found == edgeIds.end() ? -1 : found->second;
+}
+
+/** Method: nodeAt
+ * Usage: index.nodeAt(node)
+ * -----------------------------------------------------
+ * @return: RoadNode* type, node of the original graph with the given id (NULL for an index
+ * loaded from a snapshot).
+ */
+RoadNode* RoadGraphIndex::nodeAt(int node) const {
+    return nodes.empty() ? NULL : nodes[node];
+}
+
+/** Method: edgeAt
+ * Usage: index.edgeAt(edge)
+ * -----------------------------------------------------
+ * @return: RoadEdge* type, edge of the original graph with the given id (NULL for an index
+ * loaded from a snapshot).
+ */
+RoadEdge* RoadGraphIndex::edgeAt(int edge) const {
+    return edges.empty() ? NULL : edges[edge];
+}
+
+/** Method: setEdgeCost
+ * Usage: index.setEdgeCost(edge, cost)
+ * -----------------------------------------------------
+ * Changes the cost of the edge with the given id in the index. The original RoadGraph is not
+ * modified. Throws a string exception if cost is negative.
+ * Assumption: cost is not smaller than the travel time at maxRoadSpeed(), otherwise the A*
+ * heuristic stops being a lower bound.
+ * @param edge - int type, id of the edge.
+ * @param cost - double type, new cost of the edge.
+ */
+void RoadGraphIndex::setEdgeCost(int edge, double cost) {
+    if (cost < 0) {
+        throw EXCEPTION_BAD_EDGE_COST;
+    }
+    edgeCosts[edge] = cost;
+}
+
+/** Method: maxRoadSpeed
+ * Usage: index.maxRoadSpeed()
+ * -----------------------------------------------------
+ * @return: double type, maximum road speed of the indexed graph.
+ */
+double RoadGraphIndex::maxRoadSpeed() const {
+    return maxSpeed;
+}
+
+/** Method: crowFlyDistance
+ * Usage: index.crowFlyDistance(from, to)
+ * -----------------------------------------------------
+ * @return: double type, straight-line distance between the locations of the two nodes.
+ */
+double RoadGraphIndex::crowFlyDistance(int from, int to) const {
+    double dx = nodeX(from) - nodeX(to);
+    double dy = nodeY(from) - nodeY(to);
+    return sqrt(dx * dx + dy * dy);
+}
+
+/** Method: heuristic
+ * Usage: index.heuristic(from, to)
+ * -----------------------------------------------------
+ * Returns the time it would take to get from one node to the other on a super highway at the
+ * maximum road speed (same heuristic as aStar in PathfindingAlgos.cpp). Never over-estimates
+ * the cost of travelling between the two nodes.
+ * @return: double type, under-estimate of the cost of the cheapest path between the nodes.
+ */
+double RoadGraphIndex::heuristic(int from, int to) const {
+    return crowFlyDistance(from, to) / maxSpeed;
+}
+
+/* Function: hilbertPosition()
+ * Usage: hilbertPosition(x, y)
+ * -----------------------------------------------------------------------------
+ * Returns the position of cell (x, y) along the Hilbert curve covering a HILBERT_SIDE x HILBERT_SIDE
+ * grid. At each level the curve visits the four quadrants of the current square in order, rotating
+ * and flipping the sub-curves so that consecutive cells are always neighbors.
+ */
+static uint64_t hilbertPosition(uint32_t x, uint32_t y) {
+    uint64_t position = 0;
+    for (uint32_t side = HILBERT_SIDE / 2; side > 0; side /= 2) {
+        uint32_t right = (x & side) > 0 ? 1 : 0;
+        uint32_t top = (y & side) > 0 ? 1 : 0;
+        position += (uint64_t) side * side * ((3 * right) ^ top);
+        // rotate the quadrant so that the sub-curve starts and ends at the right corners
+        if (top == 0) {
+            if (right == 1) {
+                x = HILBERT_SIDE - 1 - x;
+                y = HILBERT_SIDE - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return position;
+}
@@ -0,0 +1,145 @@
+/*
+ * File: RoadGraphIndex.h
+ * ----------------------
+ * This file declares the RoadGraphIndex class, a compact array-based copy of a RoadGraph.
+ * Nodes are numbered 0 .. nodeCount() - 1 and edges 0 .. edgeCount() - 1. Outgoing edges of
+ * each node are stored contiguously (compressed sparse row layout), and so are incoming edges,
+ * so searches can run over plain int ids and arrays instead of RoadNode* pointers and Sets.
+ * Edge costs are copied into the index and can be changed with setEdgeCost without touching
+ * the original graph (used to model traffic).
+ * All arrays live in one contiguous image which is also the on-disk snapshot format: an index
+ * can be saved with saveSnapshot and memory-mapped back with the snapshot constructor, without
+ * parsing; loading reads the arrays once to check them. A snapshot index has no RoadNode* / RoadEdge*
+ * pointers (nodeAt and edgeAt return NULL).
+ * Node ids can be changed with renumber, for example to a Hilbert curve order of node locations,
+ * so that nodes close on the map are close in memory and searches touch fewer cache lines.
+ */
+
+#ifndef _roadgraphindex_h
+#define _roadgraphindex_h
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RoadGraph.h"
+#include "vector.h"
+using namespace std;
+
+/* Version of the snapshot file format written by saveSnapshot */
+const uint32_t ROAD_GRAPH_SNAPSHOT_VERSION = 1;
+
+class RoadGraphIndex {
+public:
+    RoadGraphIndex(const RoadGraph& graph, const Vector<RoadNode*>& seeds);
+    RoadGraphIndex(const string& snapshotFile);
+    ~RoadGraphIndex();
+    void saveSnapshot(const string& snapshotFile) const;
+    vector<int> hilbertOrder() const;
+    vector<int> reverseCuthillMcKeeOrder() const;
+    void renumber(const vector<int>& order);
+    int nodeCount() const;
+    int edgeCount() const;
+    int idOf(RoadNode* node) const;
+    int edgeIdOf(RoadEdge* edge) const;
+    RoadNode* nodeAt(int node) const;
+    RoadEdge* edgeAt(int edge) const;
+    int firstEdge(int node) const;
+    int edgeSource(int edge) const;
+    int edgeTarget(int edge) const;
+    double edgeCost(int edge) const;
+    void setEdgeCost(int edge, double cost);
+    int firstIncoming(int node) const;
+    int incomingEdge(int slot) const;
+    double nodeX(int node) const;
+    double nodeY(int node) const;
+    double maxRoadSpeed() const;
+    double crowFlyDistance(int from, int to) const;
+    double heuristic(int from, int to) const;
+
+private:
+    /* First bytes of the image. All arrays follow it, doubles first so that every array is
+     * naturally aligned: coordinates, edge costs, edge offsets, incoming offsets, edge sources,
+     * edge targets, incoming edges. */
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        int64_t nodeCount;
+        int64_t edgeCount;
+        double maxRoadSpeed;
+        uint64_t imageSize;
+    };
+
+    // instance variables
+    int numNodes;
+    int numEdges;
+    double maxSpeed;
+    const double* coordinates;   // x, y of every node
+    double* edgeCosts;
+    const int* edgeOffsets;      // outgoing edges of node n are [edgeOffsets[n], edgeOffsets[n + 1])
+    const int* incomingOffsets;  // incoming edges of node n are [incomingOffsets[n], incomingOffsets[n + 1])
+    const int* edgeSources;
+    const int* edgeTargets;
+    const int* incomingEdges;    // edge ids, grouped by target node
+    vector<uint64_t> ownedImage; // image of an index built in memory
+    void* mappedImage;           // image of an index loaded from a snapshot
+    size_t mappedSize;
+    vector<RoadNode*> nodes;
+    vector<RoadEdge*> edges;
+    unordered_map<RoadNode*, int> nodeIds;
+    unordered_map<RoadEdge*, int> edgeIds;
+    RoadGraphIndex(const RoadGraphIndex& other);
+    RoadGraphIndex& operator=(const RoadGraphIndex& other);
+    void buildImage(const vector<double>& nodeCoordinates, const vector<double>& costs,
+                    const vector<int>& offsets, const vector<int>& sources, const vector<int>& targets);
+    void attachImage(char* image);
+    bool validImage() const;
+    const char* imageData() const;
+    static size_t imageSizeFor(int64_t numNodes, int64_t numEdges);
+};
+
+/*
+ * The accessors below run in the inner loop of every search over the index, so they are
+ * defined here to let the compiler inline them.
+ */
+inline int RoadGraphIndex::nodeCount() const {
+    return numNodes;
+}
+
+inline int RoadGraphIndex::edgeCount() const {
+    return numEdges;
+}
+
+inline int RoadGraphIndex::firstEdge(int node) const {
+    return edgeOffsets[node];
+}
+
+inline int RoadGraphIndex::edgeSource(int edge) const {
+    return edgeSources[edge];
+}
+
+inline int RoadGraphIndex::edgeTarget(int edge) const {
+    return edgeTargets[edge];
+}
+
+inline double RoadGraphIndex::edgeCost(int edge) const {
+    return edgeCosts[edge];
+}
+
+inline int RoadGraphIndex::firstIncoming(int node) const {
+    return incomingOffsets[node];
+}
+
+inline int RoadGraphIndex::incomingEdge(int slot) const {
+    return incomingEdges[slot];
+}
+
+inline double RoadGraphIndex::nodeX(int node) const {
+    return coordinates[2 * node];
+}
+
+inline double RoadGraphIndex::nodeY(int node) const {
+    return coordinates[2 * node + 1];
+}
+
+#endif // _roadgraphindex_h
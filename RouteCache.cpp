@@ -0,0 +1,256 @@
+/*
+ * File: RouteCache.cpp
+ * --------------------
+ * This file implements the RouteCache class, which includes the following methods
+ * - RouteCache constructor
+ * - method to return a route from the cache, computing it with dijkstrasAlgorithm, aStar or
+ * alternativeRoute on a miss.
+ * - methods to invalidate cached routes when edge costs of a graph change.
+ * - getters for the cache size and the hit, miss and invalidation counters.
+ * Recency is kept in a doubly linked list (most recently used route at the front) and an
+ * unordered_map from key to list position, so lookups, insertions and evictions are O(1).
+ * All public methods are safe to call from several threads at once. Routes are computed
+ * outside of the cache lock, so a slow search never blocks hits on other routes. The search
+ * functions color the nodes of the graph they search and print the route to the console, so the
+ * searches of one graph are serialized by a lock of that graph; searches of different graphs run
+ * at the same time.
+ */
+
+#include "RouteCache.h"
+#include <functional>
+
+/* Text for string exceptions */
+const string EXCEPTION_BAD_CAPACITY = "Route cache capacity must be at least 1";
+
+/** Method: RouteCache
+ * Usage: RouteCache cache(capacity)
+ * -----------------------------------------------------
+ * Instantiates an empty route cache holding at most capacity routes.
+ * Throws a string exception if capacity is smaller than 1.
+ * @param capacity - int type, maximum number of routes kept before the least recently used
+ * route is evicted.
+ */
+RouteCache::RouteCache(int capacity) : hits(0), misses(0), invalidations(0) {
+    if (capacity < 1) {
+        throw EXCEPTION_BAD_CAPACITY;
+    }
+    maxEntries = capacity;
+    generation = 0;
+}
+
+/** Method: findRoute
+ * Usage: cache.findRoute(graph, start, end, algorithm)
+ * -----------------------------------------------------
+ * Returns the route between start and end computed with the given algorithm. If the route is
+ * cached it is returned directly and marked as most recently used (hit). Otherwise it is computed
+ * (miss) and stored, evicting the least recently used route if the cache is full.
+ * A route computed while the graph was being invalidated is returned but not stored, so the
+ * cache never holds a route computed against old edge costs. Misses on the same graph wait for
+ * each other, as the searches change the colors of its nodes.
+ * Note: on a hit the search is not run again, so nodes are not recolored in the GUI and the
+ * path info is not printed to the console.
+ * @param: graph type RoadGraph - graph the route is searched in.
+ * @param: start type RoadNode* starting vertex of the route.
+ * @param: end type RoadNode* ending vertex of the route.
+ * @param: algorithm type RouteAlgorithm - search function used to compute the route on a miss.
+ * @return: Path type, route found (empty if start and end are not connected).
+ */
+Path RouteCache::findRoute(const RoadGraph& graph, RoadNode* start, RoadNode* end, RouteAlgorithm algorithm) {
+    RouteKey key = {&graph, start, end, algorithm};
+    long generationAtMiss;
+    mutex* searchLock;
+    {
+        lock_guard<mutex> guard(cacheLock);
+        auto found = positions.find(key);
+        if (found != positions.end()) {
+            // move entry to the front of the recency list
+            entries.splice(entries.begin(), entries, found->second);
+            hits++;
+            return found->second->path;
+        }
+        generationAtMiss = generation;
+        unique_ptr<mutex>& graphLock = searchLocks[&graph];
+        if (!graphLock) {
+            graphLock.reset(new mutex());
+        }
+        searchLock = graphLock.get();
+    }
+    misses++;
+    Path route;
+    {
+        lock_guard<mutex> searchGuard(*searchLock);
+        route = computeRoute(graph, start, end, algorithm);
+    }
+    lock_guard<mutex> guard(cacheLock);
+    if (generation == generationAtMiss && positions.find(key) == positions.end()) {
+        entries.push_front({key, route});
+        positions[key] = entries.begin();
+        if ((int) entries.size() > maxEntries) {
+            removeEntry(prev(entries.end()));
+        }
+    }
+    return route;
+}
+
+/** Method: edgeCostChanged
+ * Usage: cache.edgeCostChanged(graph, edge, oldCost)
+ * -----------------------------------------------------
+ * Invalidates the cached routes of graph that may no longer be correct after the cost of edge
+ * changed from oldCost to its current cost. If the cost went down, any route could now be beaten
+ * by a route through edge, so all routes of graph are dropped. If the cost went up, a shortest
+ * route that does not use edge is still a shortest route, so only the Dijkstra and A* routes
+ * that use edge are dropped. Alternative routes depend on the best route, so they are always
+ * dropped.
+ * @param: graph type RoadGraph - graph edge belongs to.
+ * @param: edge type RoadEdge* - edge whose cost changed (edge->cost() returns the new cost).
+ * @param: oldCost type double - cost of edge before the change.
+ */
+void RouteCache::edgeCostChanged(const RoadGraph& graph, RoadEdge* edge, double oldCost) {
+    if (edge->cost() < oldCost) {
+        invalidate(graph);
+        return;
+    }
+    lock_guard<mutex> guard(cacheLock);
+    generation++;
+    EntryPosition position = entries.begin();
+    while (position != entries.end()) {
+        EntryPosition next = std::next(position);
+        if (position->key.graph == &graph && (position->key.algorithm == ROUTE_ALTERNATIVE ||
+                                              pathUsesEdge(graph, position->path, edge))) {
+            removeEntry(position);
+            invalidations++;
+        }
+        position = next;
+    }
+}
+
+/** Method: invalidate
+ * Usage: cache.invalidate(graph)
+ * -----------------------------------------------------
+ * Drops every cached route of graph. Used when many edge costs of graph change at once.
+ * @param: graph type RoadGraph - graph whose routes are dropped.
+ */
+void RouteCache::invalidate(const RoadGraph& graph) {
+    lock_guard<mutex> guard(cacheLock);
+    generation++;
+    EntryPosition position = entries.begin();
+    while (position != entries.end()) {
+        EntryPosition next = std::next(position);
+        if (position->key.graph == &graph) {
+            removeEntry(position);
+            invalidations++;
+        }
+        position = next;
+    }
+}
+
+/** Method: clear
+ * Usage: cache.clear()
+ * -----------------------------------------------------
+ * Drops every cached route. Hit, miss and invalidation counters are not reset.
+ */
+void RouteCache::clear() {
+    lock_guard<mutex> guard(cacheLock);
+    generation++;
+    entries.clear();
+    positions.clear();
+}
+
+/** Method: size
+ * Usage: cache.size()
+ * -----------------------------------------------------
+ * @return: int type, number of routes currently cached.
+ */
+int RouteCache::size() const {
+    lock_guard<mutex> guard(cacheLock);
+    return entries.size();
+}
+
+/** Method: capacity
+ * Usage: cache.capacity()
+ * -----------------------------------------------------
+ * @return: int type, maximum number of routes cached.
+ */
+int RouteCache::capacity() const {
+    return maxEntries;
+}
+
+/** Method: getHits
+ * Usage: cache.getHits()
+ * -----------------------------------------------------
+ * @return: long type, number of findRoute calls answered from the cache.
+ */
+long RouteCache::getHits() const {
+    return hits;
+}
+
+/** Method: getMisses
+ * Usage: cache.getMisses()
+ * -----------------------------------------------------
+ * @return: long type, number of findRoute calls that had to run a search.
+ */
+long RouteCache::getMisses() const {
+    return misses;
+}
+
+/** Method: getInvalidations
+ * Usage: cache.getInvalidations()
+ * -----------------------------------------------------
+ * @return: long type, number of routes dropped because of edge cost changes.
+ */
+long RouteCache::getInvalidations() const {
+    return invalidations;
+}
+
+/** Method: computeRoute
+ * Usage: computeRoute(graph, start, end, algorithm)
+ * -----------------------------------------------------
+ * Runs the search function matching algorithm. Called without holding the cache lock, holding the
+ * search lock of graph.
+ */
+Path RouteCache::computeRoute(const RoadGraph& graph, RoadNode* start, RoadNode* end, RouteAlgorithm algorithm) {
+    if (algorithm == ROUTE_DIJKSTRA) {
+        return dijkstrasAlgorithm(graph, start, end);
+    } else if (algorithm == ROUTE_A_STAR) {
+        return aStar(graph, start, end);
+    } else {
+        return alternativeRoute(graph, start, end);
+    }
+}
+
+/** Method: removeEntry
+ * Usage: removeEntry(position)
+ * -----------------------------------------------------
+ * Removes the entry at position from the recency list and from the key index.
+ * Assumption: the cache lock is held by the caller.
+ */
+void RouteCache::removeEntry(EntryPosition position) {
+    positions.erase(position->key);
+    entries.erase(position);
+}
+
+/** Method: pathUsesEdge
+ * Usage: pathUsesEdge(graph, path, edge)
+ * -----------------------------------------------------
+ * Returns true if two consecutive nodes of path are joined by edge in graph, false otherwise.
+ */
+bool RouteCache::pathUsesEdge(const RoadGraph& graph, const Path& path, RoadEdge* edge) {
+    for (int i = 0; i < path.size() - 1; i++) {
+        if (graph.edgeBetween(path[i], path[i + 1]) == edge) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* RouteKey comparison and hashing (used by the unordered_map index) */
+bool RouteCache::RouteKey::operator==(const RouteKey& other) const {
+    return graph == other.graph && start == other.start && end == other.end && algorithm == other.algorithm;
+}
+
+size_t RouteCache::RouteKeyHash::operator()(const RouteKey& key) const {
+    size_t result = hash<const void*>()(key.graph);
+    result = result * 31 + hash<const void*>()(key.start);
+    result = result * 31 + hash<const void*>()(key.end);
+    return result * 31 + (size_t) key.algorithm;
+}
@@ -0,0 +1,80 @@
+/*
+ * File: RouteCache.h
+ * ------------------
+ * This file declares the RouteCache class, a bounded, thread-safe, least-recently-used cache
+ * of routes computed by dijkstrasAlgorithm, aStar and alternativeRoute. Routes are keyed by
+ * (graph, start, end, algorithm). Callers that change RoadEdge costs must report the change so
+ * that stale routes are invalidated. The searches run on a miss color the nodes of the graph and
+ * print the route, so the cache runs at most one of them per graph at a time.
+ */
+
+#ifndef _routecache_h
+#define _routecache_h
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "RoadGraph.h"
+#include "Trailblazer.h"
+using namespace std;
+
+/* Algorithms whose results can be cached */
+enum RouteAlgorithm {
+    ROUTE_DIJKSTRA,
+    ROUTE_A_STAR,
+    ROUTE_ALTERNATIVE
+};
+
+/* Number of routes kept when no capacity is given to the constructor */
+const int DEFAULT_ROUTE_CACHE_CAPACITY = 1024;
+
+class RouteCache {
+public:
+    RouteCache(int capacity = DEFAULT_ROUTE_CACHE_CAPACITY);
+    Path findRoute(const RoadGraph& graph, RoadNode* start, RoadNode* end, RouteAlgorithm algorithm);
+    void edgeCostChanged(const RoadGraph& graph, RoadEdge* edge, double oldCost);
+    void invalidate(const RoadGraph& graph);
+    void clear();
+    int size() const;
+    int capacity() const;
+    long getHits() const;
+    long getMisses() const;
+    long getInvalidations() const;
+
+private:
+    /* Identifies one cached route */
+    struct RouteKey {
+        const RoadGraph* graph;
+        RoadNode* start;
+        RoadNode* end;
+        RouteAlgorithm algorithm;
+        bool operator==(const RouteKey& other) const;
+    };
+    struct RouteKeyHash {
+        size_t operator()(const RouteKey& key) const;
+    };
+    /* One cached route, stored in recency order */
+    struct RouteEntry {
+        RouteKey key;
+        Path path;
+    };
+    typedef list<RouteEntry>::iterator EntryPosition;
+
+    // instance variables
+    int maxEntries;
+    list<RouteEntry> entries;
+    unordered_map<RouteKey, EntryPosition, RouteKeyHash> positions;
+    mutable mutex cacheLock;
+    unordered_map<const RoadGraph*, unique_ptr<mutex>> searchLocks;   // one per graph searched, never removed
+    long generation;
+    atomic<long> hits;
+    atomic<long> misses;
+    atomic<long> invalidations;
+    Path computeRoute(const RoadGraph& graph, RoadNode* start, RoadNode* end, RouteAlgorithm algorithm);
+    void removeEntry(EntryPosition position);
+    static bool pathUsesEdge(const RoadGraph& graph, const Path& path, RoadEdge* edge);
+};
+
+#endif // _routecache_h
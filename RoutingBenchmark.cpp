@@ -0,0 +1,459 @@
+/*
+ * File: RoutingBenchmark.cpp
+ * --------------------------
+ * This file implements functions that time the routing algorithms on a loaded RoadGraph and
+ * print the results to the console:
+ * - incremental re-planning (IncrementalPlanner) against a full re-plan after small edge cost
+ * changes.
+ * - building a RoadGraphIndex from a RoadGraph against loading it from a snapshot file.
+ * - Dijkstra's algorithm and A* over indexes whose nodes are numbered in different orders.
+ * - parallel delta-stepping against Dijkstra's algorithm for single-source shortest paths.
+ * - time-dependent routing (rush hour travel time profiles) against static A*, with the memory
+ * used by the profiles.
+ * - queries over a GraphPartition (cells of the start and end nodes plus the overlay) against
+ * Dijkstra's algorithm over the whole graph.
+ * Timings are wall clock times measured with std::chrono::steady_clock.
+ */
+
+#include "RoutingBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include "DeltaStepping.h"
+#include "GraphPartition.h"
+#include "IncrementalPlanner.h"
+#include "PathfindingAlgos.h"
+#include "RoadGraphIndex.h"
+#include "TimeDependentRouting.h"
+#include "random.h"
+
+/* Maximum relative increase applied to an edge cost by one perturbation */
+static const double MAX_COST_INCREASE = 0.5;
+
+/* Probability that a perturbation hits an edge on the current best path */
+static const double PATH_EDGE_PROBABILITY = 0.5;
+
+/* Number of nodes whose search state (one double each) fits in a 64-byte cache line */
+static const int NODES_PER_CACHE_LINE = 8;
+
+/* Breakpoints of the rush hour profiles of the time-dependent benchmark (positions in a day) */
+static const vector<double> RUSH_HOUR_POSITIONS = {0.0, 0.25, 0.33, 0.42, 0.67, 0.75, 0.83, 0.92};
+static const vector<double> ARTERIAL_FACTORS = {1.0, 1.0, 1.9, 1.2, 1.2, 2.1, 1.3, 1.0};
+static const vector<double> RESIDENTIAL_FACTORS = {1.0, 1.0, 1.3, 1.1, 1.1, 1.4, 1.1, 1.0};
+
+/* Function prototypes */
+static double elapsedMillis(chrono::steady_clock::time_point since);
+static void timeOrdering(const string& name, const RoadGraphIndex& index, const Vector<RoadNode*>& from,
+                         const Vector<RoadNode*>& to);
+
+/* Function: benchmarkIncrementalPlanner()
+ * Usage: benchmarkIncrementalPlanner(graph, start, end, perturbations)
+ * -----------------------------------------------------------------------------
+ * Simulates traffic between start and end: the cost of one edge is changed, the route is
+ * re-planned incrementally, and the same query is answered by a planner built from scratch
+ * (which does the same work as A*). This is repeated perturbations times. Half of the changes hit
+ * an edge of the current best route (the worst case for the incremental planner), the other half
+ * hit a random edge. Costs only go up from their original value or back down to it, so the A*
+ * heuristic stays a lower bound. Prints the average time and node expansions of both approaches
+ * and checks that both return routes of the same cost.
+ * @param: graph type RoadGraph - graph searched.
+ * @param: start type RoadNode* starting vertex of the route.
+ * @param: end type RoadNode* ending vertex of the route.
+ * @param: perturbations type int - number of edge cost changes simulated.
+ */
+void benchmarkIncrementalPlanner(const RoadGraph& graph, RoadNode* start, RoadNode* end, int perturbations) {
+    RoadGraphIndex index(graph, {start});
+    int startId = index.idOf(start);
+    int endId = index.idOf(end);
+    if (endId == -1 || index.edgeCount() == 0) {
+        cout << "The start and end points chosen are not connected!" << endl;
+        return;
+    }
+    Vector<double> originalCosts;
+    for (int e = 0; e < index.edgeCount(); e++) {
+        originalCosts.add(index.edgeCost(e));
+    }
+    IncrementalPlanner planner(index, startId, endId);
+    double cost = 0;
+    auto startTime = chrono::steady_clock::now();
+    Vector<int> path = planner.plan(cost);
+    cout << "Initial plan: " << elapsedMillis(startTime) << " ms, " << planner.getExpansions()
+         << " expansions, " << index.nodeCount() << " nodes" << endl;
+
+    double incrementalMillis = 0;
+    double fullMillis = 0;
+    long incrementalExpansions = 0;
+    long fullExpansions = 0;
+    int mismatches = 0;
+    for (int i = 0; i < perturbations; i++) {
+        int edge;
+        if (path.size() > 1 && randomChance(PATH_EDGE_PROBABILITY)) {
+            // pick one edge of the current best route
+            int position = randomInteger(0, path.size() - 2);
+            edge = -1;
+            for (int e = index.firstEdge(path[position]); e < index.firstEdge(path[position] + 1); e++) {
+                if (index.edgeTarget(e) == path[position + 1]) {
+                    edge = e;
+                }
+            }
+        } else {
+            edge = randomInteger(0, index.edgeCount() - 1);
+        }
+        double newCost = originalCosts[edge] * (1 + randomReal(0, MAX_COST_INCREASE));
+        if (randomChance(0.5)) {
+            newCost = originalCosts[edge];
+        }
+
+        startTime = chrono::steady_clock::now();
+        planner.updateEdgeCost(edge, newCost);
+        double incrementalCost = 0;
+        path = planner.plan(incrementalCost);
+        incrementalMillis += elapsedMillis(startTime);
+        incrementalExpansions += planner.getExpansions();
+
+        startTime = chrono::steady_clock::now();
+        IncrementalPlanner fromScratch(index, startId, endId);
+        double fullCost = 0;
+        fromScratch.plan(fullCost);
+        fullMillis += elapsedMillis(startTime);
+        fullExpansions += fromScratch.getExpansions();
+        if (abs(fullCost - incrementalCost) > 1e-9 * max(1.0, fullCost)) {
+            mismatches++;
+        }
+    }
+    if (perturbations > 0) {
+        cout << fixed << setprecision(3);
+        cout << "Incremental re-plan: " << incrementalMillis / perturbations << " ms, "
+             << (double) incrementalExpansions / perturbations << " expansions per change" << endl;
+        cout << "Full re-plan (A*):   " << fullMillis / perturbations << " ms, "
+             << (double) fullExpansions / perturbations << " expansions per change" << endl;
+        cout << "Speedup: " << fullMillis / max(incrementalMillis, 1e-9) << "x, route cost mismatches: "
+             << mismatches << endl;
+    }
+}
+
+/* Function: benchmarkSnapshot()
+ * Usage: benchmarkSnapshot(graph, start, snapshotFile, queries)
+ * -----------------------------------------------------------------------------
+ * Builds the index of every node reachable from start, saves it to snapshotFile and maps it back,
+ * printing the time taken by each step. Then runs the same random A* queries on both indexes and
+ * checks that they return routes of the same cost.
+ * @param: graph type RoadGraph - graph indexed.
+ * @param: start type RoadNode* - seed node of the index.
+ * @param: snapshotFile type string - name of the snapshot file written (overwritten if it exists).
+ * @param: queries type int - number of random queries compared.
+ */
+void benchmarkSnapshot(const RoadGraph& graph, RoadNode* start, const string& snapshotFile, int queries) {
+    auto startTime = chrono::steady_clock::now();
+    RoadGraphIndex built(graph, {start});
+    cout << "Index built from graph: " << elapsedMillis(startTime) << " ms (" << built.nodeCount()
+         << " nodes, " << built.edgeCount() << " edges)" << endl;
+    startTime = chrono::steady_clock::now();
+    built.saveSnapshot(snapshotFile);
+    cout << "Snapshot saved: " << elapsedMillis(startTime) << " ms" << endl;
+    startTime = chrono::steady_clock::now();
+    RoadGraphIndex loaded(snapshotFile);
+    cout << "Snapshot loaded: " << elapsedMillis(startTime) << " ms" << endl;
+
+    int mismatches = 0;
+    double builtMillis = 0;
+    double loadedMillis = 0;
+    for (int i = 0; i < queries; i++) {
+        int from = randomInteger(0, built.nodeCount() - 1);
+        int to = randomInteger(0, built.nodeCount() - 1);
+        double builtCost = -1;
+        double loadedCost = -1;
+        SearchStats stats;
+        startTime = chrono::steady_clock::now();
+        indexedDijkstrasorAstar(built, from, to, true, -1, builtCost, stats);
+        builtMillis += elapsedMillis(startTime);
+        startTime = chrono::steady_clock::now();
+        indexedDijkstrasorAstar(loaded, from, to, true, -1, loadedCost, stats);
+        loadedMillis += elapsedMillis(startTime);
+        if (builtCost != loadedCost) {
+            mismatches++;
+        }
+    }
+    if (queries > 0) {
+        cout << fixed << setprecision(3);
+        cout << "A* on built index: " << builtMillis / queries << " ms per query" << endl;
+        cout << "A* on loaded snapshot: " << loadedMillis / queries << " ms per query" << endl;
+        cout << "Route cost mismatches: " << mismatches << endl;
+    }
+}
+
+/* Function: benchmarkNodeOrdering()
+ * Usage: benchmarkNodeOrdering(graph, start, queries)
+ * -----------------------------------------------------------------------------
+ * Indexes every node reachable from start four times, with nodes numbered in random order (what
+ * following RoadNode* pointers in the heap looks like), breadth first search order (how
+ * RoadGraphIndex numbers nodes), Hilbert curve order and reverse Cuthill-McKee order. For each
+ * order, prints how close the two ends of the edges are in memory and the average time of the
+ * same random Dijkstra and A* queries.
+ * Hardware cache-miss counters are not portable, so locality is reported as the share of edges
+ * whose two ends have their search state in the same 64-byte cache line and as the average id
+ * distance between the two ends of an edge.
+ * @param: graph type RoadGraph - graph indexed.
+ * @param: start type RoadNode* - seed node of the indexes.
+ * @param: queries type int - number of random queries timed for each order.
+ */
+void benchmarkNodeOrdering(const RoadGraph& graph, RoadNode* start, int queries) {
+    RoadGraphIndex breadthFirst(graph, {start});
+    RoadGraphIndex randomOrder(graph, {start});
+    RoadGraphIndex hilbert(graph, {start});
+    RoadGraphIndex cuthillMcKee(graph, {start});
+    vector<int> shuffled(randomOrder.nodeCount());
+    for (int n = 0; n < (int) shuffled.size(); n++) {
+        shuffled[n] = n;
+    }
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(randomInteger(0, 1 << 30)));
+    randomOrder.renumber(shuffled);
+    auto startTime = chrono::steady_clock::now();
+    hilbert.renumber(hilbert.hilbertOrder());
+    cout << "Hilbert renumbering: " << elapsedMillis(startTime) << " ms" << endl;
+    startTime = chrono::steady_clock::now();
+    cuthillMcKee.renumber(cuthillMcKee.reverseCuthillMcKeeOrder());
+    cout << "Reverse Cuthill-McKee renumbering: " << elapsedMillis(startTime) << " ms" << endl;
+
+    // same queries for every order, chosen as nodes of the original graph
+    Vector<RoadNode*> from;
+    Vector<RoadNode*> to;
+    for (int i = 0; i < queries; i++) {
+        from.add(breadthFirst.nodeAt(randomInteger(0, breadthFirst.nodeCount() - 1)));
+        to.add(breadthFirst.nodeAt(randomInteger(0, breadthFirst.nodeCount() - 1)));
+    }
+    timeOrdering("Random order", randomOrder, from, to);
+    timeOrdering("Breadth first order", breadthFirst, from, to);
+    timeOrdering("Hilbert order", hilbert, from, to);
+    timeOrdering("Reverse Cuthill-McKee order", cuthillMcKee, from, to);
+}
+
+/* Function: timeOrdering()
+ * Usage: timeOrdering(name, index, from, to)
+ * -----------------------------------------------------------------------------
+ * Prints the edge locality of index and the average time of Dijkstra and A* queries between the
+ * nodes in from and to (used by benchmarkNodeOrdering).
+ */
+static void timeOrdering(const string& name, const RoadGraphIndex& index, const Vector<RoadNode*>& from,
+                         const Vector<RoadNode*>& to) {
+    long sameLine = 0;
+    double totalSpan = 0;
+    for (int e = 0; e < index.edgeCount(); e++) {
+        int source = index.edgeSource(e);
+        int target = index.edgeTarget(e);
+        if (source / NODES_PER_CACHE_LINE == target / NODES_PER_CACHE_LINE) {
+            sameLine++;
+        }
+        totalSpan += abs(source - target);
+    }
+    double dijkstraMillis = 0;
+    double aStarMillis = 0;
+    for (int i = 0; i < from.size(); i++) {
+        int fromId = index.idOf(from[i]);
+        int toId = index.idOf(to[i]);
+        auto startTime = chrono::steady_clock::now();
+        dijkstrasAlgorithm(index, fromId, toId);
+        dijkstraMillis += elapsedMillis(startTime);
+        startTime = chrono::steady_clock::now();
+        aStar(index, fromId, toId);
+        aStarMillis += elapsedMillis(startTime);
+    }
+    int edges = max(index.edgeCount(), 1);
+    int queries = max(from.size(), 1);
+    cout << fixed << setprecision(3);
+    cout << name << ": " << 100.0 * sameLine / edges << "% edges within one cache line, average id distance "
+         << totalSpan / edges << ", Dijkstra " << dijkstraMillis / queries << " ms, A* "
+         << aStarMillis / queries << " ms per query" << endl;
+}
+
+/* Function: benchmarkDeltaStepping()
+ * Usage: benchmarkDeltaStepping(graph, start, maxThreads, checks)
+ * -----------------------------------------------------------------------------
+ * Computes the shortest paths from start to every node reachable from it, first with Dijkstra's
+ * algorithm run until every node is settled (shortestDistances), then with deltaStepping using
+ * 1, 2, 4 ... maxThreads threads, printing the time and speedup of each run. The costs found by
+ * deltaStepping are checked against point-to-point Dijkstra queries (indexedDijkstrasorAstar) from
+ * start to checks random nodes, and every predecessor is checked to lie on a path of the reported
+ * cost.
+ * @param: graph type RoadGraph - graph indexed.
+ * @param: start type RoadNode* - source of the shortest paths.
+ * @param: maxThreads type int - largest number of threads tried.
+ * @param: checks type int - number of nodes whose cost is compared with Dijkstra's algorithm.
+ */
+void benchmarkDeltaStepping(const RoadGraph& graph, RoadNode* start, int maxThreads, int checks) {
+    RoadGraphIndex index(graph, {start});
+    index.renumber(index.hilbertOrder());
+    int source = index.idOf(start);
+    SearchStats stats;
+    auto startTime = chrono::steady_clock::now();
+    shortestDistances(index, source, stats);
+    double dijkstraMillis = elapsedMillis(startTime);
+    cout << fixed << setprecision(3);
+    cout << "Dijkstra, all " << stats.nodesSettled << " nodes: " << dijkstraMillis << " ms" << endl;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        vector<double> distance;
+        vector<int> parent;
+        startTime = chrono::steady_clock::now();
+        deltaStepping(index, source, 0, threads, distance, parent);
+        double millis = elapsedMillis(startTime);
+        int errors = 0;
+        for (int i = 0; i < checks; i++) {
+            int target = randomInteger(0, index.nodeCount() - 1);
+            double expected = 0;
+            indexedDijkstrasorAstar(index, source, target, false, -1, expected, stats);
+            if (abs(distance[target] - expected) > 1e-9 * max(1.0, expected)) {
+                errors++;
+            }
+        }
+        for (int node = 0; node < index.nodeCount(); node++) {
+            if (parent[node] == -1) {
+                continue;
+            }
+            bool consistent = false;
+            for (int edge = index.firstEdge(parent[node]); edge < index.firstEdge(parent[node] + 1); edge++) {
+                if (index.edgeTarget(edge) == node &&
+                        abs(distance[parent[node]] + index.edgeCost(edge) - distance[node]) <= 1e-9 * max(1.0, distance[node])) {
+                    consistent = true;
+                }
+            }
+            if (!consistent) {
+                errors++;
+            }
+        }
+        cout << "Delta-stepping, " << threads << " threads: " << millis << " ms, speedup "
+             << dijkstraMillis / max(millis, 1e-9) << "x, errors " << errors << endl;
+    }
+}
+
+/* Function: benchmarkTimeDependent()
+ * Usage: benchmarkTimeDependent(graph, start, queries, period)
+ * -----------------------------------------------------------------------------
+ * Gives every edge of graph one of three profiles (flat, residential or arterial rush hours with
+ * morning and evening peaks) and answers queries random queries from start at random departure
+ * times with static A*, time-dependent Dijkstra and time-dependent A*. Prints the average time
+ * and nodes settled of each search, the number of time-dependent A* arrivals that differ from
+ * Dijkstra's, and the memory used by the profiles compared with the static costs and with
+ * storing the breakpoints on every edge. Edges too long for a profile to stay FIFO keep the flat
+ * profile.
+ * @param: graph type RoadGraph - graph searched.
+ * @param: start type RoadNode* - node every query starts from.
+ * @param: queries type int - number of queries.
+ * @param: period type double - length of a day, in the unit of edge costs.
+ */
+void benchmarkTimeDependent(const RoadGraph& graph, RoadNode* start, int queries, double period) {
+    RoadGraphIndex index(graph, {start});
+    TravelTimeProfiles profiles(index, period);
+    int residential = profiles.addProfile(RUSH_HOUR_POSITIONS, RESIDENTIAL_FACTORS);
+    int arterial = profiles.addProfile(RUSH_HOUR_POSITIONS, ARTERIAL_FACTORS);
+    int notFifo = 0;
+    for (int edge = 0; edge < index.edgeCount(); edge++) {
+        try {
+            profiles.setEdgeProfile(edge, randomChance(0.3) ? arterial : residential);
+        } catch (string) {
+            notFifo++;
+        }
+    }
+    int source = index.idOf(start);
+    double staticMillis = 0, dijkstraMillis = 0, astarMillis = 0;
+    long staticSettled = 0, dijkstraSettled = 0, astarSettled = 0;
+    int errors = 0;
+    for (int i = 0; i < queries; i++) {
+        int target = randomInteger(0, index.nodeCount() - 1);
+        double departure = randomReal(0, period);
+        SearchStats stats;
+        aStar(index, source, target, stats);
+        staticMillis += stats.wallTimeMs;
+        staticSettled += stats.nodesSettled;
+        double dijkstraArrival = 0, astarArrival = 0;
+        timeDependentRoute(index, profiles, source, target, departure, false, dijkstraArrival, stats);
+        dijkstraMillis += stats.wallTimeMs;
+        dijkstraSettled += stats.nodesSettled;
+        timeDependentRoute(index, profiles, source, target, departure, true, astarArrival, stats);
+        astarMillis += stats.wallTimeMs;
+        astarSettled += stats.nodesSettled;
+        if (abs(dijkstraArrival - astarArrival) > 1e-9 * max(1.0, dijkstraArrival)) {
+            errors++;
+        }
+    }
+    queries = max(queries, 1);
+    size_t perEdgeBytes = (index.edgeCount() + 1) * sizeof(int) +
+                          (size_t) index.edgeCount() * RUSH_HOUR_POSITIONS.size() * 2 * sizeof(float);
+    cout << fixed << setprecision(3);
+    cout << "Static A*: " << staticMillis / queries << " ms, " << staticSettled / queries << " nodes settled" << endl;
+    cout << "Time-dependent Dijkstra: " << dijkstraMillis / queries << " ms, "
+         << dijkstraSettled / queries << " nodes settled" << endl;
+    cout << "Time-dependent A*: " << astarMillis / queries << " ms, " << astarSettled / queries
+         << " nodes settled, errors " << errors << endl;
+    cout << "Memory: static costs " << index.edgeCount() * sizeof(double) << " bytes, shared profiles "
+         << profiles.memoryBytes() << " bytes, per-edge breakpoints " << perEdgeBytes << " bytes ("
+         << notFifo << " edges kept flat)" << endl;
+}
+
+/* Function: benchmarkPartition()
+ * Usage: benchmarkPartition(graph, start, maxCellSize, queries)
+ * -----------------------------------------------------------------------------
+ * Partitions graph into cells of at most maxCellSize nodes and prints the time taken, the number
+ * of cells, boundary nodes and overlay edges. Then answers queries random queries from start with
+ * GraphPartition::shortestPath and with Dijkstra's algorithm over the whole index, printing the
+ * average time and nodes settled of both and the number of queries whose costs differ.
+ * @param: graph type RoadGraph - graph searched.
+ * @param: start type RoadNode* - node every query starts from.
+ * @param: maxCellSize type int - largest number of nodes in a cell.
+ * @param: queries type int - number of queries.
+ */
+void benchmarkPartition(const RoadGraph& graph, RoadNode* start, int maxCellSize, int queries) {
+    RoadGraphIndex index(graph, {start});
+    auto startTime = chrono::steady_clock::now();
+    GraphPartition partition(index, maxCellSize);
+    double buildMillis = elapsedMillis(startTime);
+    long boundary = 0;
+    for (int cell = 0; cell < partition.cellCount(); cell++) {
+        boundary += partition.boundaryCount(cell);
+    }
+    cout << fixed << setprecision(3);
+    cout << "Partition: " << buildMillis << " ms, " << partition.cellCount() << " cells, " << boundary
+         << " boundary nodes, " << partition.overlayEdgeCount() << " overlay edges" << endl;
+
+    int source = index.idOf(start);
+    double dijkstraMillis = 0, overlayMillis = 0;
+    long dijkstraSettled = 0, overlaySettled = 0;
+    int errors = 0;
+    for (int i = 0; i < queries; i++) {
+        int target = randomInteger(0, index.nodeCount() - 1);
+        SearchStats stats;
+        double expected = 0, cost = 0;
+        startTime = chrono::steady_clock::now();
+        indexedDijkstrasorAstar(index, source, target, false, -1, expected, stats);
+        dijkstraMillis += elapsedMillis(startTime);
+        dijkstraSettled += stats.nodesSettled;
+        Vector<int> path = partition.shortestPath(source, target, cost, stats);
+        overlayMillis += stats.wallTimeMs;
+        overlaySettled += stats.nodesSettled;
+        double pathCost = 0;
+        for (int k = 1; k < path.size(); k++) {
+            double best = numeric_limits<double>::infinity();
+            for (int edge = index.firstEdge(path[k - 1]); edge < index.firstEdge(path[k - 1] + 1); edge++) {
+                if (index.edgeTarget(edge) == path[k]) {
+                    best = min(best, index.edgeCost(edge));
+                }
+            }
+            pathCost += best;
+        }
+        if (abs(cost - expected) > 1e-9 * max(1.0, expected) || abs(pathCost - expected) > 1e-6 * max(1.0, expected)) {
+            errors++;
+        }
+    }
+    queries = max(queries, 1);
+    cout << "Dijkstra: " << dijkstraMillis / queries << " ms, " << dijkstraSettled / queries << " nodes settled" << endl;
+    cout << "Overlay: " << overlayMillis / queries << " ms, " << overlaySettled / queries
+         << " nodes settled, errors " << errors << endl;
+}
+
+/* Returns the number of milliseconds elapsed since the given time point */
+static double elapsedMillis(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
@@ -0,0 +1,21 @@
+/*
+ * File: RoutingBenchmark.h
+ * ------------------------
+ * This file declares functions that time the routing algorithms on a loaded RoadGraph and
+ * print the results to the console.
+ */
+
+#ifndef _routingbenchmark_h
+#define _routingbenchmark_h
+#include <string>
+#include "RoadGraph.h"
+using namespace std;
+
+void benchmarkIncrementalPlanner(const RoadGraph& graph, RoadNode* start, RoadNode* end, int perturbations);
+void benchmarkSnapshot(const RoadGraph& graph, RoadNode* start, const string& snapshotFile, int queries);
+void benchmarkNodeOrdering(const RoadGraph& graph, RoadNode* start, int queries);
+void benchmarkDeltaStepping(const RoadGraph& graph, RoadNode* start, int maxThreads, int checks);
+void benchmarkTimeDependent(const RoadGraph& graph, RoadNode* start, int queries, double period);
+void benchmarkPartition(const RoadGraph& graph, RoadNode* start, int maxCellSize, int queries);
+
+#endif // _routingbenchmark_h
@@ -0,0 +1,155 @@
+/*
+ * File: RoutingStats.cpp
+ * ----------------------
+ * This file implements the search counters and their registry:
+ * - SearchStats and StatsHistogram constructors.
+ * - method to add the counters of one search to the histograms of its algorithm.
+ * - method to export every histogram as text, one line per bucket, in the format
+ *   routing_<counter>_bucket{algorithm="<name>",le="<upper bound>"} <cumulative count>
+ *   followed by the _count, _sum and _max of the counter (Prometheus text format, so the output
+ *   can be scraped or simply read).
+ * - function returning the registry shared by the whole process.
+ * Histograms use power-of-two buckets, so recording a search is a few increments under a lock.
+ */
+
+#include "RoutingStats.h"
+#include <cmath>
+
+/** Method: SearchStats
+ * Usage: SearchStats stats;
+ * -----------------------------------------------------
+ * Instantiates a set of counters, all set to 0.
+ */
+SearchStats::SearchStats() {
+    nodesSettled = 0;
+    edgesRelaxed = 0;
+    heapPushes = 0;
+    heapPops = 0;
+    maxFrontier = 0;
+    duplicatePops = 0;
+    wallTimeMs = 0;
+}
+
+/** Method: StatsHistogram
+ * Usage: StatsHistogram histogram;
+ * -----------------------------------------------------
+ * Instantiates an empty histogram.
+ */
+StatsHistogram::StatsHistogram() {
+    for (int b = 0; b < STATS_HISTOGRAM_BUCKETS; b++) {
+        buckets[b] = 0;
+    }
+    count = 0;
+    sum = 0;
+    maximum = 0;
+}
+
+/** Method: add
+ * Usage: histogram.add(value)
+ * -----------------------------------------------------
+ * Counts value in the bucket (2^(b-1), 2^b] containing it, the bucket exported with upper bound
+ * le="2^b" (bucket 0 holds values up to 1, the last bucket holds every larger value).
+ * @param value - double type, value counted. Assumption: value is not negative.
+ */
+void StatsHistogram::add(double value) {
+    int bucket = 0;
+    if (value > 1) {
+        bucket = min((int) ceil(log2(value)), STATS_HISTOGRAM_BUCKETS - 1);
+    }
+    buckets[bucket]++;
+    count++;
+    sum += value;
+    maximum = max(maximum, value);
+}
+
+/** Method: record
+ * Usage: registry.record(algorithm, stats)
+ * -----------------------------------------------------
+ * Adds the counters of one search to the histograms of algorithm. Safe to call from several
+ * threads at once.
+ * @param algorithm - string type, name of the search algorithm (for example "astar").
+ * @param stats - SearchStats type, counters of the search.
+ */
+void SearchStatsRegistry::record(const string& algorithm, const SearchStats& stats) {
+    lock_guard<mutex> guard(registryLock);
+    AlgorithmHistograms& histograms = byAlgorithm[algorithm];
+    histograms.nodesSettled.add(stats.nodesSettled);
+    histograms.edgesRelaxed.add(stats.edgesRelaxed);
+    histograms.heapPushes.add(stats.heapPushes);
+    histograms.heapPops.add(stats.heapPops);
+    histograms.maxFrontier.add(stats.maxFrontier);
+    histograms.duplicatePops.add(stats.duplicatePops);
+    histograms.wallTimeMicros.add(stats.wallTimeMs * 1000);
+}
+
+/** Method: exportTo
+ * Usage: registry.exportTo(cout)
+ * -----------------------------------------------------
+ * Writes every histogram of every algorithm to out (format described in the file header).
+ * @param out - ostream type, stream the histograms are written to (console, file, socket...).
+ */
+void SearchStatsRegistry::exportTo(ostream& out) const {
+    lock_guard<mutex> guard(registryLock);
+    for (const auto& entry : byAlgorithm) {
+        const AlgorithmHistograms& histograms = entry.second;
+        exportHistogram(out, entry.first, "nodes_settled", histograms.nodesSettled);
+        exportHistogram(out, entry.first, "edges_relaxed", histograms.edgesRelaxed);
+        exportHistogram(out, entry.first, "heap_pushes", histograms.heapPushes);
+        exportHistogram(out, entry.first, "heap_pops", histograms.heapPops);
+        exportHistogram(out, entry.first, "max_frontier", histograms.maxFrontier);
+        exportHistogram(out, entry.first, "duplicate_pops", histograms.duplicatePops);
+        exportHistogram(out, entry.first, "wall_time_us", histograms.wallTimeMicros);
+    }
+}
+
+/** Method: queryCount
+ * Usage: registry.queryCount(algorithm)
+ * -----------------------------------------------------
+ * @return long type, number of searches recorded for algorithm.
+ */
+long SearchStatsRegistry::queryCount(const string& algorithm) const {
+    lock_guard<mutex> guard(registryLock);
+    auto found = byAlgorithm.find(algorithm);
+    return found == byAlgorithm.end() ? 0 : found->second.nodesSettled.count;
+}
+
+/** Method: clear
+ * Usage: registry.clear()
+ * -----------------------------------------------------
+ * Drops every histogram.
+ */
+void SearchStatsRegistry::clear() {
+    lock_guard<mutex> guard(registryLock);
+    byAlgorithm.clear();
+}
+
+/** Method: exportHistogram
+ * Usage: exportHistogram(out, algorithm, counter, histogram)
+ * -----------------------------------------------------
+ * Writes the cumulative buckets, count, sum and maximum of one histogram to out. Every bucket is
+ * written, so all the series of a counter have the same buckets.
+ */
+void SearchStatsRegistry::exportHistogram(ostream& out, const string& algorithm, const string& counter,
+                                          const StatsHistogram& histogram) {
+    string labels = "{algorithm=\"" + algorithm + "\"";
+    long cumulative = 0;
+    for (int b = 0; b < STATS_HISTOGRAM_BUCKETS - 1; b++) {
+        cumulative += histogram.buckets[b];
+        out << "routing_" << counter << "_bucket" << labels << ",le=\"" << (1L << b) << "\"} "
+            << cumulative << endl;
+    }
+    out << "routing_" << counter << "_bucket" << labels << ",le=\"+Inf\"} " << histogram.count << endl;
+    out << "routing_" << counter << "_count" << labels << "} " << histogram.count << endl;
+    out << "routing_" << counter << "_sum" << labels << "} " << histogram.sum << endl;
+    out << "routing_" << counter << "_max" << labels << "} " << histogram.maximum << endl;
+}
+
+/* Function: searchStatsRegistry()
+ * Usage: searchStatsRegistry().exportTo(cout)
+ * -----------------------------------------------------------------------------
+ * Returns the registry the path finding functions record their counters in.
+ */
+SearchStatsRegistry& searchStatsRegistry() {
+    static SearchStatsRegistry registry;
+    return registry;
+}
@@ -0,0 +1,71 @@
+/*
+ * File: RoutingStats.h
+ * --------------------
+ * This file declares the SearchStats struct, the counters collected by one path search
+ * (nodes settled, edges relaxed, queue pushes and pops, largest frontier, duplicate pops and
+ * wall time), and the SearchStatsRegistry class, which aggregates the counters of every search
+ * of the process into histograms that can be exported as text.
+ */
+
+#ifndef _routingstats_h
+#define _routingstats_h
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+using namespace std;
+
+/* Counters of one search */
+struct SearchStats {
+    long nodesSettled;    // nodes whose cost became final (expanded)
+    long edgesRelaxed;    // edges that gave a neighbor a new tentative cost
+    long heapPushes;      // entries added to the priority queue
+    long heapPops;        // entries removed from the priority queue
+    long maxFrontier;     // largest size of the priority queue
+    long duplicatePops;   // entries popped for nodes that were already settled
+    double wallTimeMs;    // time spent in the search, in milliseconds
+    SearchStats();
+};
+
+/* Number of buckets of a StatsHistogram: bucket b counts values in (2^(b-1), 2^b] */
+const int STATS_HISTOGRAM_BUCKETS = 40;
+
+/* Histogram with power-of-two buckets of one counter */
+struct StatsHistogram {
+    long buckets[STATS_HISTOGRAM_BUCKETS];
+    long count;
+    double sum;
+    double maximum;
+    StatsHistogram();
+    void add(double value);
+};
+
+class SearchStatsRegistry {
+public:
+    void record(const string& algorithm, const SearchStats& stats);
+    void exportTo(ostream& out) const;
+    long queryCount(const string& algorithm) const;
+    void clear();
+
+private:
+    /* Histograms of every counter for one algorithm */
+    struct AlgorithmHistograms {
+        StatsHistogram nodesSettled;
+        StatsHistogram edgesRelaxed;
+        StatsHistogram heapPushes;
+        StatsHistogram heapPops;
+        StatsHistogram maxFrontier;
+        StatsHistogram duplicatePops;
+        StatsHistogram wallTimeMicros;
+    };
+
+    // instance variables
+    map<string, AlgorithmHistograms> byAlgorithm;
+    mutable mutex registryLock;
+    static void exportHistogram(ostream& out, const string& algorithm, const string& counter,
+                                const StatsHistogram& histogram);
+};
+
+SearchStatsRegistry& searchStatsRegistry();
+
+#endif // _routingstats_h
@@ -0,0 +1,304 @@
+/*
+ * File: TimeDependentRouting.cpp
+ * ------------------------------
+ * This file implements the TravelTimeProfiles class, which includes the following methods
+ * - TravelTimeProfiles constructor, which gives every edge the flat profile.
+ * - method to add a profile from its breakpoints and to assign a profile to an edge.
+ * - method returning the travel time of an edge for a departure time.
+ * - methods returning the smallest factor of all profiles (to scale the A* heuristic) and the
+ * memory used by the profiles.
+ * and timeDependentRoute, a Dijkstra / A* search over departure times.
+ * Profiles are stored as one array of breakpoints (float position, float factor) for all the
+ * profiles and one 16-bit profile number per edge: with a few dozen road categories the profiles
+ * of a whole graph take about 2 bytes per edge, instead of a few hundred bytes per edge when each
+ * edge stores its own breakpoints.
+ * Travel times must be FIFO (first in, first out): leaving later never arrives earlier. With this
+ * property Dijkstra's algorithm over arrival times returns the earliest arrival, so
+ * setEdgeProfile refuses a profile that would make an edge overtake itself.
+ */
+
+#include "TimeDependentRouting.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+/* Text for string exceptions */
+const string EXCEPTION_BAD_PERIOD = "Profile period must be positive";
+const string EXCEPTION_BAD_PROFILE = "Profile breakpoints must be in increasing order in [0, 1) with positive factors";
+const string EXCEPTION_TOO_MANY_PROFILES = "Too many travel time profiles";
+const string EXCEPTION_UNKNOWN_PROFILE = "Travel time profile does not exist";
+const string EXCEPTION_PROFILE_NOT_FIFO = "Profile lets a later departure on this edge arrive earlier";
+
+/* Largest number of profiles (profile numbers are stored on 16 bits) */
+static const int MAX_PROFILES = 1 << 16;
+
+/* Function prototypes */
+static double elapsedMillis(chrono::steady_clock::time_point since);
+
+/** Method: TravelTimeProfiles
+ * Usage: TravelTimeProfiles profiles(index, period)
+ * -----------------------------------------------------
+ * Instantiates profiles for the edges of index, all with the flat profile (static costs).
+ * Throws a string exception if period is not positive.
+ * @param: index type RoadGraphIndex - graph whose edges get profiles. Costs changed later with
+ * setEdgeCost are used by travelTime.
+ * @param: period type double - length of the period of the profiles (for example one day), in
+ * the same unit as edge costs.
+ */
+TravelTimeProfiles::TravelTimeProfiles(const RoadGraphIndex& index, double period) : index(index) {
+    if (period <= 0) {
+        throw EXCEPTION_BAD_PERIOD;
+    }
+    periodLength = period;
+    smallestFactor = 1;
+    profileOffsets.push_back(0);
+    breakPositions.push_back(0);
+    breakFactors.push_back(1);
+    profileOffsets.push_back(1);
+    steepestDecrease.push_back(0);
+    edgeProfiles.assign(index.edgeCount(), FLAT_PROFILE);
+}
+
+/** Method: addProfile
+ * Usage: int rushHour = profiles.addProfile(positions, factors)
+ * -----------------------------------------------------
+ * Adds a profile whose factor is factors[i] at position positions[i] of the period and varies
+ * linearly between breakpoints. The last breakpoint is joined to the first one of the next period.
+ * Throws a string exception if positions are not increasing in [0, 1), if a factor is not
+ * positive or if there are too many profiles.
+ * @param: positions type vector<double> - position of every breakpoint in the period.
+ * @param: factors type vector<double> - factor of every breakpoint.
+ * @return: int type, number of the new profile.
+ */
+int TravelTimeProfiles::addProfile(const vector<double>& positions, const vector<double>& factors) {
+    if (positions.empty() || positions.size() != factors.size()) {
+        throw EXCEPTION_BAD_PROFILE;
+    }
+    for (size_t i = 0; i < positions.size(); i++) {
+        if (positions[i] < 0 || positions[i] >= 1 || factors[i] <= 0 || (i > 0 && positions[i] <= positions[i - 1])) {
+            throw EXCEPTION_BAD_PROFILE;
+        }
+    }
+    if (profileCount() == MAX_PROFILES) {
+        throw EXCEPTION_TOO_MANY_PROFILES;
+    }
+    double decrease = 0;
+    for (size_t i = 0; i < positions.size(); i++) {
+        breakPositions.push_back(positions[i]);
+        breakFactors.push_back(factors[i]);
+        smallestFactor = min(smallestFactor, factors[i]);
+        size_t next = (i + 1) % positions.size();
+        double width = positions[next] - positions[i] + (next <= i ? 1 : 0);
+        decrease = max(decrease, (factors[i] - factors[next]) / width);
+    }
+    profileOffsets.push_back(breakPositions.size());
+    steepestDecrease.push_back(decrease);
+    return profileCount() - 1;
+}
+
+/** Method: setEdgeProfile
+ * Usage: profiles.setEdgeProfile(edge, profile)
+ * -----------------------------------------------------
+ * Makes the travel time of edge follow profile. Throws a string exception if profile does not
+ * exist, or if with the current cost of edge the travel time would decrease faster than time
+ * passes (a later departure would arrive earlier).
+ * @param: edge type int - id of the edge.
+ * @param: profile type int - number of the profile (FLAT_PROFILE for the static cost).
+ */
+void TravelTimeProfiles::setEdgeProfile(int edge, int profile) {
+    if (profile < 0 || profile >= profileCount()) {
+        throw EXCEPTION_UNKNOWN_PROFILE;
+    }
+    if (index.edgeCost(edge) * steepestDecrease[profile] > periodLength) {
+        throw EXCEPTION_PROFILE_NOT_FIFO;
+    }
+    edgeProfiles[edge] = profile;
+}
+
+/** Method: edgeProfile
+ * Usage: int profile = profiles.edgeProfile(edge)
+ * -----------------------------------------------------
+ * @return int type, number of the profile of edge.
+ */
+int TravelTimeProfiles::edgeProfile(int edge) const {
+    return edgeProfiles[edge];
+}
+
+/** Method: profileCount
+ * Usage: int count = profiles.profileCount()
+ * -----------------------------------------------------
+ * @return int type, number of profiles, including the flat profile.
+ */
+int TravelTimeProfiles::profileCount() const {
+    return profileOffsets.size() - 1;
+}
+
+/** Method: period
+ * Usage: double day = profiles.period()
+ * -----------------------------------------------------
+ * @return double type, length of the period of the profiles.
+ */
+double TravelTimeProfiles::period() const {
+    return periodLength;
+}
+
+/** Method: travelTime
+ * Usage: double time = profiles.travelTime(edge, departure)
+ * -----------------------------------------------------
+ * Returns the time needed to go through edge when entering it at time departure: its cost in the
+ * index multiplied by the factor of its profile at that time of the period.
+ * @param: edge type int - id of the edge.
+ * @param: departure type double - time at which the edge is entered (any value, taken modulo
+ * the period).
+ * @return double type, travel time of the edge.
+ */
+double TravelTimeProfiles::travelTime(int edge, double departure) const {
+    int profile = edgeProfiles[edge];
+    if (profile == FLAT_PROFILE) {
+        return index.edgeCost(edge);
+    }
+    double position = fmod(departure / periodLength, 1.0);
+    if (position < 0) {
+        position += 1;
+    }
+    return index.edgeCost(edge) * profileFactor(profile, position);
+}
+
+/** Method: minFactor
+ * Usage: double factor = profiles.minFactor()
+ * -----------------------------------------------------
+ * @return double type, smallest factor of every profile (at most 1). Travel times are never below
+ * the static cost times this factor, so a heuristic on static costs scaled by it stays admissible.
+ */
+double TravelTimeProfiles::minFactor() const {
+    return smallestFactor;
+}
+
+/** Method: memoryBytes
+ * Usage: size_t bytes = profiles.memoryBytes()
+ * -----------------------------------------------------
+ * @return size_t type, number of bytes used by the profiles and the profile numbers of the edges.
+ */
+size_t TravelTimeProfiles::memoryBytes() const {
+    return profileOffsets.size() * sizeof(int) + breakPositions.size() * sizeof(float) +
+           breakFactors.size() * sizeof(float) + steepestDecrease.size() * sizeof(double) +
+           edgeProfiles.size() * sizeof(uint16_t);
+}
+
+/** Method: profileFactor
+ * Usage: double factor = profileFactor(profile, position)
+ * -----------------------------------------------------
+ * Returns the factor of profile at position (in [0, 1)), interpolated between the breakpoints
+ * around position, which are found by binary search.
+ */
+double TravelTimeProfiles::profileFactor(int profile, double position) const {
+    int first = profileOffsets[profile];
+    int last = profileOffsets[profile + 1] - 1;
+    int after = upper_bound(breakPositions.begin() + first, breakPositions.begin() + last + 1, position) -
+                breakPositions.begin();
+    double leftPosition, rightPosition;
+    int left, right;
+    if (after == first) {
+        // before the first breakpoint: between the last breakpoint of the previous period and the first
+        left = last;
+        right = first;
+        leftPosition = breakPositions[last] - 1;
+        rightPosition = breakPositions[first];
+    } else if (after > last) {
+        // after the last breakpoint: between the last breakpoint and the first of the next period
+        left = last;
+        right = first;
+        leftPosition = breakPositions[last];
+        rightPosition = breakPositions[first] + 1;
+    } else {
+        left = after - 1;
+        right = after;
+        leftPosition = breakPositions[left];
+        rightPosition = breakPositions[right];
+    }
+    if (rightPosition <= leftPosition) {
+        return breakFactors[left];
+    }
+    double weight = (position - leftPosition) / (rightPosition - leftPosition);
+    return breakFactors[left] + weight * (breakFactors[right] - breakFactors[left]);
+}
+
+/* Function: timeDependentRoute()
+ * Usage: timeDependentRoute(index, profiles, start, end, departure, withheuristic, arrival, stats)
+ * -----------------------------------------------------------------------------
+ * Searches index for the route from start to end that arrives first when leaving start at time
+ * departure. Same search as indexedDijkstrasorAstar, except that nodes are labeled with their
+ * earliest arrival time instead of a path cost, and the travel time of each edge is evaluated
+ * for the time at which it is entered. Because travel times are FIFO, waiting at a node never
+ * helps and the first arrival at a node is the one to expand. If withheuristic is true A* is used,
+ * with the heuristic of the index scaled by profiles.minFactor(), otherwise Dijkstra's algorithm.
+ * The counters of the search are recorded in searchStatsRegistry() under "td-dijkstra" or
+ * "td-astar".
+ * @param: index type RoadGraphIndex - graph where we'll be searching the route.
+ * @param: profiles type TravelTimeProfiles - travel time profiles of the edges of index.
+ * @param: start type int, id of the starting vertex.
+ * @param: end type int, id of the ending vertex.
+ * @param: departure type double - time at which the route leaves start.
+ * @param: withheuristic type bool. If true A* is used, if false Dijkstra's algorithm.
+ * @param: arrival type double - set to the arrival time at end (if a route exists).
+ * @param: stats type SearchStats - set to the counters of the search.
+ * @return: Vector<int> type, ids of the nodes along the route found, empty if no route was found.
+ */
+Vector<int> timeDependentRoute(const RoadGraphIndex& index, const TravelTimeProfiles& profiles, int start, int end,
+                               double departure, bool withheuristic, double &arrival, SearchStats &stats) {
+    stats = SearchStats();
+    auto startTime = chrono::steady_clock::now();
+    Vector<int> pathFound;
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queueofNodes;
+    vector<double> bestArrival(index.nodeCount(), numeric_limits<double>::infinity());
+    vector<int> previous(index.nodeCount(), -1);
+    vector<bool> visitedPoints(index.nodeCount(), false);
+    double heuristicFactor = withheuristic ? profiles.minFactor() : 0;
+    bestArrival[start] = departure;
+    queueofNodes.push(QueueEntry(departure + heuristicFactor * index.heuristic(start, end), start));
+    stats.heapPushes++;
+    stats.maxFrontier = 1;
+    while (!queueofNodes.empty()) {
+        int lastnode = queueofNodes.top().second;
+        queueofNodes.pop();
+        stats.heapPops++;
+        if (visitedPoints[lastnode]) {
+            stats.duplicatePops++;
+            continue;
+        }
+        visitedPoints[lastnode] = true;
+        stats.nodesSettled++;
+        if (lastnode == end) {
+            arrival = bestArrival[end];
+            for (int node = end; node != -1; node = previous[node]) {
+                pathFound.add(node);
+            }
+            reverse(pathFound.begin(), pathFound.end());
+            break;
+        }
+        for (int edge = index.firstEdge(lastnode); edge < index.firstEdge(lastnode + 1); edge++) {
+            int node = index.edgeTarget(edge);
+            double newArrival = bestArrival[lastnode] + profiles.travelTime(edge, bestArrival[lastnode]);
+            if (!visitedPoints[node] && newArrival < bestArrival[node]) {
+                bestArrival[node] = newArrival;
+                previous[node] = lastnode;
+                queueofNodes.push(QueueEntry(newArrival + heuristicFactor * index.heuristic(node, end), node));
+                stats.edgesRelaxed++;
+                stats.heapPushes++;
+            }
+        }
+        stats.maxFrontier = max(stats.maxFrontier, (long) queueofNodes.size());
+    }
+    stats.wallTimeMs = elapsedMillis(startTime);
+    searchStatsRegistry().record(withheuristic ? "td-astar" : "td-dijkstra", stats);
+    return pathFound;
+}
+
+/* Returns the number of milliseconds elapsed since the given time point */
+static double elapsedMillis(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
@@ -0,0 +1,53 @@
+/*
+ * File: TimeDependentRouting.h
+ * ----------------------------
+ * This file declares the TravelTimeProfiles class, which gives the edges of a RoadGraphIndex a
+ * travel time that depends on the time of departure (rush hours), and timeDependentRoute, a
+ * Dijkstra / A* search that returns the route with the earliest arrival for a departure time.
+ * A profile is a piecewise-linear, periodic factor applied to the static cost of an edge: at
+ * position p of the period (0 <= p < 1) an edge costs edgeCost(edge) * factor(p). Profiles are
+ * shared by many edges (for example one per road category), so each edge only stores the number
+ * of its profile.
+ */
+
+#ifndef _timedependentrouting_h
+#define _timedependentrouting_h
+#include <cstdint>
+#include <vector>
+#include "RoadGraphIndex.h"
+#include "RoutingStats.h"
+#include "vector.h"
+using namespace std;
+
+/* Number of the flat profile (factor 1 at all times), used by edges that were not given one */
+const int FLAT_PROFILE = 0;
+
+class TravelTimeProfiles {
+public:
+    TravelTimeProfiles(const RoadGraphIndex& index, double period);
+    int addProfile(const vector<double>& positions, const vector<double>& factors);
+    void setEdgeProfile(int edge, int profile);
+    int edgeProfile(int edge) const;
+    int profileCount() const;
+    double period() const;
+    double travelTime(int edge, double departure) const;
+    double minFactor() const;
+    size_t memoryBytes() const;
+
+private:
+    // instance variables
+    const RoadGraphIndex& index;
+    double periodLength;
+    double smallestFactor;
+    vector<int> profileOffsets;       // breakpoints of profile p are [profileOffsets[p], profileOffsets[p + 1])
+    vector<float> breakPositions;     // position of every breakpoint in the period, in [0, 1)
+    vector<float> breakFactors;       // factor at every breakpoint
+    vector<double> steepestDecrease;  // largest decrease of the factor of every profile per period
+    vector<uint16_t> edgeProfiles;
+    double profileFactor(int profile, double position) const;
+};
+
+Vector<int> timeDependentRoute(const RoadGraphIndex& index, const TravelTimeProfiles& profiles, int start, int end,
+                               double departure, bool withheuristic, double &arrival, SearchStats &stats);
+
+#endif // _timedependentrouting_h
@@ -18,6 +18,8 @@
  * This file includes the following extension feature:
  * - allow word ladder end points (begining and end of the ladder) to be outside of the dictionary.
  * - messages displayed in the console during using iteraction are adjusted accordingly.
+ * - the dictionary can be a compact dictionary file (.dawg, written by MakeDawg) which is
+ * memory-mapped instead of parsed; neighbors are found by walking it one letter at a time.
  * --------------------------------------
  */
  
@@ -28,6 +30,7 @@
 #include <string>
 #include <vector>
 #include "console.h"
+#include "CompactLexicon.h"
 #include "lexicon.h"
 #include "queue.h"
 #include "filelib.h"
@@ -45,10 +48,10 @@ struct userInput {
  
 /*Function prototypes */
 void displayWelcomeMessage();
-void playGame(const Lexicon &dictWords, Vector<string> &allNeighborsecondWord);
-userInput getUserWords(const Lexicon &dictWords, Vector<string> &allNeighborsecondWord);
+void playGame(const CompactLexicon &dictWords, Vector<string> &allNeighborsecondWord);
+userInput getUserWords(const CompactLexicon &dictWords, Vector<string> &allNeighborsecondWord);
 void resetUserWords(userInput &userWords);
-void findNeighbors(Vector<string> &allNeighbors, string word, const Lexicon &dictWords);
+void findNeighbors(Vector<string> &allNeighbors, string word, const CompactLexicon &dictWords);
 bool containsWord(Vector<string> allNeighborsecondWord, string word);
  
  
@@ -61,6 +64,7 @@ const string WELCOME_THREE = "first into the second by changing one letter at a
 const string WELCOME_FOUR = "The words connecting your words will be in the dictionary.";
 const string WELCOME_FIVE = "Your words can be outside of the dictionary but need to be of same length.";
 const string PROMPT_FILE_NAME = "Dictionary file name?"; // Displayed to prompt user for dictionary file.
+const string COMPACT_DICT_EXTENSION = ".dawg"; // Dictionary files with this ending are loaded as compact dictionaries.
 /* Message displayed when game exits. */
 const string CLOSING_MESSAGE = "Have a nice day.";
 /* Message displayed when words of different length entered */
@@ -78,8 +82,13 @@ int main() {
     string dictFile = promptUserForFile(PROMPT_FILE_NAME);
     cout << endl;
     Vector<string> allNeighborsecondWord;
-    Lexicon dictWords(dictFile);
-    playGame(dictWords, allNeighborsecondWord);
+    if (endsWith(dictFile, COMPACT_DICT_EXTENSION)) {
+        CompactLexicon dictWords(dictFile);
+        playGame(dictWords, allNeighborsecondWord);
+    } else {
+        CompactLexicon dictWords((Lexicon(dictFile)));
+        playGame(dictWords, allNeighborsecondWord);
+    }
     cout << CLOSING_MESSAGE << endl;
     return 0;
 }
@@ -107,14 +116,14 @@ void displayWelcomeMessage() {
  * as wordOne and wordTwo parameters. These will be used for the end and beginning of the word ladder
  * respectively (if ladder exists).
  * Displays a console error message & re-prompts user for two new words if the words provided
- * are not different words of same length in dictWords(Lexicon type) passed as parameter to this
+ * are not different words of same length in dictWords(CompactLexicon type) passed as parameter to this
  * function. If the user enters "Enter" for either of the words, the function returns.
- * This function takes one parameter: dictWords, of Lexicon type, containing the list of valid words.
+ * This function takes one parameter: dictWords, of CompactLexicon type, containing the list of valid words.
  * This function returns userWords (type userInput) which contains the words provided by user
  * for the ladder as wordOne and wordTwo parameters (or an empty string if user pressed enter).
- * This function is not case sensitive to user input. Assumption: words in dictWords are in lowercase.
+ * This function is not case sensitive to user input. dictWords lookups ignore case.
  */
-userInput getUserWords(const Lexicon &dictWords, Vector<string> &allNeighborsecondWord) {
+userInput getUserWords(const CompactLexicon &dictWords, Vector<string> &allNeighborsecondWord) {
     userInput userWords;
     resetUserWords(userWords);
     while (userWords.wordOne.length() == 0 && userWords.wordTwo.length() == 0) {
@@ -179,9 +188,9 @@ bool containsWord(Vector<string> allNeighborsecondWord, string word) {
  * console (second word provided by user to first word provided by user).
  * If no word ladder has been found, a message stating that is displayed in the console.
  * This function takes a parameter dictWords, list of valid words.
- * Assumption: all words in dictWords are in lowercase.
+ * dictWords lookups ignore case; ladders are printed in lowercase.
  */
-void playGame(const Lexicon &dictWords, Vector<string> &allNeighborsecondWord) {
+void playGame(const CompactLexicon &dictWords, Vector<string> &allNeighborsecondWord) {
     bool foundLadder;
     while(true){
         foundLadder = false;
@@ -252,29 +261,33 @@ void playGame(const Lexicon &dictWords, Vector<string> &allNeighborsecondWord) {
  * Finds all the words in dictWords lexicon(passed by reference) that are neighbors of the string
  * passed as parameter to the function and stores them in allNeighbors(passed as parameter).
  * A word's neighbor is of same length and differs from it by a single letter.
- * To do so it creates a new neighbor candidate by replacing each single letter of the string word
- * passed as parameter by each of the letters in the alphabet (one letter change at a time)
- * and checks if the neighbor candidate is in dictWords. If it is, it is added to allNeighbors.
+ * To do so, for each position of word it walks dictWords along the letters before that position,
+ * then tries each letter that can follow them in a dictionary word (in alphabetical order) and
+ * walks the rest of word from there: a neighbor candidate is only built if it is in dictWords, and
+ * letters that cannot start a dictionary word at that position are never tried.
  * This method takes 3 parameters:
- * - dictWords: Lexicon used to make sure the neighbor is in the dictionary used in this program.
+ * - dictWords: CompactLexicon used to make sure the neighbor is in the dictionary used in this program.
  * - allNeighbors: Vector of strings holding all valid neighbors of the string passed as parameter
  * to this method.
  * - word: string; word for which we're trying to find neighbors in this function.
- * Assumption: all the words in dictWords and word are lowercase.
+ * Assumption: word is lowercase; neighbors are added in lowercase.
  */
-void findNeighbors(Vector<string> &allNeighbors, string word, const Lexicon &dictWords) {
-    string candidateWord;
-    for (int i = 0; i < (int) word.length(); i++) {
-        for (char c = 'a'; c <= 'z'; c++) {
-            candidateWord = word.substr(0, i) + c + word.substr(i + 1);
-            if (dictWords.contains(candidateWord)) {
-                allNeighbors.add(candidateWord);
+void findNeighbors(Vector<string> &allNeighbors, string word, const CompactLexicon &dictWords) {
+    int prefixNode = dictWords.root();
+    for (int i = 0; i < (int) word.length() && prefixNode != -1; i++) {
+        uint32_t letters = dictWords.childMask(prefixNode);
+        for (int letterIndex = 0; letterIndex < 26; letterIndex++) {
+            if (!(letters & (1u << letterIndex))) {
+                continue;
+            }
+            int node = dictWords.child(prefixNode, 'A' + letterIndex);
+            for (int j = i + 1; j < (int) word.length() && node != -1; j++) {
+                node = dictWords.child(node, toupper(word[j]));
+            }
+            if (node != -1 && dictWords.isWord(node)) {
+                allNeighbors.add(word.substr(0, i) + (char) ('a' + letterIndex) + word.substr(i + 1));
             }
         }
+        prefixNode = dictWords.child(prefixNode, toupper(word[i]));
     }
 }
- 
- 
- 
- 
- 
\ No newline at end of file
@@ -27,19 +27,18 @@
  * --------------------------------------
  */
  
-#include <cctype>
-#include <cmath>
-#include <fstream>
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <sys/stat.h>
 #include "console.h"
 #include "simpio.h"
-#include "vector.h"
-#include "map.h"
-#include "hashmap.h"
 #include "filelib.h"
-#include "random.h"
 #include "strlib.h"
+#include "NgramGenerator.h"
+#include "NgramModel.h"
  
 using namespace std;
  
@@ -54,14 +53,10 @@ struct userInput {
 /* Function prototypes */
 void displayWelcomeMessage();
 void generateNgrams();
-void importSeedText(Vector<string> &allWords, const userInput &userAnswer, Vector<int> &indexBegSentence);
+unique_ptr<NgramModel> loadModel(const userInput &userAnswer);
 userInput getUserInput();
-void wrapSeedText (Vector<string> &allWords, const userInput &userAnswer);
 void getCountWordsToPrint(userInput &userAnswer);
-void buildMap(HashMap<Vector<string>, Vector<string>> &map, const Vector<string> &allWords,
-              const userInput &userAnswer, const int origSize);
-string buildStringToPrint(const userInput &userAnswer, const Vector<string> &allWords,
-                          const int origSize, HashMap<Vector<string>, Vector<string>> &map, const Vector<int> &indexBegSentence);
+string buildStringToPrint(const userInput &userAnswer, const NgramModel &model);
  
 /* Text to display on console */
 const string WELCOME_ONE = "Welcome to CS 106B Random Writer ('N-Grams')."; // Welcome message line 1
@@ -81,6 +76,8 @@ const string COUNT_WORDS_GENERATE = "# of random words to generate (0 to quit)?"
 /* Value which, when entered by user when prompted for count of words to display, causes the game to exit. */
 const int QUIT_VALUE = 0;
 const int MIN_NGRAM_LENGTH = 2; // Miminum N-Gram length.
+const int BUILD_THREADS = 0; // Threads building the N-gram model (0 for one per hardware thread).
+const string MODEL_FILE_EXTENSION = ".ngrams"; // End of the name of the model file saved next to the seed text.
  
 /* Main program */
 int main() {
@@ -115,20 +112,13 @@ void displayWelcomeMessage(){
 void generateNgrams() {
     userInput userAnswer = getUserInput();
     cout << endl;
-    // vector to store all words in file
-    Vector<string> allWords;
-    Vector<int> indexBegSentence;
-    importSeedText(allWords, userAnswer, indexBegSentence);
-    int origSize = allWords.size();
-    wrapSeedText(allWords, userAnswer);
-    HashMap<Vector<string>, Vector<string>> map;
-    buildMap(map, allWords, userAnswer, origSize);
+    unique_ptr<NgramModel> model = loadModel(userAnswer);
     while (true) {
         getCountWordsToPrint(userAnswer);
         if (userAnswer.countWordsDisplayed == 0) {
             return;
         }
-        string toPrint = buildStringToPrint(userAnswer, allWords, origSize, map, indexBegSentence);
+        string toPrint = buildStringToPrint(userAnswer, *model);
         cout << toPrint << endl << endl;
         userAnswer.countWordsDisplayed = -1;
     }
@@ -163,88 +153,37 @@ userInput getUserInput() {
 }
  
 /*
- * Function: importSeedText
- * Usage: importSeedText(allWords, userAnswer);
+ * Function: loadModel
+ * Usage: loadModel(userAnswer);
  * -------------------------------------
- * Opens the file of name provided by userAnswer.filename's parameter and stores each word read
- * in it in the allWords object.  The text in this file will be used as seed to generate random text
- * in the program.
- * Takes two parameters:
- * - userAnswer (userInput type): contains the filename to open and use to populate allWords.
- * - allWords (Vector<string> type): stores all the words from userAnswer file in it.
- * Assumption: filename stored in userInput exists.
+ * Returns the N-gram model of the seed text. The model is saved in a model file named after the
+ * seed text file and N (for example "hamlet.txt.3.ngrams"): if that file exists and is newer than the
+ * seed text, it is memory-mapped, which takes the same few milliseconds whatever the size of the
+ * text; otherwise (or if it cannot be loaded) the model is built from the seed text and saved to
+ * it for the next runs. If the model file cannot be written, its error message is printed and the
+ * model is only used for this run.
+ * Takes as parameter userAnswer (userInput type), which contains the filename of the seed text and
+ * the value N. Assumption: filename stored in userInput exists.
  */
-void importSeedText(Vector<string> &allWords, const userInput &userAnswer, Vector<int> &indexBegSentence) {
-    string word;
-    ifstream filestream;
-    openFile(filestream, userAnswer.fileName);
-    int index = 0;
-    while (filestream >> word) {
-        allWords.add(word);
-        char temp = word[0];
-        if (isalpha(temp) && temp == toupper(word[0])) {
-            indexBegSentence.add(index);
+unique_ptr<NgramModel> loadModel(const userInput &userAnswer) {
+    string modelFile = userAnswer.fileName + "." + integerToString(userAnswer.valueN) + MODEL_FILE_EXTENSION;
+    struct stat textInfo;
+    struct stat modelInfo;
+    if (stat(userAnswer.fileName.c_str(), &textInfo) == 0 && stat(modelFile.c_str(), &modelInfo) == 0
+            && modelInfo.st_mtime > textInfo.st_mtime) {
+        try {
+            return unique_ptr<NgramModel>(new NgramModel(modelFile));
+        } catch (const string &problem) {
+            // the model file is built again below
         }
-        index++;
     }
-}
- 
-/*
- * Function: wrapSeedText
- * Usage: wrapSeedText(allWords, userAnswer);
- * -------------------------------------
- * Modifies allWords to address text wrapping in this program. Appends the first N - 1
- * words of allWords to the end of allWords. N is the number for the length of groups
- * of words which was entered by the user in the console. Takes 2 parameters:
- * - allWords (type Vector<string>): contains all the words read from the seed text file.
- * At the end of this method its length will have increased by userAnswer.valueN - 1.
- * - userAnswer (type userInput): its userAnswer.valueN parameter contains the number of groups of words
- * entered by the user in the console. Remains unchanged.
- */
-void wrapSeedText (Vector<string> &allWords, const userInput &userAnswer) {
-    string temp;
-    for (int i = 0; i < userAnswer.valueN - 1; i++) {
-        temp = allWords[i];
-        allWords.add(temp);
-    }
-}
- 
-/*
- * Function: buildMap
- * Usage: buildMap(map, allWords, userAnswer, origSize);
- * --------------------------------------------------------------
- * Builds a map of N-grams, ie of all the possible word windows(type Vector<string>) of size N -1 (N provided by
- * user input) in the seed text stored in allWords to the list (type Vector<string>)
- * of all the next word that immediately follow each occurrence of that window in the seed text (with
- * wrapping). The list of words is of type Vector<string> and can contain duplicate words.
- * What we mean by wrapping is that any word in the seed text file can be at the beginning of the
- * window selected, and thus, if when selecting the beginning window, we are at the end of the text
- * file, we take any additional words needed to build our map from the beginning of the seed text file.
- * This method takes 4 parameters:
- * - map ((type HashMap<Vector<string>, Vector<string>>): stores the map defined above.
- * - allWords (type Vector<string>): where we search for all the possible word windows
- * of size N-1. Remains unchanged.
- * - userAnswer (type userInput): its valueN parameter stores the size (+1) of the word windows
- *  that are map keys. Remains unchanged.
- * - origSize (type int): count of words in seed text file. This constants allow us to traverse
- * allWords to the correct index to find word windows and matching words for our map.
- * Remains unchanged.
- */
-void buildMap(HashMap<Vector<string>, Vector<string>> &map, const Vector<string> &allWords,
-              const userInput &userAnswer, const int origSize) {
-    for (int i  = 0; i < origSize; i++) {
-        Vector<string> sub = allWords.subList(i, userAnswer.valueN - 1);
-        if (map.containsKey(sub)) {
-            Vector<string> temp = map.get(sub);
-            string toAdd = allWords[i + userAnswer.valueN - 1];
-            temp.add(toAdd);
-            map.put(sub, temp);
-        } else {
-            Vector<string> tempTwo;
-            tempTwo.add(allWords[i + userAnswer.valueN - 1]);
-            map.put(sub, tempTwo);
-        }
+    unique_ptr<NgramModel> model(new NgramModel(userAnswer.fileName, userAnswer.valueN, BUILD_THREADS));
+    try {
+        model->saveModel(modelFile);
+    } catch (const string &problem) {
+        cout << problem << endl;
     }
+    return model;
 }
  
 /*
@@ -273,65 +212,50 @@ void getCountWordsToPrint(userInput &userAnswer) {
  
 /*
  * Function: buildStringToPrint
- * Usage: buildStringToPrint(userAnswer, allWords, origSize, map);
+ * Usage: buildStringToPrint(userAnswer, model);
  * -----------------------------------------------------------------------
  * Builds and returns the random text to print in the console (return type string).
- * Random text is build by randomly selecting one window of text size N - 1 in the map of N-Grams
- * then grabbing one of the words at random in the list of the words that immediately follow
- * each occurrence of that window in the seed text from the map, adding the window and that random
- * word to the text to print and creating a new window by removing the first word of the current
- * window and adding to it the random word that was just selected. This process repeats until the
- * number of words to print has been selected. Random text starts and ends with "...". Words
- * are separated by spaces in it.
- * Takes 4 parameters:
+ * Random text is build by randomly selecting one window of text size N - 1 starting a sentence
+ * in the seed text, then grabbing one of the words that follow that window in the seed text at
+ * random from the N-gram model (each as often as it follows the window), adding it to the text to
+ * print and creating a new window by removing the first word of the current window and adding to
+ * it the random word that was just selected. This process repeats until the number of words to
+ * print has been selected, then until a word ends a sentence. Words are separated by spaces in it.
+ * The window is kept by a NgramGenerator (a ring buffer of word ids with a rolling hash) and the
+ * text is written to a string stream, so each word takes the same time however long the text is.
+ * The starting window is a context starting a sentence, drawn as often as it appears in the text
+ * (the first context of the model if no word of the text starts with an uppercase letter).
+ * Takes 2 parameters:
  * - userAnswer (type userInput): its valueN number is a measure of the size of the window
  * we'll be randomly selected (size = valueN-1). Remains unchanged.
- * - allWords(type Vector<string>): contains all the words in the seed text file with wrapping
- * modification. Is used to pick a random starting window of N - 1 words. Remains unchanged.
- * - origSize (type int): count of words in the seed text file. Is used to pick a random index
- * in allWords, which is the starting point of our starting window of N-1 words.
- * Remains unchanged.
- * - map (type  HashMap<Vector<string>, Vector<string>>): map of N-grams. Is used to populate
- * the string returned by this function after populating it with the original window of words.
- * Remains unchanged.
+ * - model (type NgramModel): N-gram model of the seed text. Is used to pick the starting window
+ * and the words that follow it. Remains unchanged.
  * Returns the string of random text to print in the console.
  */
-string buildStringToPrint(const userInput &userAnswer, const Vector<string> &allWords,
-                          const int origSize, HashMap<Vector<string>, Vector<string>> &map, const Vector<int> &indexBegSentence) {
+string buildStringToPrint(const userInput &userAnswer, const NgramModel &model) {
     int counter = 0;
-    string toPrint = "";
-    int randomInt = randomInteger(0, indexBegSentence.size() - 1);
-    Vector<string> window = allWords.subList(indexBegSentence[randomInt], userAnswer.valueN - 1);
-    for (string word : window) {
-        toPrint = toPrint + word + " ";
+    ostringstream toPrint;
+    int start = max(model.randomSentenceStart(), 0);
+    const int* window = model.contextWords(start);
+    for (int i = 0; i < userAnswer.valueN - 1; i++) {
+        toPrint << (i == 0 ? "" : " ") << model.word(window[i]);
         counter++;
     }
-    //cout << toPrint.size() << endl;
-    toPrint = trimEnd(toPrint);
-    //cout << toPrint.size() << " aftertrimming" << endl;
-    Vector<string> selectwords;
+    NgramGenerator generator(model, start);
     string newWord = "a";
     while (counter < userAnswer.countWordsDisplayed) {
-        selectwords = map.get(window);
-        int randomPosition = randomInteger(0, selectwords.size() - 1);
-        newWord = selectwords[randomPosition];
-        toPrint = toPrint + " " + newWord ;
+        newWord = model.word(generator.nextWord());
+        toPrint << " " << newWord;
         counter++;
-        window = window.subList(1, window.size() - 1);
-        window.add(newWord);
     }
     while(newWord[newWord.length()-1]!='!' && newWord[newWord.length()-1]!='?'&& newWord[newWord.length()-1]!='.') {
-        selectwords = map.get(window);
-        int randomPosition = randomInteger(0, selectwords.size() - 1);
-        newWord = selectwords[randomPosition];
-        toPrint = toPrint + " " + newWord ;
+        newWord = model.word(generator.nextWord());
+        toPrint << " " << newWord;
         counter++;
-        window = window.subList(1, window.size() - 1);
-        window.add(newWord);
     }
     cout << "We printed " << counter << " words instead of " << userAnswer.countWordsDisplayed <<
             " to end the text with a full sentence." << endl;
-    return toPrint;
+    return toPrint.str();
 }
  
  